@@ -4,6 +4,7 @@
 
 #include <stdlib.h> // TODO: Why?
 #include <stdbool.h> // bool
+#include <sys/uio.h> // iovec
 #include <netinet/in.h> // IPPROTO_UDP, IPPROTO_TCP, ...
 #include <openssl/evp.h> // EVP_PKEY
 
@@ -216,6 +217,27 @@ enum rawrtc_data_channel_message_flag {
     RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_BINARY = 1 << 3,
 };
 
+/*
+ * Data channel priorities (as used by DCEP).
+ * Other values in between are allowed as well.
+ */
+enum rawrtc_data_channel_priority {
+    RAWRTC_DATA_CHANNEL_PRIORITY_BELOW_NORMAL = 128,
+    RAWRTC_DATA_CHANNEL_PRIORITY_NORMAL = 256,
+    RAWRTC_DATA_CHANNEL_PRIORITY_HIGH = 512,
+    RAWRTC_DATA_CHANNEL_PRIORITY_EXTRA_HIGH = 1024,
+};
+
+/*
+ * SCTP stream scheduler.
+ */
+enum rawrtc_sctp_transport_scheduler {
+    RAWRTC_SCTP_TRANSPORT_SCHEDULER_ROUND_ROBIN,
+    RAWRTC_SCTP_TRANSPORT_SCHEDULER_FIRST_COME,
+    RAWRTC_SCTP_TRANSPORT_SCHEDULER_PRIORITY,
+    RAWRTC_SCTP_TRANSPORT_SCHEDULER_FAIR_BANDWIDTH,
+};
+
 /*
  * SCTP transport state.
  */
@@ -339,6 +361,14 @@ enum rawrtc_ice_server_transport {
     RAWRTC_ICE_SERVER_TRANSPORT_TLS
 };
 
+/*
+ * Message buffer drop policy (applied once a limit has been reached).
+ */
+enum rawrtc_message_buffer_policy {
+    RAWRTC_MESSAGE_BUFFER_POLICY_DROP_NEWEST,
+    RAWRTC_MESSAGE_BUFFER_POLICY_DROP_OLDEST
+};
+
 /*
  * Length of various arrays.
  * TODO: private
@@ -357,6 +387,7 @@ enum {
 struct rawrtc_ice_server_url_context;
 struct rawrtc_ice_candidate;
 struct rawrtc_data_channel;
+struct rawrtc_data_channel_chained_message;
 struct rawrtc_dtls_transport;
 struct rawrtc_dtls_parameters;
 struct rawrtc_data_channel_parameters;
@@ -367,6 +398,13 @@ struct rawrtc_peer_connection_ice_candidate;
 
 
 
+/*
+ * Command handler (called on the event loop thread).
+ */
+typedef void (rawrtc_command_handler)(
+    void* const arg
+);
+
 /*
  * ICE gatherer state change handler.
  */
@@ -482,6 +520,24 @@ typedef void (rawrtc_data_channel_message_handler)(
     void* const arg
 );
 
+/*
+ * Data channel chained message handler.
+ *
+ * Receives a message as a read-only list of segments without merging
+ * them into a contiguous buffer. The segments are valid until the
+ * handler returns unless `message` is being referenced (`mem_ref`),
+ * in which case they stay valid until it has been un-referenced.
+ *
+ * Note: `message` may be NULL in case partial delivery has been
+ *       requested and a message has been aborted (this can only happen
+ *       on partially reliable channels).
+ */
+typedef void (rawrtc_data_channel_chained_message_handler)(
+    struct rawrtc_data_channel_chained_message* const message, // nullable, read-only
+    enum rawrtc_data_channel_message_flag const flags,
+    void* const arg
+);
+
 /*
  * Data channel handler.
  *
@@ -550,6 +606,16 @@ typedef void (rawrtc_dtls_transport_receive_handler)(
     void* const arg
 );
 
+/*
+ * Handle path MTU changes (bytes available for a data transport
+ * packet).
+ * TODO: private -> dtls_transport.h
+ */
+typedef void (rawrtc_dtls_transport_path_mtu_handler)(
+    size_t const path_mtu,
+    void* const arg
+);
+
 /*
  * Create the data channel (transport handler).
  * TODO: private -> data_transport.h
@@ -578,6 +644,28 @@ typedef enum rawrtc_code (rawrtc_data_transport_channel_send_handler)(
     bool const is_binary
 );
 
+/*
+ * Send data consisting of multiple segments via the data channel
+ * (transport handler).
+ * TODO: private -> data_transport.h
+ */
+typedef enum rawrtc_code (rawrtc_data_transport_channel_sendv_handler)(
+    struct rawrtc_data_channel* const channel,
+    struct iovec const * const segments, // nullable (if size 0), copied
+    size_t const n_segments,
+    bool const is_binary
+);
+
+/*
+ * Get the amount of buffered outgoing bytes of the data channel
+ * (transport handler).
+ * TODO: private -> data_transport.h
+ */
+typedef enum rawrtc_code (rawrtc_data_transport_channel_get_buffered_amount_handler)(
+    uint64_t* const amountp, // de-referenced
+    struct rawrtc_data_channel* const channel
+);
+
 
 
 /*
@@ -598,13 +686,86 @@ struct rawrtc_config {
 };
 
 /*
- * Message buffer.
+ * Buffered message.
  * TODO: private
  */
 struct rawrtc_buffered_message {
     struct le le;
     struct mbuf* buffer; // referenced
     void* context; // referenced, nullable
+    size_t size;
+    uint64_t timestamp;
+};
+
+/*
+ * Message buffer limits.
+ * `0` means unlimited for all limits. `max_age` is in milliseconds.
+ */
+struct rawrtc_message_buffer_limits {
+    size_t max_size;
+    uint32_t max_messages;
+    uint32_t max_age;
+    enum rawrtc_message_buffer_policy policy;
+};
+
+/*
+ * Message buffer statistics.
+ */
+struct rawrtc_message_buffer_stats {
+    size_t size;
+    uint_fast32_t n_messages;
+    uint_fast64_t n_dropped;
+    uint_fast64_t n_expired;
+};
+
+/*
+ * Message buffer.
+ * Note: Size and amount of messages are tracked on append/removal.
+ * TODO: private
+ */
+struct rawrtc_message_buffer {
+    struct list messages;
+    size_t size;
+    uint_fast32_t n_messages;
+    struct rawrtc_message_buffer_limits limits;
+    struct tmr expire_timer;
+    uint_fast64_t n_dropped;
+    uint_fast64_t n_expired;
+};
+
+/*
+ * Buffer pool size class.
+ * TODO: private
+ */
+struct rawrtc_buffer_pool_class {
+    size_t size;
+    size_t n_buffers;
+    struct mbuf** buffers; // referenced
+};
+
+/*
+ * Buffer pool statistics.
+ */
+struct rawrtc_buffer_pool_stats {
+    uint_fast64_t n_hits;
+    uint_fast64_t n_misses;
+    uint_fast64_t n_returned;
+    uint_fast64_t n_discarded;
+    size_t n_pooled;
+    size_t n_pooled_high_water_mark;
+    size_t size_pooled;
+    size_t size_pooled_high_water_mark;
+};
+
+/*
+ * Buffer pool.
+ * TODO: private
+ */
+struct rawrtc_buffer_pool {
+    size_t n_classes;
+    size_t class_capacity;
+    struct rawrtc_buffer_pool_class* classes;
+    struct rawrtc_buffer_pool_stats stats;
 };
 
 /*
@@ -718,6 +879,16 @@ struct rawrtc_ice_parameters {
     bool ice_lite;
 };
 
+/*
+ * Packet received by the ICE gatherer before a DTLS transport has been
+ * attached.
+ * TODO: private
+ */
+struct rawrtc_ice_gatherer_early_packet {
+    struct sa source; // copied
+    struct mbuf* buffer; // referenced
+};
+
 /*
  * ICE gatherer.
  * TODO: private
@@ -729,7 +900,11 @@ struct rawrtc_ice_gatherer {
     rawrtc_ice_gatherer_error_handler* error_handler; // nullable
     rawrtc_ice_gatherer_local_candidate_handler* local_candidate_handler; // nullable
     void* arg; // nullable
-    struct list buffered_messages; // TODO: Can this be added to the candidates list?
+    struct rawrtc_ice_gatherer_early_packet* early_packets; // nullable (ring)
+    uint32_t early_packets_capacity;
+    uint32_t early_packets_head;
+    uint32_t early_packets_count;
+    uint64_t n_early_packets_dropped;
     struct list local_candidates; // TODO: Hash list instead?
     char ice_username_fragment[ICE_USERNAME_FRAGMENT_LENGTH + 1];
     char ice_password[ICE_PASSWORD_LENGTH + 1];
@@ -785,14 +960,30 @@ struct rawrtc_dtls_transport {
     struct rawrtc_dtls_parameters* remote_parameters; // referenced
     enum rawrtc_dtls_role role;
     bool connection_established;
-    struct list buffered_messages_in;
-    struct list buffered_messages_out;
+    struct rawrtc_message_buffer buffered_messages_in;
+    struct rawrtc_message_buffer buffered_messages_out;
     struct list fingerprints;
     struct tls* context;
     struct dtls_sock* socket;
     struct tls_conn* connection;
     rawrtc_dtls_transport_receive_handler* receive_handler;
     void* receive_handler_arg;
+    struct ice_candpair* path_candidate_pair; // referenced, nullable (cached)
+    struct udp_sock* path_udp_socket; // referenced, nullable (cached)
+    struct sa path_remote_address; // cached
+    uint64_t n_path_invalidations;
+    rawrtc_dtls_transport_path_mtu_handler* path_mtu_handler; // nullable
+    size_t path_mtu;
+    size_t path_mtu_search_high;
+    size_t path_mtu_probe_size;
+    struct tmr path_mtu_timer;
+    struct stun* path_mtu_stun;
+    struct stun_ctrans* path_mtu_transaction; // nullable
+    struct udp_helper* path_mtu_udp_helper; // nullable
+    uint64_t path_mtu_tiebreaker;
+    int path_mtu_socket_option; // previous "don't fragment" setting
+    bool path_mtu_dont_fragment;
+    struct rawrtc_udp_batch* udp_batch; // nullable
 };
 
 #ifdef SCTP_REDIRECT_TRANSPORT
@@ -805,8 +996,13 @@ struct rawrtc_sctp_redirect_transport {
     uint16_t local_port;
     uint16_t remote_port;
     struct sa redirect_address;
-    struct mbuf* buffer;
+    struct mbuf** receive_buffers; // referenced
+    struct mbuf** send_buffers; // referenced
+    size_t n_send_buffers;
+    struct tmr send_timer;
     int socket;
+    bool send_blocked;
+    bool recompute_checksum;
 };
 #endif
 
@@ -820,6 +1016,8 @@ struct rawrtc_data_transport {
     rawrtc_data_transport_channel_create_handler* channel_create;
     rawrtc_data_transport_channel_close_handler* channel_close;
     rawrtc_data_transport_channel_send_handler* channel_send;
+    rawrtc_data_transport_channel_sendv_handler* channel_sendv; // nullable
+    rawrtc_data_transport_channel_get_buffered_amount_handler* channel_get_buffered_amount;
 };
 
 /*
@@ -833,6 +1031,7 @@ struct rawrtc_data_channel_parameters {
     char* protocol; // copied
     bool negotiated;
     uint16_t id;
+    uint16_t priority;
 };
 
 /*
@@ -841,6 +1040,7 @@ struct rawrtc_data_channel_parameters {
  */
 struct rawrtc_data_channel_options {
     bool deliver_partially;
+    uint64_t max_message_size; // inbound, 0 = use the transport's limit
 };
 
 /*
@@ -851,6 +1051,17 @@ struct rawrtc_sctp_capabilities {
     uint64_t max_message_size;
 };
 
+/*
+ * Chain of received SCTP message chunks.
+ * TODO: private
+ */
+struct rawrtc_sctp_chunk_chain {
+    struct mbuf** chunks; // referenced
+    size_t n_chunks;
+    size_t capacity;
+    size_t size;
+};
+
 /*
  * SCTP transport.
  * TODO: private
@@ -863,14 +1074,29 @@ struct rawrtc_sctp_transport {
     rawrtc_data_channel_handler* data_channel_handler; // nullable
     rawrtc_sctp_transport_state_change_handler* state_change_handler; // nullable
     void* arg; // nullable
-    struct list buffered_messages_outgoing;
+    struct rawrtc_message_buffer buffered_messages_outgoing;
+    struct rawrtc_message_buffer buffered_messages_pending_streams; // waiting for their stream
+    struct mbuf* buffer_receive; // recycled
     struct mbuf* buffer_dcep_inbound;
+    struct rawrtc_sctp_chunk_chain chain_dcep_inbound;
     struct sctp_rcvinfo info_dcep_inbound;
-    struct rawrtc_data_channel** channels;
+    struct rawrtc_data_channel** channels; // grown on demand
     uint_fast16_t n_channels;
     uint_fast16_t current_channel_sid;
+    uint16_t max_streams;
+    uint16_t n_inbound_streams;
+    uint16_t n_outbound_streams;
+    uint16_t n_outbound_streams_wanted;
+    struct list buffered_amount_high_channels; // channels above their threshold
     FILE* trace_handle;
     struct socket* socket;
+    struct tmr event_timer;
+    uint_fast32_t event_budget;
+    uint64_t n_event_budget_exhausted;
+    uint64_t max_inbound_message_size;
+    uint64_t n_inbound_messages_too_large;
+    enum rawrtc_sctp_transport_scheduler scheduler;
+    struct le le; // in the list of transports that own a usrsctp socket
     uint_fast8_t flags;
 };
 
@@ -882,7 +1108,12 @@ struct rawrtc_sctp_data_channel_context {
     uint16_t sid;
     uint_fast8_t flags;
     struct mbuf* buffer_inbound;
+    struct rawrtc_sctp_chunk_chain chain_inbound;
     struct sctp_rcvinfo info_inbound;
+    size_t buffered_amount;
+    size_t usrsctp_buffered_amount;
+    struct le buffered_amount_le;
+    size_t outbound_offset;
 };
 
 /*
@@ -901,7 +1132,20 @@ struct rawrtc_data_channel {
     rawrtc_data_channel_error_handler* error_handler; // nullable
     rawrtc_data_channel_close_handler* close_handler; // nullable
     rawrtc_data_channel_message_handler* message_handler; // nullable
+    rawrtc_data_channel_chained_message_handler* chained_message_handler; // nullable
     void* arg; // nullable
+    uint64_t buffered_amount_low_threshold;
+};
+
+/*
+ * Chained data channel message.
+ * Segments and buffers are allocated along with the message.
+ */
+struct rawrtc_data_channel_chained_message {
+    struct iovec* segments; // read-only
+    size_t n_segments;
+    size_t size; // total length of all segments
+    struct mbuf** buffers; // referenced, TODO: private
 };
 
 /*
@@ -994,7 +1238,8 @@ enum {
     RAWRTC_LAYER_DTLS_SRTP_STUN = 10, // TODO: Pretty sure we are able to detect STUN earlier
     RAWRTC_LAYER_ICE = 0,
     RAWRTC_LAYER_STUN = -10,
-    RAWRTC_LAYER_TURN = -10
+    RAWRTC_LAYER_TURN = -10,
+    RAWRTC_LAYER_BATCHED_IO = -20
 };
 
 
@@ -1049,6 +1294,11 @@ struct rawrtc_dtls_fingerprints {
 /*
  * Initialise rawrtc. Must be called before making a call to any other
  * function.
+ *
+ * The calling thread becomes rawrtc's event loop thread. All transports
+ * are driven by that thread's re main loop. rawrtc does not lock its
+ * API, so all other functions MUST be called on the event loop thread.
+ * Other threads need to post their calls by using `rawrtc_call_async`.
  */
 enum rawrtc_code rawrtc_init();
 
@@ -1057,6 +1307,85 @@ enum rawrtc_code rawrtc_init();
  */
 enum rawrtc_code rawrtc_close();
 
+/*
+ * Call a handler on the event loop thread.
+ *
+ * This function may be called from any thread and never blocks on the
+ * event loop. Posted handlers are called in the order they have been
+ * posted (per thread) and in batches after a single wakeup of the event
+ * loop thread.
+ */
+enum rawrtc_code rawrtc_call_async(
+    rawrtc_command_handler* const handler,
+    void* const arg // nullable
+);
+
+/*
+ * Create a buffer pool.
+ *
+ * Buffers are grouped into power-of-two size classes ranging from
+ * `min_size` to `max_size` (both will be rounded up to a power of
+ * two). Each size class will keep up to `class_capacity` unused
+ * buffers that can be handed out again without allocating memory.
+ *
+ * Note: A buffer pool is not thread-safe and must only be used from
+ *       the event loop thread.
+ */
+enum rawrtc_code rawrtc_buffer_pool_create(
+    struct rawrtc_buffer_pool** const poolp, // de-referenced
+    size_t const min_size,
+    size_t const max_size,
+    size_t const class_capacity
+);
+
+/*
+ * Get a buffer with at least `size` bytes of capacity from a buffer
+ * pool. Position and end of the buffer will be set to `0`.
+ *
+ * `pool` may be `NULL` in which case a buffer will simply be
+ * allocated.
+ */
+enum rawrtc_code rawrtc_buffer_pool_get(
+    struct mbuf** const bufferp, // de-referenced
+    struct rawrtc_buffer_pool* const pool, // nullable
+    size_t const size
+);
+
+/*
+ * Return a buffer to a buffer pool. This will un-reference the buffer.
+ *
+ * The buffer will only be recycled in case the caller holds the last
+ * reference to it (and its memory is not shared with another buffer),
+ * its size matches one of the pool's size classes and the size class
+ * has not reached its capacity. Otherwise, the buffer will simply be
+ * un-referenced.
+ *
+ * Only buffers that have been taken from the pool should be returned.
+ *
+ * `pool` and `buffer` may be `NULL`.
+ */
+void rawrtc_buffer_pool_put(
+    struct rawrtc_buffer_pool* const pool, // nullable
+    struct mbuf* const buffer // nullable, de-referenced
+);
+
+/*
+ * Get the statistics of a buffer pool.
+ */
+enum rawrtc_code rawrtc_buffer_pool_get_stats(
+    struct rawrtc_buffer_pool_stats* const statsp, // de-referenced
+    struct rawrtc_buffer_pool* const pool
+);
+
+/*
+ * Get the library-wide buffer pool that is used for transport
+ * buffers.
+ * `*poolp` must be unreferenced.
+ */
+enum rawrtc_code rawrtc_get_buffer_pool(
+    struct rawrtc_buffer_pool** const poolp // de-referenced
+);
+
 /*
  * Create certificate options.
  *
@@ -1329,6 +1658,28 @@ enum rawrtc_code rawrtc_ice_gatherer_get_local_candidates(
     struct rawrtc_ice_gatherer* const gatherer
 );
 
+/*
+ * Set the maximum amount of packets the ICE gatherer buffers until a
+ * DTLS transport has been attached. Further packets will be dropped.
+ * `0` disables buffering.
+ *
+ * Return `RAWRTC_CODE_INVALID_STATE` in case packets are currently
+ * being buffered.
+ */
+enum rawrtc_code rawrtc_ice_gatherer_set_early_packets_capacity(
+    struct rawrtc_ice_gatherer* const gatherer,
+    uint32_t const capacity
+);
+
+/*
+ * Get the amount of packets the ICE gatherer dropped because its early
+ * packet buffer was full.
+ */
+enum rawrtc_code rawrtc_ice_gatherer_get_early_packets_dropped(
+    uint64_t* const countp, // de-referenced
+    struct rawrtc_ice_gatherer* const gatherer
+);
+
 /*
  * TODO (from RTCIceGatherer interface)
  * rawrtc_ice_gatherer_create_associated_gatherer (unsupported)
@@ -1547,6 +1898,48 @@ enum rawrtc_code rawrtc_dtls_transport_get_local_parameters(
     struct rawrtc_dtls_transport* const transport
 );
 
+/*
+ * Get the path MTU (maximum UDP payload size) of the DTLS transport
+ * that has been confirmed by path MTU discovery.
+ *
+ * Discovery starts with a conservative size once the transport is
+ * connected and probes larger sizes on the selected candidate pair.
+ * It restarts whenever the selected candidate pair changes.
+ */
+enum rawrtc_code rawrtc_dtls_transport_get_path_mtu(
+    size_t* const path_mtup, // de-referenced
+    struct rawrtc_dtls_transport* const transport
+);
+
+/*
+ * Set the limits of the buffers the DTLS transport uses for incoming
+ * and outgoing messages until it is connected and a data transport has
+ * been attached.
+ */
+enum rawrtc_code rawrtc_dtls_transport_set_buffer_limits(
+    struct rawrtc_dtls_transport* const transport,
+    struct rawrtc_message_buffer_limits const* const limits // copied
+);
+
+/*
+ * Get the statistics of the DTLS transport's incoming and outgoing
+ * message buffers.
+ */
+enum rawrtc_code rawrtc_dtls_transport_get_buffer_stats(
+    struct rawrtc_message_buffer_stats* const inboundp, // de-referenced, nullable
+    struct rawrtc_message_buffer_stats* const outboundp, // de-referenced, nullable
+    struct rawrtc_dtls_transport* const transport
+);
+
+/*
+ * Get the amount of times the cached path (selected candidate pair)
+ * of the DTLS transport has been invalidated.
+ */
+enum rawrtc_code rawrtc_dtls_transport_get_path_invalidations(
+    uint64_t* const countp, // de-referenced
+    struct rawrtc_dtls_transport* const transport
+);
+
 /*
  * TODO (from RTCIceTransport interface)
  * rawrtc_dtls_transport_get_remote_parameters
@@ -1590,6 +1983,20 @@ enum rawrtc_code rawrtc_sctp_redirect_transport_get_port(
     uint16_t* const portp, // de-referenced
     struct rawrtc_sctp_redirect_transport* const transport
 );
+
+/*
+ * Set whether the SCTP redirect transport recalculates the checksum of
+ * each redirected packet instead of updating it incrementally
+ * (default).
+ *
+ * Recalculation is necessary in case the raw socket delivers packets
+ * without a valid checksum, for example when the kernel offloads SCTP
+ * checksums on the loopback interface.
+ */
+enum rawrtc_code rawrtc_sctp_redirect_transport_set_checksum_recompute(
+    struct rawrtc_sctp_redirect_transport* const transport,
+    bool const recompute
+);
 #endif
 
 /*
@@ -1651,6 +2058,141 @@ enum rawrtc_code rawrtc_sctp_transport_stop(
     struct rawrtc_sctp_transport* const transport
 );
 
+/*
+ * Cork the SCTP transport.
+ *
+ * While corked, outgoing messages will be queued instead of being
+ * handed out to the SCTP stack. Call `rawrtc_sctp_transport_uncork` to
+ * send all queued messages at once which allows the SCTP stack to
+ * bundle them into full-sized packets.
+ */
+enum rawrtc_code rawrtc_sctp_transport_cork(
+    struct rawrtc_sctp_transport* const transport
+);
+
+/*
+ * Uncork the SCTP transport and send all queued messages.
+ */
+enum rawrtc_code rawrtc_sctp_transport_uncork(
+    struct rawrtc_sctp_transport* const transport
+);
+
+/*
+ * Set the event budget of the SCTP transport.
+ *
+ * The budget limits the amount of usrsctp event rounds (each handling
+ * read, write and error events) processed in one go. Remaining events
+ * will be handled in a deferred callback of the event loop, so a busy
+ * association cannot starve other transports. `0` disables the limit.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_event_budget(
+    struct rawrtc_sctp_transport* const transport,
+    uint32_t const budget
+);
+
+/*
+ * Get the amount of times the event budget of the SCTP transport has
+ * been exhausted.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_event_budget_exhausted(
+    uint64_t* const countp, // de-referenced
+    struct rawrtc_sctp_transport* const transport
+);
+
+/*
+ * Set the limits of the SCTP transport's outgoing message buffer.
+ * The same limits apply to messages that wait for their outgoing
+ * stream to be added.
+ *
+ * Sending a message that exceeds the limits will fail with
+ * `RAWRTC_CODE_INSUFFICIENT_SPACE` before any part of it has been
+ * sent. The remainder of a partially sent message is always buffered.
+ * Only the drop newest policy is supported and `max_age` must be `0`
+ * as buffered messages may already have been sent partially or belong
+ * to reliable channels.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_buffer_limits(
+    struct rawrtc_sctp_transport* const transport,
+    struct rawrtc_message_buffer_limits const* const limits // copied
+);
+
+/*
+ * Get the statistics of the SCTP transport's outgoing message buffer.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_buffer_stats(
+    struct rawrtc_message_buffer_stats* const statsp, // de-referenced
+    struct rawrtc_sctp_transport* const transport
+);
+
+/*
+ * Set the stream scheduler of the SCTP transport. Defaults to the
+ * priority scheduler which sends messages of data channels with a
+ * higher priority first (and handles data channels of the same
+ * priority in a round robin fashion).
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_scheduler(
+    struct rawrtc_sctp_transport* const transport,
+    enum rawrtc_sctp_transport_scheduler const scheduler
+);
+
+/*
+ * Set the maximum size of an inbound message the SCTP transport will
+ * buffer until it is complete (unless overridden by the data channel's
+ * options). Defaults to the advertised maximum message size of
+ * 256 KiB. `0` means no limit.
+ *
+ * A data channel receiving a larger message stops buffering it, raises
+ * its error handler and will be closed.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_max_inbound_message_size(
+    struct rawrtc_sctp_transport* const transport,
+    uint64_t const max_message_size
+);
+
+/*
+ * Get the amount of inbound messages that have been aborted by the
+ * SCTP transport for exceeding the maximum inbound message size.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_inbound_messages_too_large(
+    uint64_t* const countp, // de-referenced
+    struct rawrtc_sctp_transport* const transport
+);
+
+/*
+ * Set the maximum amount of streams (and therefore data channels) of
+ * the SCTP transport. May only be called before the transport has been
+ * started. Defaults to 65535.
+ *
+ * The maximum amount of streams will be requested when the association
+ * is being established. Additional outgoing streams will only be added
+ * on demand in case the other peer negotiated fewer streams.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_max_streams(
+    struct rawrtc_sctp_transport* const transport,
+    uint16_t const max_streams
+);
+
+/*
+ * Get the currently negotiated amount of incoming and outgoing streams
+ * of the SCTP transport.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_streams(
+    uint16_t* const n_inboundp, // de-referenced
+    uint16_t* const n_outboundp, // de-referenced
+    struct rawrtc_sctp_transport* const transport
+);
+
+/*
+ * Get whether message interleaving (I-DATA, RFC 8260) has been
+ * negotiated with the other peer. If active, fragments of messages on
+ * different streams will be interleaved so that a large message does
+ * not block the messages of other data channels.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_interleaving(
+    bool* const activep, // de-referenced
+    struct rawrtc_sctp_transport* const transport
+);
+
 /*
  * TODO (from RTCSctpTransport interface)
  * rawrtc_sctp_transport_get_transport
@@ -1737,6 +2279,27 @@ enum rawrtc_code rawrtc_data_channel_parameters_get_protocol(
  * rawrtc_data_channel_parameters_get_id
  */
 
+/*
+ * Set the priority of the data channel parameters (see
+ * `enum rawrtc_data_channel_priority`). Defaults to normal priority.
+ *
+ * The priority is being signalled to the other peer for in-band
+ * negotiated data channels and used by the SCTP transport's stream
+ * scheduler.
+ */
+enum rawrtc_code rawrtc_data_channel_parameters_set_priority(
+    struct rawrtc_data_channel_parameters* const parameters,
+    uint16_t const priority
+);
+
+/*
+ * Get the priority from the data channel parameters.
+ */
+enum rawrtc_code rawrtc_data_channel_parameters_get_priority(
+    uint16_t* const priorityp, // de-referenced
+    struct rawrtc_data_channel_parameters* const parameters
+);
+
 /*
  * Create data channel options.
  *
@@ -1750,6 +2313,18 @@ enum rawrtc_code rawrtc_data_channel_options_create(
     bool const deliver_partially
 );
 
+/*
+ * Set the maximum size of an inbound message that will be buffered
+ * until it is complete. Crossing the limit aborts the message and
+ * closes the data channel. `0` uses the SCTP transport's limit.
+ *
+ * Note: This has no effect in case messages are delivered partially.
+ */
+enum rawrtc_code rawrtc_data_channel_options_set_max_message_size(
+    struct rawrtc_data_channel_options* const options,
+    uint64_t const max_message_size
+);
+
 /*
  * Get the corresponding name for a data channel state.
  */
@@ -1804,6 +2379,21 @@ enum rawrtc_code rawrtc_data_channel_send(
     bool const is_binary
 );
 
+/*
+ * Send data consisting of multiple segments via the data channel. The
+ * segments form a single message.
+ *
+ * The segments will be passed to the transport without merging them
+ * into a single buffer. They may be released once this function
+ * returns.
+ */
+enum rawrtc_code rawrtc_data_channel_sendv(
+    struct rawrtc_data_channel* const channel,
+    struct iovec const * const segments, // nullable (if empty message), copied
+    size_t const n_segments,
+    bool const is_binary
+);
+
 /*
  * Close the data channel.
  */
@@ -1811,15 +2401,81 @@ enum rawrtc_code rawrtc_data_channel_close(
     struct rawrtc_data_channel* const channel
 );
 
+/*
+ * Get the amount of bytes that have been queued for sending on the
+ * data channel but have not been transmitted, yet.
+ *
+ * Note: For SCTP, this includes bytes that have been handed out to
+ *       the SCTP stack. As the SCTP stack does not track this per
+ *       stream, that part is an estimation that is capped by the
+ *       association's send buffer usage.
+ */
+enum rawrtc_code rawrtc_data_channel_get_buffered_amount(
+    uint64_t* const amountp, // de-referenced
+    struct rawrtc_data_channel* const channel
+);
+
+/*
+ * Set the data channel's buffered amount low threshold.
+ *
+ * The buffered amount low handler will be called once the buffered
+ * amount of the channel decreases from above the threshold to or
+ * below the threshold. Defaults to `0`.
+ *
+ * Note: A changed threshold will be taken into account once data is
+ *       being sent on the channel.
+ */
+enum rawrtc_code rawrtc_data_channel_set_buffered_amount_low_threshold(
+    struct rawrtc_data_channel* const channel,
+    uint64_t const threshold
+);
+
+/*
+ * Get the data channel's buffered amount low threshold.
+ */
+enum rawrtc_code rawrtc_data_channel_get_buffered_amount_low_threshold(
+    uint64_t* const thresholdp, // de-referenced
+    struct rawrtc_data_channel* const channel
+);
+
 /*
  * TODO (from RTCDataChannel interface)
  * rawrtc_data_channel_get_transport
  * rawrtc_data_channel_get_ready_state
- * rawrtc_data_channel_get_buffered_amount
- * rawrtc_data_channel_get_buffered_amount_low_threshold
- * rawrtc_data_channel_set_buffered_amount_low_threshold
  */
 
+/*
+ * Send data via the data channel from any thread.
+ *
+ * The data will be copied and the message will be sent on the event
+ * loop thread in the order it has been posted. This function never
+ * blocks on the event loop. Errors occurring when sending on the event
+ * loop thread will only be logged.
+ *
+ * The caller MUST keep its reference to the channel until the message
+ * has been processed. Use `rawrtc_call_async` to un-reference the
+ * channel on the event loop thread.
+ */
+enum rawrtc_code rawrtc_data_channel_send_async(
+    struct rawrtc_data_channel* const channel,
+    struct mbuf* const buffer, // nullable (if empty message), copied
+    bool const is_binary
+);
+
+/*
+ * Close the data channel from any thread.
+ *
+ * The channel will be closed on the event loop thread after all
+ * previously posted commands have been processed.
+ *
+ * The caller MUST keep its reference to the channel until the command
+ * has been processed. Use `rawrtc_call_async` to un-reference the
+ * channel on the event loop thread.
+ */
+enum rawrtc_code rawrtc_data_channel_close_async(
+    struct rawrtc_data_channel* const channel
+);
+
 /*
  * Unset the handler argument and all handlers of the data channel.
  */
@@ -1920,6 +2576,27 @@ enum rawrtc_code rawrtc_data_channel_get_message_handler(
     struct rawrtc_data_channel* const channel
 );
 
+/*
+ * Set the data channel's chained message handler.
+ *
+ * In case a chained message handler has been set, it will be called
+ * instead of the message handler. This avoids copying messages that
+ * have been received in multiple chunks into a contiguous buffer.
+ */
+enum rawrtc_code rawrtc_data_channel_set_chained_message_handler(
+    struct rawrtc_data_channel* const channel,
+    rawrtc_data_channel_chained_message_handler* const message_handler // nullable
+);
+
+/*
+ * Get the data channel's chained message handler.
+ * Returns `RAWRTC_CODE_NO_VALUE` in case no handler has been set.
+ */
+enum rawrtc_code rawrtc_data_channel_get_chained_message_handler(
+    rawrtc_data_channel_chained_message_handler** const message_handlerp, // de-referenced
+    struct rawrtc_data_channel* const channel
+);
+
 /*
  * Get the corresponding name for a signaling state.
  */
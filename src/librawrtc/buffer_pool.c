@@ -0,0 +1,290 @@
+#include <rawrtc.h>
+#include "main.h"
+#include "buffer_pool.h"
+
+#define DEBUG_MODULE "buffer-pool"
+//#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
+#include "debug.h"
+
+/*
+ * Round a size up to the next power of two.
+ */
+static size_t round_up_power_of_two(
+        size_t size
+) {
+    size_t power = 1;
+    while (power < size) {
+        power <<= 1;
+    }
+    return power;
+}
+
+/*
+ * Get the size class index for a specific size.
+ * Return `pool->n_classes` in case no size class can hold the size.
+ */
+static size_t get_class_index(
+        struct rawrtc_buffer_pool* const pool, // not checked
+        size_t const size
+) {
+    size_t i;
+
+    // Find the smallest size class that fits
+    for (i = 0; i < pool->n_classes; ++i) {
+        if (pool->classes[i].size >= size) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+ * Destructor for an existing buffer pool.
+ */
+static void rawrtc_buffer_pool_destroy(
+        void* arg
+) {
+    struct rawrtc_buffer_pool* const pool = arg;
+    size_t i;
+    size_t j;
+
+    // Un-reference pooled buffers
+    for (i = 0; i < pool->n_classes; ++i) {
+        struct rawrtc_buffer_pool_class* const size_class = &pool->classes[i];
+        for (j = 0; j < size_class->n_buffers; ++j) {
+            mem_deref(size_class->buffers[j]);
+        }
+        mem_deref(size_class->buffers);
+    }
+
+    // Un-reference
+    mem_deref(pool->classes);
+}
+
+/*
+ * Create a buffer pool.
+ */
+enum rawrtc_code rawrtc_buffer_pool_create(
+        struct rawrtc_buffer_pool** const poolp, // de-referenced
+        size_t const min_size,
+        size_t const max_size,
+        size_t const class_capacity
+) {
+    struct rawrtc_buffer_pool* pool;
+    size_t min_class_size;
+    size_t max_class_size;
+    size_t n_classes;
+    size_t size;
+    size_t i;
+    enum rawrtc_code error = RAWRTC_CODE_SUCCESS;
+
+    // Check arguments
+    if (!poolp || min_size == 0 || min_size > max_size || class_capacity == 0) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Round sizes & calculate amount of size classes
+    min_class_size = round_up_power_of_two(min_size);
+    max_class_size = round_up_power_of_two(max_size);
+    n_classes = 1;
+    for (size = min_class_size; size < max_class_size; size <<= 1) {
+        ++n_classes;
+    }
+
+    // Allocate
+    pool = mem_zalloc(sizeof(*pool), rawrtc_buffer_pool_destroy);
+    if (!pool) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Allocate size classes
+    pool->classes = mem_zalloc(n_classes * sizeof(*pool->classes), NULL);
+    if (!pool->classes) {
+        error = RAWRTC_CODE_NO_MEMORY;
+        goto out;
+    }
+
+    // Set fields
+    pool->n_classes = n_classes;
+    pool->class_capacity = class_capacity;
+
+    // Setup size classes
+    for (i = 0, size = min_class_size; i < n_classes; ++i, size <<= 1) {
+        struct rawrtc_buffer_pool_class* const size_class = &pool->classes[i];
+        size_class->size = size;
+        size_class->buffers = mem_zalloc(class_capacity * sizeof(*size_class->buffers), NULL);
+        if (!size_class->buffers) {
+            error = RAWRTC_CODE_NO_MEMORY;
+            goto out;
+        }
+    }
+
+out:
+    if (error) {
+        mem_deref(pool);
+    } else {
+        // Set pointer
+        *poolp = pool;
+    }
+    return error;
+}
+
+/*
+ * Get a buffer with at least `size` bytes of capacity from a buffer
+ * pool.
+ */
+enum rawrtc_code rawrtc_buffer_pool_get(
+        struct mbuf** const bufferp, // de-referenced
+        struct rawrtc_buffer_pool* const pool, // nullable
+        size_t const size
+) {
+    size_t index;
+    struct rawrtc_buffer_pool_class* size_class = NULL;
+    struct mbuf* buffer;
+
+    // Check arguments
+    if (!bufferp) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Get size class (if any)
+    if (pool) {
+        index = get_class_index(pool, size);
+        if (index < pool->n_classes) {
+            size_class = &pool->classes[index];
+        }
+    }
+
+    // Take buffer from size class (if any)
+    if (size_class && size_class->n_buffers > 0) {
+        buffer = size_class->buffers[--size_class->n_buffers];
+        size_class->buffers[size_class->n_buffers] = NULL;
+        mbuf_rewind(buffer);
+
+        // Update statistics
+        ++pool->stats.n_hits;
+        --pool->stats.n_pooled;
+        pool->stats.size_pooled -= size_class->size;
+
+        // Set pointer & done
+        *bufferp = buffer;
+        return RAWRTC_CODE_SUCCESS;
+    }
+
+    // Allocate (using the size class' size so it can be recycled later)
+    buffer = mbuf_alloc(size_class ? size_class->size : size);
+    if (!buffer) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Update statistics
+    if (pool) {
+        ++pool->stats.n_misses;
+    }
+
+    // Set pointer & done
+    *bufferp = buffer;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Return a buffer to a buffer pool. This will un-reference the buffer.
+ */
+void rawrtc_buffer_pool_put(
+        struct rawrtc_buffer_pool* const pool, // nullable
+        struct mbuf* const buffer // nullable, de-referenced
+) {
+    size_t index;
+    struct rawrtc_buffer_pool_class* size_class;
+
+    // Nothing to do?
+    if (!buffer) {
+        return;
+    }
+
+    // Only recycle if we hold the last reference (to both the buffer and its memory)
+    if (!pool || mem_nrefs(buffer) != 1 || !buffer->buf || mem_nrefs(buffer->buf) != 1) {
+        goto discard;
+    }
+
+    // Find matching size class (size must match exactly)
+    index = get_class_index(pool, buffer->size);
+    if (index == pool->n_classes) {
+        goto discard;
+    }
+    size_class = &pool->classes[index];
+    if (size_class->size != buffer->size || size_class->n_buffers == pool->class_capacity) {
+        goto discard;
+    }
+
+    // Add to size class
+    size_class->buffers[size_class->n_buffers++] = buffer;
+
+    // Update statistics
+    ++pool->stats.n_returned;
+    ++pool->stats.n_pooled;
+    pool->stats.size_pooled += size_class->size;
+    if (pool->stats.n_pooled > pool->stats.n_pooled_high_water_mark) {
+        pool->stats.n_pooled_high_water_mark = pool->stats.n_pooled;
+    }
+    if (pool->stats.size_pooled > pool->stats.size_pooled_high_water_mark) {
+        pool->stats.size_pooled_high_water_mark = pool->stats.size_pooled;
+    }
+    return;
+
+discard:
+    // Update statistics
+    if (pool) {
+        ++pool->stats.n_discarded;
+    }
+
+    // Un-reference
+    mem_deref(buffer);
+}
+
+/*
+ * Get the statistics of a buffer pool.
+ */
+enum rawrtc_code rawrtc_buffer_pool_get_stats(
+        struct rawrtc_buffer_pool_stats* const statsp, // de-referenced
+        struct rawrtc_buffer_pool* const pool
+) {
+    // Check arguments
+    if (!statsp || !pool) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Copy statistics & done
+    *statsp = pool->stats;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the library-wide buffer pool that is used for transport
+ * buffers.
+ * `*poolp` must be unreferenced.
+ */
+enum rawrtc_code rawrtc_get_buffer_pool(
+        struct rawrtc_buffer_pool** const poolp // de-referenced
+) {
+    // Check arguments
+    if (!poolp) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Initialised?
+    if (!rawrtc_global.buffer_pool) {
+        return RAWRTC_CODE_NO_VALUE;
+    }
+
+    // Set pointer & done
+    *poolp = mem_ref(rawrtc_global.buffer_pool);
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the library-wide buffer pool (not referenced, nullable).
+ */
+struct rawrtc_buffer_pool* rawrtc_buffer_pool_global() {
+    return rawrtc_global.buffer_pool;
+}
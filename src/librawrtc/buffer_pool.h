@@ -0,0 +1,13 @@
+#pragma once
+#include <rawrtc.h>
+
+/*
+ * Library-wide buffer pool defaults.
+ */
+enum {
+    RAWRTC_BUFFER_POOL_DEFAULT_MIN_SIZE = 64,
+    RAWRTC_BUFFER_POOL_DEFAULT_MAX_SIZE = 262144,
+    RAWRTC_BUFFER_POOL_DEFAULT_CLASS_CAPACITY = 16,
+};
+
+struct rawrtc_buffer_pool* rawrtc_buffer_pool_global();
@@ -1,5 +1,8 @@
 #include <rawrtc.h>
 #include "candidate_helper.h"
+#ifdef BATCHED_UDP_IO
+#include "udp_batch.h"
+#endif
 
 #define DEBUG_MODULE "candidate-helper"
 //#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
@@ -24,6 +27,7 @@ static void rawrtc_candidate_helper_destroy(
     
     // Un-reference
     list_flush(&local_candidate->stun_sessions);
+    mem_deref(local_candidate->batch_receiver);
     mem_deref(local_candidate->udp_helper);
     mem_deref(local_candidate->candidate);
     mem_deref(local_candidate->gatherer);
@@ -68,6 +72,16 @@ enum rawrtc_code rawrtc_candidate_helper_create(
         goto out;
     }
 
+#ifdef BATCHED_UDP_IO
+    // Drain the local candidate's UDP socket in batches
+    error = rawrtc_udp_batch_receiver_create(
+            &candidate_helper->batch_receiver,
+            trice_lcand_sock(gatherer->ice, candidate));
+    if (error) {
+        goto out;
+    }
+#endif
+
 out:
     if (error) {
         mem_deref(candidate_helper);
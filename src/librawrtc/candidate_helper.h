@@ -21,6 +21,7 @@ struct rawrtc_candidate_helper {
     uint_fast8_t srflx_pending_count;
     struct list stun_sessions;
     uint_fast8_t relay_pending_count;
+    struct rawrtc_udp_batch_receiver* batch_receiver; // nullable
 };
 
 enum rawrtc_code rawrtc_candidate_helper_create(
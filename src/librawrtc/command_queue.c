@@ -0,0 +1,265 @@
+#include <errno.h> // errno
+#include <fcntl.h> // fcntl
+#include <unistd.h> // pipe, read, write, close
+#ifdef __linux__
+#include <sys/eventfd.h> // eventfd
+#endif
+#include <rawrtc.h>
+#include "main.h"
+#include "command_queue.h"
+
+#define DEBUG_MODULE "command-queue"
+//#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
+#include "debug.h"
+
+/*
+ * Execute a command on the event loop thread.
+ */
+static void command_execute(
+        struct rawrtc_command* const command // not checked
+) {
+    enum rawrtc_code error = RAWRTC_CODE_SUCCESS;
+
+    switch (command->type) {
+        case RAWRTC_COMMAND_TYPE_CALL:
+            command->handler(command->arg);
+            break;
+        case RAWRTC_COMMAND_TYPE_DATA_CHANNEL_SEND:
+            error = rawrtc_data_channel_send(command->channel, command->buffer, command->is_binary);
+            break;
+        case RAWRTC_COMMAND_TYPE_DATA_CHANNEL_CLOSE:
+            error = rawrtc_data_channel_close(command->channel);
+            break;
+        default:
+            DEBUG_WARNING("Unknown command type: %d\n", command->type);
+            break;
+    }
+
+    // Handle error
+    if (error) {
+        DEBUG_WARNING("Command failed, reason: %s\n", rawrtc_code_to_str(error));
+    }
+}
+
+/*
+ * Take all commands from the queue.
+ * Returns the commands in the order they have been posted.
+ */
+static struct rawrtc_command* commands_take(
+        struct rawrtc_command_queue* const queue // not checked
+) {
+    struct rawrtc_command* command;
+    struct rawrtc_command* commands = NULL;
+
+    // Detach the list of posted commands
+    command = atomic_exchange_explicit(&queue->head, NULL, memory_order_acquire);
+
+    // Reverse (producers push in LIFO order)
+    while (command) {
+        struct rawrtc_command* const next = command->next;
+        command->next = commands;
+        commands = command;
+        command = next;
+    }
+
+    // Done
+    return commands;
+}
+
+/*
+ * Handle a wakeup of the event loop thread and execute all posted
+ * commands in one batch.
+ */
+static void wakeup_handler(
+        int flags,
+        void* arg
+) {
+    struct rawrtc_command_queue* const queue = arg;
+    uint64_t value;
+    struct rawrtc_command* command;
+    (void) flags;
+
+    // Drain wakeup fd
+    // Note: This needs to be done before taking the commands, so a command posted in the
+    //       meantime will trigger another wakeup.
+    while (read(queue->fds[0], &value, sizeof(value)) > 0) {}
+
+    // Execute commands
+    command = commands_take(queue);
+    while (command) {
+        struct rawrtc_command* const next = command->next;
+        command_execute(command);
+        mem_deref(command);
+        command = next;
+    }
+}
+
+/*
+ * Initialise the command queue.
+ * Must be called from the event loop thread.
+ */
+enum rawrtc_code rawrtc_command_queue_init(
+        struct rawrtc_command_queue* const queue // not checked
+) {
+    int err;
+    enum rawrtc_code error;
+
+    // Initialise head
+    atomic_init(&queue->head, NULL);
+
+    // Create wakeup fd(s)
+#ifdef __linux__
+    queue->fds[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (queue->fds[0] == -1) {
+        return rawrtc_error_to_code(errno);
+    }
+    queue->fds[1] = queue->fds[0];
+#else
+    if (pipe(queue->fds)) {
+        return rawrtc_error_to_code(errno);
+    }
+    if (fcntl(queue->fds[0], F_SETFL, O_NONBLOCK) == -1
+            || fcntl(queue->fds[1], F_SETFL, O_NONBLOCK) == -1) {
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
+#endif
+
+    // Listen for wakeups
+    err = fd_listen(queue->fds[0], FD_READ, wakeup_handler, queue);
+    if (err) {
+        error = rawrtc_error_to_code(err);
+        goto out;
+    }
+
+    // Done
+    error = RAWRTC_CODE_SUCCESS;
+
+out:
+    if (error) {
+        close(queue->fds[0]);
+        if (queue->fds[1] != queue->fds[0]) {
+            close(queue->fds[1]);
+        }
+    }
+    return error;
+}
+
+/*
+ * Close the command queue. Pending commands will be discarded.
+ * Must be called from the event loop thread.
+ */
+void rawrtc_command_queue_close(
+        struct rawrtc_command_queue* const queue // not checked
+) {
+    struct rawrtc_command* command;
+
+    // Stop listening & close wakeup fd(s)
+    fd_close(queue->fds[0]);
+    close(queue->fds[0]);
+    if (queue->fds[1] != queue->fds[0]) {
+        close(queue->fds[1]);
+    }
+
+    // Discard pending commands
+    command = commands_take(queue);
+    while (command) {
+        struct rawrtc_command* const next = command->next;
+        mem_deref(command);
+        command = next;
+    }
+}
+
+/*
+ * Destructor for an existing command.
+ */
+static void rawrtc_command_destroy(
+        void* arg
+) {
+    struct rawrtc_command* const command = arg;
+
+    // Un-reference
+    mem_deref(command->buffer);
+}
+
+/*
+ * Create a command.
+ * May be called from any thread.
+ */
+enum rawrtc_code rawrtc_command_create(
+        struct rawrtc_command** const commandp, // de-referenced, not checked
+        enum rawrtc_command_type const type
+) {
+    struct rawrtc_command* command;
+
+    // Allocate
+    command = mem_zalloc(sizeof(*command), rawrtc_command_destroy);
+    if (!command) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Set fields
+    command->type = type;
+
+    // Set pointer & done
+    *commandp = command;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Post a command to the event loop thread. The queue takes over the
+ * caller's reference to the command.
+ * May be called from any thread and never blocks.
+ */
+void rawrtc_command_post(
+        struct rawrtc_command* const command // not checked
+) {
+    struct rawrtc_command_queue* const queue = &rawrtc_global.command_queue;
+    struct rawrtc_command* head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint64_t const value = 1;
+
+    // Push onto queue
+    do {
+        command->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(
+            &queue->head, &head, command, memory_order_release, memory_order_relaxed));
+
+    // Wake up event loop thread (if the queue has been empty)
+    // Note: Otherwise, a wakeup is already pending.
+    if (!head) {
+        if (write(queue->fds[1], &value, sizeof(value)) == -1 && errno != EAGAIN) {
+            DEBUG_WARNING("Unable to wake up event loop thread, reason: %m\n", errno);
+        }
+    }
+}
+
+/*
+ * Call a handler on the event loop thread.
+ * May be called from any thread and never blocks.
+ */
+enum rawrtc_code rawrtc_call_async(
+        rawrtc_command_handler* const handler,
+        void* const arg // nullable
+) {
+    struct rawrtc_command* command;
+    enum rawrtc_code error;
+
+    // Check arguments
+    if (!handler) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Create command
+    error = rawrtc_command_create(&command, RAWRTC_COMMAND_TYPE_CALL);
+    if (error) {
+        return error;
+    }
+
+    // Set fields
+    command->handler = handler;
+    command->arg = arg;
+
+    // Post command & done
+    rawrtc_command_post(command);
+    return RAWRTC_CODE_SUCCESS;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdatomic.h> // _Atomic, atomic_*
+#include <rawrtc.h>
+
+/*
+ * Command types.
+ */
+enum rawrtc_command_type {
+    RAWRTC_COMMAND_TYPE_CALL,
+    RAWRTC_COMMAND_TYPE_DATA_CHANNEL_SEND,
+    RAWRTC_COMMAND_TYPE_DATA_CHANNEL_CLOSE,
+};
+
+/*
+ * Command posted to the event loop thread.
+ */
+struct rawrtc_command {
+    struct rawrtc_command* next;
+    enum rawrtc_command_type type;
+    rawrtc_command_handler* handler; // nullable
+    void* arg; // nullable
+    struct rawrtc_data_channel* channel; // nullable
+    struct mbuf* buffer; // nullable
+    bool is_binary;
+};
+
+/*
+ * Command queue (multiple producers, single consumer).
+ */
+struct rawrtc_command_queue {
+    _Atomic(struct rawrtc_command*) head;
+    int fds[2];
+};
+
+enum rawrtc_code rawrtc_command_queue_init(
+    struct rawrtc_command_queue* const queue // not checked
+);
+
+void rawrtc_command_queue_close(
+    struct rawrtc_command_queue* const queue // not checked
+);
+
+enum rawrtc_code rawrtc_command_create(
+    struct rawrtc_command** const commandp, // de-referenced, not checked
+    enum rawrtc_command_type const type
+);
+
+void rawrtc_command_post(
+    struct rawrtc_command* const command // referenced, not checked
+);
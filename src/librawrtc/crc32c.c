@@ -31,13 +31,28 @@
 /* Version history:
    1.0  10 Feb 2013  First version
    1.1   1 Aug 2013  Correct comments on why three crc instructions in parallel
+   1.2               Altered for rawrtc: Add PCLMULQDQ folding for long buffers
+                     on x86-64 and the ARMv8 CRC32 extension on AArch64, select
+                     the implementation once at runtime
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #include <pthread.h>
+#include "crc32c.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CRC32C_HW
+#elif defined(__aarch64__) && defined(__linux__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define CRC32C_HW
+#endif
 
 /* CRC-32C (iSCSI) polynomial in reversed bit order. */
 #define POLY 0x82f63b78
@@ -199,6 +214,60 @@ static inline uint32_t crc32c_shift(uint32_t zeros[][256], uint32_t crc)
            zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
 }
 
+/* Tables that shift a crc by 2^k zeros, for patching a crc in O(log n). */
+#define PATCH_BITS 16
+static pthread_once_t crc32c_once_patch = PTHREAD_ONCE_INIT;
+static uint32_t crc32c_pow2[PATCH_BITS][4][256];
+
+/* Initialize tables for shifting crcs by powers of two. */
+static void crc32c_init_patch(void)
+{
+    int k;
+
+    for (k = 0; k < PATCH_BITS; k++)
+        crc32c_zeros(crc32c_pow2[k], (size_t)1 << k);
+}
+
+/* Update the CRC-32C of a buffer after len bytes have been changed from old to
+   new, followed by tail unchanged bytes.  The crc is linear, so the update is
+   the crc of the difference, computed from a zero register without pre- and
+   post-processing, then shifted over the tail.  Unchanged leading bytes do not
+   contribute to the difference.  The cost is O(len + log(tail)). */
+uint32_t crc32c_patch(uint32_t crc, const void *old, const void *new,
+                      size_t len, size_t tail)
+{
+    const unsigned char *prev = old;
+    const unsigned char *next = new;
+    uint32_t diff = 0;
+    int k;
+
+    /* populate tables the first time through */
+    pthread_once(&crc32c_once_sw, crc32c_init_sw);
+    pthread_once(&crc32c_once_patch, crc32c_init_patch);
+
+    /* compute the crc of the difference */
+    while (len) {
+        diff = crc32c_table[0][(diff ^ *prev++ ^ *next++) & 0xff] ^ (diff >> 8);
+        len--;
+    }
+
+    /* shift it over the tail, applying 2^PATCH_BITS zeros as two halves for
+       longer tails */
+    while (tail >> PATCH_BITS) {
+        diff = crc32c_shift(crc32c_pow2[PATCH_BITS - 1], diff);
+        diff = crc32c_shift(crc32c_pow2[PATCH_BITS - 1], diff);
+        tail -= (size_t)1 << PATCH_BITS;
+    }
+    for (k = 0; tail; k++, tail >>= 1)
+        if (tail & 1)
+            diff = crc32c_shift(crc32c_pow2[k], diff);
+
+    /* apply the difference */
+    return crc ^ diff;
+}
+
+#ifdef CRC32C_HW
+
 /* Block sizes for three-way parallel crc computation.  LONG and SHORT must
    both be powers of two.  The associated string constants must be set
    accordingly, for use in constructing the assembler instructions. */
@@ -214,13 +283,42 @@ static pthread_once_t crc32c_once_hw = PTHREAD_ONCE_INIT;
 static uint32_t crc32c_long[4][256];
 static uint32_t crc32c_short[4][256];
 
+#if defined(__x86_64__)
+/* Constants for folding 128 bit blocks by four and by one block with
+   carry-less multiplication, see crc32c_init_hw(). */
+static uint32_t crc32c_fold4[2];
+static uint32_t crc32c_fold1[2];
+
+/* Compute x^n modulo the CRC-32C polynomial, in reversed bit order. */
+static uint32_t crc32c_xpow(size_t n)
+{
+    uint32_t p = 0x80000000;    /* x^0 */
+
+    while (n--)
+        p = p & 1 ? (p >> 1) ^ POLY : p >> 1;
+    return p;
+}
+#endif
+
 /* Initialize tables for shifting crcs. */
 static void crc32c_init_hw(void)
 {
     crc32c_zeros(crc32c_long, LONG);
     crc32c_zeros(crc32c_short, SHORT);
+
+#if defined(__x86_64__)
+    /* A carry-less product of a 64-bit and a 32-bit operand in reversed bit
+       order is the product times x^33 when read as a 128-bit block.  Folding
+       a block by d bits onto a later block therefore multiplies its first
+       quadword by x^(d+64-33) and its second quadword by x^(d-33). */
+    crc32c_fold4[0] = crc32c_xpow(512 + 64 - 33);
+    crc32c_fold4[1] = crc32c_xpow(512 - 33);
+    crc32c_fold1[0] = crc32c_xpow(128 + 64 - 33);
+    crc32c_fold1[1] = crc32c_xpow(128 - 33);
+#endif
 }
 
+#if defined(__x86_64__)
 /* Compute CRC-32C using the Intel hardware instruction. */
 static uint32_t crc32c_hw(uint32_t crc, const void *buf, size_t len)
 {
@@ -310,28 +408,254 @@ static uint32_t crc32c_hw(uint32_t crc, const void *buf, size_t len)
     return (uint32_t)crc0 ^ 0xffffffff;
 }
 
+/* Fold a 128-bit block onto the next block using the constants in k. */
+__attribute__((target("sse4.2,pclmul")))
+static inline __m128i crc32c_fold(__m128i x, __m128i k, __m128i next)
+{
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00),
+                                       _mm_clmulepi64_si128(x, k, 0x11)),
+                         next);
+}
+
+/* Compute CRC-32C by folding four 128-bit lanes with the PCLMULQDQ
+   instruction, reducing the result with the crc instruction.  This is faster
+   than crc32c_hw() from 64 bytes on.  Shorter buffers are handed to
+   crc32c_hw(). */
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_clmul(uint32_t crc, const void *buf, size_t len)
+{
+    const unsigned char *next = buf;
+    __m128i x0, x1, x2, x3, k;
+    uint64_t crc0, word;
+
+    /* the folding needs at least four blocks */
+    if (len < 64)
+        return crc32c_hw(crc, buf, len);
+
+    /* populate folding constants the first time through */
+    pthread_once(&crc32c_once_hw, crc32c_init_hw);
+
+    /* load the first four blocks and xor the pre-processed crc into the
+       first four bytes */
+    x0 = _mm_loadu_si128((const __m128i *)next);
+    x1 = _mm_loadu_si128((const __m128i *)(next + 16));
+    x2 = _mm_loadu_si128((const __m128i *)(next + 32));
+    x3 = _mm_loadu_si128((const __m128i *)(next + 48));
+    x0 = _mm_xor_si128(x0, _mm_cvtsi32_si128((int)(crc ^ 0xffffffff)));
+    next += 64;
+    len -= 64;
+
+    /* fold each lane by four blocks, 64 bytes at a time */
+    k = _mm_set_epi64x(crc32c_fold4[1], crc32c_fold4[0]);
+    while (len >= 64) {
+        x0 = crc32c_fold(x0, k, _mm_loadu_si128((const __m128i *)next));
+        x1 = crc32c_fold(x1, k, _mm_loadu_si128((const __m128i *)(next + 16)));
+        x2 = crc32c_fold(x2, k, _mm_loadu_si128((const __m128i *)(next + 32)));
+        x3 = crc32c_fold(x3, k, _mm_loadu_si128((const __m128i *)(next + 48)));
+        next += 64;
+        len -= 64;
+    }
+
+    /* fold the lanes into one, then fold the remaining blocks */
+    k = _mm_set_epi64x(crc32c_fold1[1], crc32c_fold1[0]);
+    x1 = crc32c_fold(x0, k, x1);
+    x2 = crc32c_fold(x1, k, x2);
+    x3 = crc32c_fold(x2, k, x3);
+    while (len >= 16) {
+        x3 = crc32c_fold(x3, k, _mm_loadu_si128((const __m128i *)next));
+        next += 16;
+        len -= 16;
+    }
+
+    /* reduce the remaining block with the crc instruction */
+    crc0 = _mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(x3));
+    crc0 = _mm_crc32_u64(crc0, (uint64_t)_mm_extract_epi64(x3, 1));
+
+    /* compute the crc for the trailing bytes */
+    while (len >= 8) {
+        memcpy(&word, next, 8);
+        crc0 = _mm_crc32_u64(crc0, word);
+        next += 8;
+        len -= 8;
+    }
+    while (len) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *next);
+        next++;
+        len--;
+    }
+
+    /* return a post-processed crc */
+    return (uint32_t)crc0 ^ 0xffffffff;
+}
+
+/* Get the ecx register of cpuid leaf 1.  This does not check for the existence
+   of the cpuid instruction itself, which was introduced on the 486SL in 1992,
+   so this will fail on earlier x86 processors.  cpuid works on all Pentium and
+   later processors. */
+static uint32_t cpuid_features(void)
+{
+    uint32_t eax, ecx;
+
+    eax = 1;
+    __asm__("cpuid"
+            : "=c"(ecx)
+            : "a"(eax)
+            : "%ebx", "%edx");
+    return ecx;
+}
+
 /* Check for SSE 4.2.  SSE 4.2 was first supported in Nehalem processors
-   introduced in November, 2008.  This does not check for the existence of the
-   cpuid instruction itself, which was introduced on the 486SL in 1992, so this
-   will fail on earlier x86 processors.  cpuid works on all Pentium and later
-   processors. */
-#define SSE42(have) \
-    do { \
-        uint32_t eax, ecx; \
-        eax = 1; \
-        __asm__("cpuid" \
-                : "=c"(ecx) \
-                : "a"(eax) \
-                : "%ebx", "%edx"); \
-        (have) = (ecx >> 20) & 1; \
-    } while (0)
-
-/* Compute a CRC-32C.  If the crc32 instruction is available, use the hardware
-   version.  Otherwise, use the software version. */
-uint32_t crc32c(uint32_t crc, const void *buf, size_t len)
+   introduced in November, 2008. */
+#define HAVE_SSE42() ((cpuid_features() >> 20) & 1)
+
+/* Check for PCLMULQDQ, first supported in Westmere processors. */
+#define HAVE_PCLMUL() ((cpuid_features() >> 1) & 1)
+
+#elif defined(__aarch64__)
+
+#ifdef __clang__
+#define TARGET_CRC __attribute__((target("crc")))
+#else
+#define TARGET_CRC __attribute__((target("+crc")))
+#endif
+
+/* Compute CRC-32C using the ARMv8 CRC32 extension.  Like crc32c_hw(), this
+   runs three independent crc instructions in parallel on long buffers to hide
+   the latency of the instruction. */
+TARGET_CRC
+static uint32_t crc32c_armv8(uint32_t crc, const void *buf, size_t len)
 {
-    int sse42;
+    const unsigned char *next = buf;
+    const unsigned char *end;
+    uint32_t crc0, crc1, crc2;
+    uint64_t word0, word1, word2;
 
-    SSE42(sse42);
-    return sse42 ? crc32c_hw(crc, buf, len) : crc32c_sw(crc, buf, len);
+    /* populate shift tables the first time through */
+    pthread_once(&crc32c_once_hw, crc32c_init_hw);
+
+    /* pre-process the crc */
+    crc0 = crc ^ 0xffffffff;
+
+    /* compute the crc for up to seven leading bytes to bring the data pointer
+       to an eight-byte boundary */
+    while (len && ((uintptr_t)next & 7) != 0) {
+        crc0 = __crc32cb(crc0, *next);
+        next++;
+        len--;
+    }
+
+    /* compute the crc on sets of LONG*3 bytes */
+    while (len >= LONG*3) {
+        crc1 = 0;
+        crc2 = 0;
+        end = next + LONG;
+        do {
+            word0 = *(const uint64_t *)next;
+            word1 = *(const uint64_t *)(next + LONG);
+            word2 = *(const uint64_t *)(next + LONG*2);
+            crc0 = __crc32cd(crc0, word0);
+            crc1 = __crc32cd(crc1, word1);
+            crc2 = __crc32cd(crc2, word2);
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(crc32c_long, crc0) ^ crc1;
+        crc0 = crc32c_shift(crc32c_long, crc0) ^ crc2;
+        next += LONG*2;
+        len -= LONG*3;
+    }
+
+    /* do the same thing, but now on SHORT*3 blocks for the remaining data less
+       than a LONG*3 block */
+    while (len >= SHORT*3) {
+        crc1 = 0;
+        crc2 = 0;
+        end = next + SHORT;
+        do {
+            word0 = *(const uint64_t *)next;
+            word1 = *(const uint64_t *)(next + SHORT);
+            word2 = *(const uint64_t *)(next + SHORT*2);
+            crc0 = __crc32cd(crc0, word0);
+            crc1 = __crc32cd(crc1, word1);
+            crc2 = __crc32cd(crc2, word2);
+            next += 8;
+        } while (next < end);
+        crc0 = crc32c_shift(crc32c_short, crc0) ^ crc1;
+        crc0 = crc32c_shift(crc32c_short, crc0) ^ crc2;
+        next += SHORT*2;
+        len -= SHORT*3;
+    }
+
+    /* compute the crc on the remaining eight-byte units */
+    end = next + (len - (len & 7));
+    while (next < end) {
+        crc0 = __crc32cd(crc0, *(const uint64_t *)next);
+        next += 8;
+    }
+    len &= 7;
+
+    /* compute the crc for up to seven trailing bytes */
+    while (len) {
+        crc0 = __crc32cb(crc0, *next);
+        next++;
+        len--;
+    }
+
+    /* return a post-processed crc */
+    return crc0 ^ 0xffffffff;
+}
+
+/* Check for the ARMv8 CRC32 extension. */
+#define HAVE_ARMV8_CRC32() ((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0)
+
+#endif
+#endif /* CRC32C_HW */
+
+/* Get a specific CRC-32C implementation, or NULL if the processor does not
+   support it. */
+crc32c_function *crc32c_get_variant(enum crc32c_variant variant)
+{
+    switch (variant) {
+    case CRC32C_VARIANT_SOFTWARE:
+        return crc32c_sw;
+#if defined(__x86_64__)
+    case CRC32C_VARIANT_SSE42:
+        return HAVE_SSE42() ? crc32c_hw : NULL;
+    case CRC32C_VARIANT_PCLMUL:
+        return HAVE_SSE42() && HAVE_PCLMUL() ? crc32c_clmul : NULL;
+#elif defined(__aarch64__) && defined(__linux__)
+    case CRC32C_VARIANT_ARMV8:
+        return HAVE_ARMV8_CRC32() ? crc32c_armv8 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+/* Implementation selected at runtime, see crc32c_select(). */
+static pthread_once_t crc32c_once_select = PTHREAD_ONCE_INIT;
+static crc32c_function *crc32c_selected;
+
+/* Select the fastest implementation the processor supports. */
+static void crc32c_select(void)
+{
+#if defined(__x86_64__)
+    if (crc32c_get_variant(CRC32C_VARIANT_PCLMUL))
+        crc32c_selected = crc32c_clmul;
+    else if (crc32c_get_variant(CRC32C_VARIANT_SSE42))
+        crc32c_selected = crc32c_hw;
+    else
+        crc32c_selected = crc32c_sw;
+#else
+    crc32c_selected = crc32c_get_variant(CRC32C_VARIANT_ARMV8);
+    if (!crc32c_selected)
+        crc32c_selected = crc32c_sw;
+#endif
+}
+
+/* Compute a CRC-32C.  Use the fastest hardware version the processor
+   supports, which is selected once.  Otherwise, use the software version. */
+uint32_t crc32c(uint32_t crc, const void *buf, size_t len)
+{
+    pthread_once(&crc32c_once_select, crc32c_select);
+    return crc32c_selected(crc, buf, len);
 }
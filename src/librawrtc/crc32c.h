@@ -3,11 +3,53 @@
 #include <stdlib.h>
 
 /*
- * Compute a CRC-32C.  If the crc32 instruction is available, use the hardware
- * version.  Otherwise, use the software version.
+ * CRC-32C implementation variants.
+ */
+enum crc32c_variant {
+    CRC32C_VARIANT_SOFTWARE,
+    CRC32C_VARIANT_SSE42,
+    CRC32C_VARIANT_PCLMUL,
+    CRC32C_VARIANT_ARMV8,
+};
+
+/*
+ * CRC-32C implementation.
+ */
+typedef uint32_t (crc32c_function)(
+    uint32_t crc,
+    void const* buf,
+    size_t len
+);
+
+/*
+ * Compute a CRC-32C.  Use the fastest hardware version the processor
+ * supports (selected once at runtime).  Otherwise, use the software
+ * version.
  */
 uint32_t crc32c(
     uint32_t crc,
     void const* buf,
     size_t len
 );
+
+/*
+ * Update a CRC-32C after `len` bytes of a buffer have been changed
+ * from `old` to `new`, followed by `tail` unchanged bytes.  Unchanged
+ * leading bytes do not need to be known.  The cost is
+ * O(len + log(tail)).
+ */
+uint32_t crc32c_patch(
+    uint32_t crc,
+    void const* old,
+    void const* new,
+    size_t len,
+    size_t tail
+);
+
+/*
+ * Get a specific CRC-32C implementation.  Return `NULL` in case the
+ * processor does not support it.
+ */
+crc32c_function* crc32c_get_variant(
+    enum crc32c_variant const variant
+);
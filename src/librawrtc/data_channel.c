@@ -1,6 +1,7 @@
 #include <rawrtc.h>
 #include "utils.h"
 #include "data_transport.h"
+#include "command_queue.h"
 
 #define DEBUG_MODULE "data-channel"
 //#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
@@ -306,6 +307,117 @@ enum rawrtc_code rawrtc_data_channel_send(
     return channel->transport->channel_send(channel, buffer, is_binary);
 }
 
+/*
+ * Send data consisting of multiple segments via the data channel.
+ */
+enum rawrtc_code rawrtc_data_channel_sendv(
+        struct rawrtc_data_channel* const channel,
+        struct iovec const * const segments, // nullable (if empty message), copied
+        size_t const n_segments,
+        bool const is_binary
+) {
+    struct mbuf* buffer;
+    size_t i;
+    int err = 0;
+    enum rawrtc_code error;
+
+    // Check arguments
+    if (!channel || (n_segments > 0 && !segments)) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Check state
+    if (channel->state != RAWRTC_DATA_CHANNEL_STATE_OPEN) {
+        return RAWRTC_CODE_INVALID_STATE;
+    }
+
+    // Clear options flag
+    channel->flags &= ~RAWRTC_DATA_CHANNEL_FLAGS_CAN_SET_OPTIONS;
+
+    // Call handler (if supported by the transport)
+    if (channel->transport->channel_sendv) {
+        return channel->transport->channel_sendv(channel, segments, n_segments, is_binary);
+    }
+
+    // Merge segments into a single buffer
+    buffer = mbuf_alloc(0);
+    if (!buffer) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+    for (i = 0; i < n_segments && !err; ++i) {
+        err = mbuf_write_mem(buffer, segments[i].iov_base, segments[i].iov_len);
+    }
+    if (err) {
+        error = rawrtc_error_to_code(err);
+        goto out;
+    }
+    mbuf_set_pos(buffer, 0);
+
+    // Call handler
+    error = channel->transport->channel_send(channel, buffer, is_binary);
+
+out:
+    // Un-reference
+    mem_deref(buffer);
+    return error;
+}
+
+/*
+ * Get the amount of bytes that have been queued for sending on the
+ * data channel but have not been transmitted, yet.
+ */
+enum rawrtc_code rawrtc_data_channel_get_buffered_amount(
+        uint64_t* const amountp, // de-referenced
+        struct rawrtc_data_channel* const channel
+) {
+    // Check arguments
+    if (!amountp || !channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Unsupported by transport?
+    if (!channel->transport->channel_get_buffered_amount) {
+        return RAWRTC_CODE_NOT_IMPLEMENTED;
+    }
+
+    // Call handler
+    return channel->transport->channel_get_buffered_amount(amountp, channel);
+}
+
+/*
+ * Set the data channel's buffered amount low threshold.
+ */
+enum rawrtc_code rawrtc_data_channel_set_buffered_amount_low_threshold(
+        struct rawrtc_data_channel* const channel,
+        uint64_t const threshold
+) {
+    // Check arguments
+    if (!channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set threshold & done
+    channel->buffered_amount_low_threshold = threshold;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the data channel's buffered amount low threshold.
+ */
+enum rawrtc_code rawrtc_data_channel_get_buffered_amount_low_threshold(
+        uint64_t* const thresholdp, // de-referenced
+        struct rawrtc_data_channel* const channel
+) {
+    // Check arguments
+    if (!thresholdp || !channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set pointer & done
+    *thresholdp = channel->buffered_amount_low_threshold;
+    return RAWRTC_CODE_SUCCESS;
+}
+
 /*
  * Close the data channel.
  */
@@ -337,6 +449,88 @@ enum rawrtc_code rawrtc_data_channel_close(
     return channel->transport->channel_close(channel);
 }
 
+/*
+ * Send data via the data channel from any thread.
+ */
+enum rawrtc_code rawrtc_data_channel_send_async(
+        struct rawrtc_data_channel* const channel,
+        struct mbuf* const buffer, // nullable (if empty message), copied
+        bool const is_binary
+) {
+    struct rawrtc_command* command;
+    int err;
+    enum rawrtc_code error;
+
+    // Check arguments
+    if (!channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Create command
+    error = rawrtc_command_create(&command, RAWRTC_COMMAND_TYPE_DATA_CHANNEL_SEND);
+    if (error) {
+        return error;
+    }
+
+    // Set fields
+    command->channel = channel;
+    command->is_binary = is_binary;
+
+    // Copy data (if any)
+    // Note: The caller's buffer must not be referenced as its reference counter may be modified
+    //       concurrently.
+    if (buffer) {
+        command->buffer = mbuf_alloc(mbuf_get_left(buffer));
+        if (!command->buffer) {
+            error = RAWRTC_CODE_NO_MEMORY;
+            goto out;
+        }
+        err = mbuf_write_mem(command->buffer, mbuf_buf(buffer), mbuf_get_left(buffer));
+        if (err) {
+            error = rawrtc_error_to_code(err);
+            goto out;
+        }
+        mbuf_set_pos(command->buffer, 0);
+    }
+
+    // Post command & done
+    rawrtc_command_post(command);
+    return RAWRTC_CODE_SUCCESS;
+
+out:
+    // Un-reference
+    mem_deref(command);
+    return error;
+}
+
+/*
+ * Close the data channel from any thread.
+ */
+enum rawrtc_code rawrtc_data_channel_close_async(
+        struct rawrtc_data_channel* const channel
+) {
+    struct rawrtc_command* command;
+    enum rawrtc_code error;
+
+    // Check arguments
+    if (!channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Create command
+    error = rawrtc_command_create(&command, RAWRTC_COMMAND_TYPE_DATA_CHANNEL_CLOSE);
+    if (error) {
+        return error;
+    }
+
+    // Set fields
+    command->channel = channel;
+
+    // Post command & done
+    rawrtc_command_post(command);
+    return RAWRTC_CODE_SUCCESS;
+}
+
 /*
  * Unset the handler argument and all handlers of the data channel.
  */
@@ -353,6 +547,7 @@ enum rawrtc_code rawrtc_data_channel_unset_handlers(
 
     // Unset all handlers
     channel->message_handler = NULL;
+    channel->chained_message_handler = NULL;
     channel->close_handler = NULL;
     channel->error_handler = NULL;
     channel->buffered_amount_low_handler = NULL;
@@ -573,3 +768,42 @@ enum rawrtc_code rawrtc_data_channel_get_message_handler(
         return RAWRTC_CODE_NO_VALUE;
     }
 }
+
+/*
+ * Set the data channel's chained message handler.
+ */
+enum rawrtc_code rawrtc_data_channel_set_chained_message_handler(
+        struct rawrtc_data_channel* const channel,
+        rawrtc_data_channel_chained_message_handler* const message_handler // nullable
+) {
+    // Check arguments
+    if (!channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set chained message handler & done
+    channel->chained_message_handler = message_handler;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the data channel's chained message handler.
+ * Returns `RAWRTC_CODE_NO_VALUE` in case no handler has been set.
+ */
+enum rawrtc_code rawrtc_data_channel_get_chained_message_handler(
+        rawrtc_data_channel_chained_message_handler** const message_handlerp, // de-referenced
+        struct rawrtc_data_channel* const channel
+) {
+    // Check arguments
+    if (!message_handlerp || !channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Get chained message handler (if any)
+    if (channel->chained_message_handler) {
+        *message_handlerp = channel->chained_message_handler;
+        return RAWRTC_CODE_SUCCESS;
+    } else {
+        return RAWRTC_CODE_NO_VALUE;
+    }
+}
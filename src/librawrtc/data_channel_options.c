@@ -33,3 +33,21 @@ enum rawrtc_code rawrtc_data_channel_options_create(
     *optionsp = options;
     return RAWRTC_CODE_SUCCESS;
 }
+
+/*
+ * Set the maximum size of an inbound message that will be buffered
+ * until it is complete.
+ */
+enum rawrtc_code rawrtc_data_channel_options_set_max_message_size(
+        struct rawrtc_data_channel_options* const options,
+        uint64_t const max_message_size
+) {
+    // Check arguments
+    if (!options) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set maximum message size & done
+    options->max_message_size = max_message_size;
+    return RAWRTC_CODE_SUCCESS;
+}
@@ -41,6 +41,7 @@ enum rawrtc_code data_parameters_create(
     parameters->protocol = protocol;
     parameters->channel_type = channel_type;
     parameters->negotiated = negotiated;
+    parameters->priority = RAWRTC_DATA_CHANNEL_PRIORITY_NORMAL;
     if (negotiated) {
         parameters->id = id;
     }
@@ -192,3 +193,37 @@ enum rawrtc_code rawrtc_data_channel_parameters_get_protocol(
         return RAWRTC_CODE_NO_VALUE;
     }
 }
+
+/*
+ * Set the priority of the data channel parameters.
+ */
+enum rawrtc_code rawrtc_data_channel_parameters_set_priority(
+        struct rawrtc_data_channel_parameters* const parameters,
+        uint16_t const priority
+) {
+    // Check arguments
+    if (!parameters) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set value
+    parameters->priority = priority;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the priority from the data channel parameters.
+ */
+enum rawrtc_code rawrtc_data_channel_parameters_get_priority(
+        uint16_t* const priorityp, // de-referenced
+        struct rawrtc_data_channel_parameters* const parameters
+) {
+    // Check arguments
+    if (!priorityp || !parameters) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set value
+    *priorityp = parameters->priority;
+    return RAWRTC_CODE_SUCCESS;
+}
@@ -1,4 +1,10 @@
-#include <string.h> // memcmp
+#include <errno.h> // errno
+#include <string.h> // memcmp, strlen
+#include <sys/socket.h> // setsockopt, getsockopt
+#include <sys/ioctl.h> // ioctl, SIOCGIFMTU
+#include <net/if.h> // ifreq
+#include <ifaddrs.h> // getifaddrs, freeifaddrs
+#include <netinet/in.h> // IPPROTO_IP, IPPROTO_IPV6, IP_*, IPV6_*
 #include <rawrtc.h>
 #include "dtls_transport.h"
 #include "dtls_parameters.h"
@@ -6,12 +12,25 @@
 #include "candidate_helper.h"
 #include "certificate.h"
 #include "diffie_hellman_parameters.h"
+#include "ice_gatherer.h"
 #include "utils.h"
+#ifdef BATCHED_UDP_IO
+#include "udp_batch.h"
+#endif
 
 #define DEBUG_MODULE "dtls-transport"
 //#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
 #include "debug.h"
 
+static void path_mtu_start(
+    struct rawrtc_dtls_transport* const transport, // not checked
+    bool const reset
+);
+
+static void path_mtu_stop(
+    struct rawrtc_dtls_transport* const transport // not checked
+);
+
 /*
  * Embedded DH parameters in DER encoding (bits: 2048)
  */
@@ -130,6 +149,9 @@ static void set_state(
         // Remove connection
         transport->connection = mem_deref(transport->connection);
 
+        // Stop path MTU discovery
+        path_mtu_stop(transport);
+
         // Remove self from ICE transport (if attached)
         transport->ice_transport->dtls_transport = NULL;
     }
@@ -139,6 +161,9 @@ static void set_state(
 
     // Connected?
     if (state == RAWRTC_DTLS_TRANSPORT_STATE_CONNECTED) {
+        // Start path MTU discovery
+        path_mtu_start(transport, false);
+
         // Send buffered outgoing DTLS messages
         enum rawrtc_code const error = rawrtc_message_buffer_clear(
                 &transport->buffered_messages_out, dtls_outgoing_buffer_handler, transport);
@@ -430,47 +455,142 @@ static enum rawrtc_code do_connect(
 }
 
 /*
- * Handle outgoing DTLS messages.
+ * Invalidate the cached path (selected candidate pair, UDP socket and
+ * remote address).
  */
-static int send_handler(
-        struct tls_conn* tc,
-        struct sa const* original_destination,
-        struct mbuf* buffer,
-        void* arg
+static void path_invalidate(
+        struct rawrtc_dtls_transport* const transport // not checked
+) {
+    // Nothing cached?
+    if (!transport->path_candidate_pair) {
+        return;
+    }
+
+#ifdef BATCHED_UDP_IO
+    // Flush datagrams queued for the path
+    rawrtc_udp_batch_flush(transport->udp_batch);
+#endif
+
+    // Stop probing & remove path MTU probing helper (bound to the path's UDP socket)
+    path_mtu_stop(transport);
+    transport->path_mtu_udp_helper = mem_deref(transport->path_mtu_udp_helper);
+
+    // Un-reference & update counter
+    transport->path_candidate_pair = mem_deref(transport->path_candidate_pair);
+    transport->path_udp_socket = mem_deref(transport->path_udp_socket);
+    sa_init(&transport->path_remote_address, AF_UNSPEC);
+    ++transport->n_path_invalidations;
+}
+
+/*
+ * Get the selected candidate pair of the ICE transport.
+ * Return `NULL` in case there is none or the ICE transport has been
+ * stopped.
+ */
+static struct ice_candpair* get_selected_candidate_pair(
+        struct rawrtc_dtls_transport* const transport // not checked
 ) {
-    struct rawrtc_dtls_transport* const transport = arg;
     struct trice* const ice = transport->ice_transport->gatherer->ice;
-    bool closed = is_closed(transport);
-    (void) tc; (void) original_destination;
 
-    // Note: No need to check if closed as only non-application data may be sent if the
-    //       transport is already closed.
+    // Stopped?
+    if (!trice_checklist_isrunning(ice)) {
+        return NULL;
+    }
+
+    // Get selected candidate pair (if any)
+    return list_ledata(list_head(trice_validl(ice)));
+}
+
+/*
+ * Lookup the selected candidate pair and cache its UDP socket and
+ * remote address.
+ */
+static enum rawrtc_code path_lookup(
+        struct rawrtc_dtls_transport* const transport // not checked
+) {
+    struct trice* const ice = transport->ice_transport->gatherer->ice;
+    bool const closed = is_closed(transport);
+    struct ice_candpair* candidate_pair;
+    struct udp_sock* udp_socket;
 
     // Get selected candidate pair
-    struct ice_candpair* const candidate_pair = list_ledata(list_head(trice_validl(ice)));
+    candidate_pair = get_selected_candidate_pair(transport);
     if (!candidate_pair) {
         if (!closed) {
             DEBUG_WARNING("Cannot send message, no selected candidate pair\n");
         }
-        return ECONNRESET;
+        return RAWRTC_CODE_NO_VALUE;
     }
 
     // Get local candidate's UDP socket
     // TODO: What about TCP?
-    struct udp_sock* const udp_socket = trice_lcand_sock(ice, candidate_pair->lcand);
+    udp_socket = trice_lcand_sock(ice, candidate_pair->lcand);
     if (!udp_socket) {
         if (!closed) {
             DEBUG_WARNING("Cannot send message, selected candidate pair has no socket\n");
         }
-        return ECONNRESET;
+        return RAWRTC_CODE_NO_SOCKET;
+    }
+
+    // Cache path
+    DEBUG_PRINTF("Using path from %J to %J\n",
+                 &candidate_pair->lcand->attr.addr, &candidate_pair->rcand->attr.addr);
+    transport->path_candidate_pair = mem_ref(candidate_pair);
+    transport->path_udp_socket = mem_ref(udp_socket);
+    sa_cpy(&transport->path_remote_address, &candidate_pair->rcand->attr.addr);
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Handle outgoing DTLS messages.
+ */
+static int send_handler(
+        struct tls_conn* tc,
+        struct sa const* original_destination,
+        struct mbuf* buffer,
+        void* arg
+) {
+    struct rawrtc_dtls_transport* const transport = arg;
+    enum rawrtc_code error;
+    (void) tc; (void) original_destination;
+
+    // Note: No need to check if closed as only non-application data may be sent if the
+    //       transport is already closed.
+
+    // Lookup path (if not cached)
+    if (!transport->path_udp_socket) {
+        error = path_lookup(transport);
+        if (error) {
+            return ECONNRESET;
+        }
     }
 
+#ifdef BATCHED_UDP_IO
+    // Queue (if batching and not relayed)
+    // Note: Relayed datagrams need to pass the TURN client's UDP helper.
+    if (transport->udp_batch
+            && transport->path_candidate_pair->lcand->attr.type != ICE_CAND_TYPE_RELAY) {
+        DEBUG_PRINTF("Queueing DTLS message (%zu bytes) to %J\n",
+                     mbuf_get_left(buffer), &transport->path_remote_address);
+        error = rawrtc_udp_batch_send(
+                transport->udp_batch, transport->path_udp_socket,
+                &transport->path_remote_address, buffer);
+        if (error == RAWRTC_CODE_TRY_AGAIN_LATER) {
+            // Dropped (like a datagram exceeding the socket's send buffer)
+            return 0;
+        } else if (error) {
+            DEBUG_WARNING("Could not queue, reason: %s\n", rawrtc_code_to_str(error));
+            return ENOMEM;
+        }
+        return 0;
+    }
+#endif
+
     // Send
     // TODO: Is destination correct?
-    DEBUG_PRINTF("Sending DTLS message (%zu bytes) to %J (originally: %J) from %J\n",
-                 mbuf_get_left(buffer), &candidate_pair->rcand->attr.addr, original_destination,
-                 &candidate_pair->lcand->attr.addr);
-    int err = udp_send(udp_socket, &candidate_pair->rcand->attr.addr, buffer);
+    DEBUG_PRINTF("Sending DTLS message (%zu bytes) to %J (originally: %J)\n",
+                 mbuf_get_left(buffer), &transport->path_remote_address, original_destination);
+    int err = udp_send(transport->path_udp_socket, &transport->path_remote_address, buffer);
     if (err) {
         DEBUG_WARNING("Could not send, error: %m\n", err);
     }
@@ -484,9 +604,500 @@ static size_t mtu_handler(
         struct tls_conn* tc,
         void* arg
 ) {
-    (void) tc; (void) arg;
-    // TODO: Choose a sane value.
-    return 1400;
+    struct rawrtc_dtls_transport* const transport = arg;
+    (void) tc;
+
+    // Return confirmed path MTU
+    return transport->path_mtu;
+}
+
+/*
+ * Set the confirmed path MTU and notify the data transport (if any).
+ */
+static void path_mtu_set(
+        struct rawrtc_dtls_transport* const transport, // not checked
+        size_t const path_mtu
+) {
+    // Unchanged?
+    if (transport->path_mtu == path_mtu) {
+        return;
+    }
+
+    // Set path MTU
+    DEBUG_INFO("Path MTU changed from %zu to %zu\n", transport->path_mtu, path_mtu);
+    transport->path_mtu = path_mtu;
+
+    // Call handler (if any)
+    if (transport->path_mtu_handler) {
+        transport->path_mtu_handler(
+                path_mtu - RAWRTC_DTLS_TRANSPORT_RECORD_OVERHEAD, transport->receive_handler_arg);
+    }
+}
+
+/*
+ * Get the socket option that sets the "don't fragment" flag for an
+ * address family.
+ * Note: IP_PMTUDISC_PROBE sets the DF flag but ignores the kernel's path
+ *       MTU which is what packetization layer path MTU discovery
+ *       requires.
+ */
+static enum rawrtc_code path_mtu_get_dont_fragment_option(
+        int* const levelp, // de-referenced, not checked
+        int* const namep, // de-referenced, not checked
+        int* const valuep, // de-referenced, not checked
+        int const af
+) {
+    switch (af) {
+        case AF_INET:
+#if defined(IP_MTU_DISCOVER) && defined(IP_PMTUDISC_PROBE)
+            *levelp = IPPROTO_IP;
+            *namep = IP_MTU_DISCOVER;
+            *valuep = IP_PMTUDISC_PROBE;
+            return RAWRTC_CODE_SUCCESS;
+#elif defined(IP_DONTFRAG)
+            *levelp = IPPROTO_IP;
+            *namep = IP_DONTFRAG;
+            *valuep = 1;
+            return RAWRTC_CODE_SUCCESS;
+#else
+            return RAWRTC_CODE_NOT_IMPLEMENTED;
+#endif
+        case AF_INET6:
+#if defined(IPV6_MTU_DISCOVER) && defined(IPV6_PMTUDISC_PROBE)
+            *levelp = IPPROTO_IPV6;
+            *namep = IPV6_MTU_DISCOVER;
+            *valuep = IPV6_PMTUDISC_PROBE;
+            return RAWRTC_CODE_SUCCESS;
+#elif defined(IPV6_DONTFRAG)
+            *levelp = IPPROTO_IPV6;
+            *namep = IPV6_DONTFRAG;
+            *valuep = 1;
+            return RAWRTC_CODE_SUCCESS;
+#else
+            return RAWRTC_CODE_NOT_IMPLEMENTED;
+#endif
+        default:
+            return RAWRTC_CODE_UNSUPPORTED_PROTOCOL;
+    }
+}
+
+/*
+ * Set or clear the "don't fragment" flag on the path's UDP socket, so
+ * probes will not be fragmented (and falsely confirmed).
+ * Note: The socket is shared with ICE, TURN and DTLS, so the flag is
+ *       only set while a probe is in flight. Clearing it restores the
+ *       socket's previous setting.
+ */
+static enum rawrtc_code path_mtu_set_dont_fragment(
+        struct rawrtc_dtls_transport* const transport, // not checked
+        bool const enable
+) {
+    int const af = sa_af(&transport->path_remote_address);
+    int fd;
+    int level;
+    int name;
+    int option_value;
+    socklen_t length = sizeof(transport->path_mtu_socket_option);
+    enum rawrtc_code error;
+
+    // Nothing to do?
+    if (transport->path_mtu_dont_fragment == enable) {
+        return RAWRTC_CODE_SUCCESS;
+    }
+
+    // Get socket & option
+    fd = udp_sock_fd(transport->path_udp_socket, af);
+    if (fd == -1) {
+        return RAWRTC_CODE_NO_SOCKET;
+    }
+    error = path_mtu_get_dont_fragment_option(&level, &name, &option_value, af);
+    if (error) {
+        return error;
+    }
+
+    // Restore previous setting?
+    if (!enable) {
+        transport->path_mtu_dont_fragment = false;
+        if (setsockopt(fd, level, name, &transport->path_mtu_socket_option,
+                       sizeof(transport->path_mtu_socket_option))) {
+            return rawrtc_error_to_code(errno);
+        }
+        return RAWRTC_CODE_SUCCESS;
+    }
+
+    // Store previous setting & set flag
+    if (getsockopt(fd, level, name, &transport->path_mtu_socket_option, &length)) {
+        return rawrtc_error_to_code(errno);
+    }
+    if (setsockopt(fd, level, name, &option_value, sizeof(option_value))) {
+        return rawrtc_error_to_code(errno);
+    }
+    transport->path_mtu_dont_fragment = true;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the largest UDP payload the local interface of the path can
+ * carry.
+ * Return `RAWRTC_CODE_NO_VALUE` in case the interface could not be
+ * determined (e.g. the socket is bound to a wildcard address).
+ */
+static enum rawrtc_code path_mtu_get_interface_limit(
+        size_t* const limitp, // de-referenced, not checked
+        struct rawrtc_dtls_transport* const transport // not checked
+) {
+#if defined(SIOCGIFMTU)
+    int const af = sa_af(&transport->path_remote_address);
+    int const fd = udp_sock_fd(transport->path_udp_socket, af);
+    struct sa local;
+    struct ifaddrs* interfaces;
+    struct ifaddrs* interface;
+    struct ifreq request = {0};
+    size_t overhead;
+    enum rawrtc_code error = RAWRTC_CODE_NO_VALUE;
+
+    // Get local address
+    if (fd == -1 || udp_local_get(transport->path_udp_socket, &local) || sa_is_any(&local)) {
+        return RAWRTC_CODE_NO_VALUE;
+    }
+    overhead = (af == AF_INET6 ? 40 : 20) + 8;
+
+    // Find interface of the local address
+    if (getifaddrs(&interfaces)) {
+        return rawrtc_error_to_code(errno);
+    }
+    for (interface = interfaces; interface != NULL; interface = interface->ifa_next) {
+        struct sa address;
+        if (!interface->ifa_addr || sa_set_sa(&address, interface->ifa_addr)
+                || !sa_cmp(&address, &local, SA_ADDR)) {
+            continue;
+        }
+
+        // Get interface MTU
+        str_ncpy(request.ifr_name, interface->ifa_name, sizeof(request.ifr_name));
+        if (ioctl(fd, SIOCGIFMTU, &request) == 0 && (size_t) request.ifr_mtu > overhead) {
+            *limitp = (size_t) request.ifr_mtu - overhead;
+            error = RAWRTC_CODE_SUCCESS;
+        }
+        break;
+    }
+
+    // Free interface list & done
+    freeifaddrs(interfaces);
+    return error;
+#else
+    (void) limitp; (void) transport;
+    return RAWRTC_CODE_NOT_IMPLEMENTED;
+#endif
+}
+
+/*
+ * Handle received UDP messages and feed STUN responses into the probe
+ * transaction.
+ */
+static bool path_mtu_udp_receive_handler(
+        struct sa* source,
+        struct mbuf* buffer,
+        void* arg
+) {
+    struct rawrtc_dtls_transport* const transport = arg;
+    size_t const position = buffer->pos;
+    struct stun_msg* message;
+    struct stun_unknown_attr unknown_attributes;
+    bool handled = false;
+    (void) source;
+
+    // No probe in flight?
+    if (!transport->path_mtu_transaction) {
+        return false;
+    }
+
+    // Decode STUN message
+    if (stun_msg_decode(&message, buffer, &unknown_attributes)) {
+        buffer->pos = position;
+        return false;
+    }
+
+    // Hand out responses to the transaction
+    switch (stun_msg_class(message)) {
+        case STUN_CLASS_SUCCESS_RESP:
+        case STUN_CLASS_ERROR_RESP:
+            handled = stun_ctrans_recv(
+                    transport->path_mtu_stun, message, &unknown_attributes) == 0;
+            break;
+        default:
+            break;
+    }
+
+    // Un-reference & restore position (if not handled)
+    mem_deref(message);
+    if (!handled) {
+        buffer->pos = position;
+    }
+    return handled;
+}
+
+static void path_mtu_timer_handler(
+    void* arg
+);
+
+/*
+ * Handle probe response (or timeout).
+ * RFC 8899: A probe is considered lost after
+ * RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX_PROBES retransmissions.
+ */
+static void path_mtu_probe_response_handler(
+        int err,
+        uint16_t status_code,
+        char const* reason,
+        struct stun_msg const* message,
+        void* arg
+) {
+    struct rawrtc_dtls_transport* const transport = arg;
+    char const* const password = transport->ice_transport->remote_parameters->password;
+    size_t const probe_size = transport->path_mtu_probe_size;
+    (void) reason;
+
+    // Transaction completed
+    transport->path_mtu_transaction = NULL;
+    transport->path_mtu_probe_size = 0;
+
+    // Clear "don't fragment" flag (probe is no longer in flight)
+    path_mtu_set_dont_fragment(transport, false);
+
+    // Closed?
+    if (is_closed(transport)) {
+        return;
+    }
+
+    if (!err && status_code == 0 && message
+            && !stun_msg_chk_mi(message, (uint8_t*) password, strlen(password))) {
+        // Confirmed
+        DEBUG_PRINTF("Path MTU probe of %zu bytes confirmed\n", probe_size);
+        path_mtu_set(transport, probe_size);
+    } else if (err == ETIMEDOUT || err == EMSGSIZE) {
+        // Lost (or too large for the local interface)
+        DEBUG_PRINTF("Path MTU probe of %zu bytes lost\n", probe_size);
+        transport->path_mtu_search_high = probe_size - 4;
+    } else {
+        // Peer did not process the probe, give up until the raise timer fires
+        DEBUG_NOTICE("Path MTU probe of %zu bytes failed (%m, %"PRIu16"), stopping search\n",
+                     probe_size, err, status_code);
+        transport->path_mtu_search_high = transport->path_mtu;
+    }
+
+    // Continue search
+    tmr_start(&transport->path_mtu_timer, 0, path_mtu_timer_handler, transport);
+}
+
+/*
+ * Send a path MTU probe.
+ * The probe is a padded STUN binding request (RFC 5780, PADDING
+ * attribute) on the selected candidate pair which will only be
+ * confirmed if the peer received it in one piece.
+ */
+static enum rawrtc_code path_mtu_probe_send(
+        struct rawrtc_dtls_transport* const transport, // not checked
+        size_t const probe_size
+) {
+    struct rawrtc_ice_gatherer* const gatherer = transport->ice_transport->gatherer;
+    struct rawrtc_ice_parameters* const remote_parameters =
+            transport->ice_transport->remote_parameters;
+    char* username = NULL;
+    size_t username_length;
+    size_t overhead;
+    uint32_t priority;
+    struct mbuf* padding = NULL;
+    int err;
+    enum rawrtc_code error;
+
+    // Register UDP helper (if not registered)
+    if (!transport->path_mtu_udp_helper) {
+        error = rawrtc_error_to_code(udp_register_helper(
+                &transport->path_mtu_udp_helper, transport->path_udp_socket, RAWRTC_LAYER_STUN,
+                NULL, path_mtu_udp_receive_handler, transport));
+        if (error) {
+            return error;
+        }
+    }
+
+    // Create username
+    err = re_sdprintf(&username, "%s:%s",
+                      remote_parameters->username_fragment, gatherer->ice_username_fragment);
+    if (err) {
+        error = rawrtc_error_to_code(err);
+        goto out;
+    }
+
+    // Calculate padding
+    // Note: Header, USERNAME, PRIORITY, ICE-CONTROLLING/-CONTROLLED, MESSAGE-INTEGRITY,
+    //       FINGERPRINT and the PADDING attribute's header.
+    username_length = strlen(username);
+    overhead = STUN_HEADER_SIZE + (4 + ((username_length + 3) & ~(size_t) 3)) + 8 + 12 + 24 + 8 + 4;
+    if (probe_size < overhead) {
+        error = RAWRTC_CODE_INVALID_ARGUMENT;
+        goto out;
+    }
+    padding = mbuf_alloc(probe_size - overhead);
+    if (!padding) {
+        error = RAWRTC_CODE_NO_MEMORY;
+        goto out;
+    }
+    err = mbuf_fill(padding, 0, probe_size - overhead);
+    if (err) {
+        error = rawrtc_error_to_code(err);
+        goto out;
+    }
+    mbuf_set_pos(padding, 0);
+
+    // Set "don't fragment" flag (while the probe is in flight)
+    error = path_mtu_set_dont_fragment(transport, true);
+    if (error) {
+        DEBUG_NOTICE("Cannot set DF flag on socket, reason: %s\n", rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Send binding request
+    priority = transport->path_candidate_pair->lcand->attr.prio;
+    DEBUG_PRINTF("Sending path MTU probe of %zu bytes\n", probe_size);
+    transport->path_mtu_probe_size = probe_size;
+    err = stun_request(
+            &transport->path_mtu_transaction, transport->path_mtu_stun, IPPROTO_UDP,
+            transport->path_udp_socket, &transport->path_remote_address, 0, STUN_METHOD_BINDING,
+            (uint8_t*) remote_parameters->password, strlen(remote_parameters->password), true,
+            path_mtu_probe_response_handler, transport, 4,
+            STUN_ATTR_USERNAME, username,
+            STUN_ATTR_PRIORITY, &priority,
+            trice_local_role(gatherer->ice) == ICE_ROLE_CONTROLLING ?
+                    STUN_ATTR_CONTROLLING : STUN_ATTR_CONTROLLED, &transport->path_mtu_tiebreaker,
+            STUN_ATTR_PADDING, padding);
+    if (err) {
+        transport->path_mtu_probe_size = 0;
+        path_mtu_set_dont_fragment(transport, false);
+        error = rawrtc_error_to_code(err);
+        goto out;
+    }
+
+    // Done
+    error = RAWRTC_CODE_SUCCESS;
+
+out:
+    // Un-reference
+    mem_deref(padding);
+    mem_deref(username);
+    return error;
+}
+
+/*
+ * Handle probe timer: Probe the next size or wait for the raise timer.
+ * Search algorithm: Binary search between the confirmed path MTU and
+ * the largest size that has not been found to be lost.
+ */
+static void path_mtu_timer_handler(
+        void* arg
+) {
+    struct rawrtc_dtls_transport* const transport = arg;
+    size_t probe_size;
+    size_t limit;
+    enum rawrtc_code error;
+
+    // Closed?
+    if (is_closed(transport)) {
+        return;
+    }
+
+    // Search complete? Raise the search limit again later.
+    if (transport->path_mtu_search_high
+            < transport->path_mtu + RAWRTC_DTLS_TRANSPORT_PATH_MTU_SEARCH_GRANULARITY) {
+        DEBUG_PRINTF("Path MTU search complete, path MTU: %zu\n", transport->path_mtu);
+        transport->path_mtu_search_high = RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX;
+        tmr_start(&transport->path_mtu_timer, RAWRTC_DTLS_TRANSPORT_PATH_MTU_RAISE_TIMEOUT,
+                  path_mtu_timer_handler, transport);
+        return;
+    }
+
+    // Lookup path (if not cached)
+    if (!transport->path_udp_socket) {
+        error = path_lookup(transport);
+        if (error) {
+            goto retry;
+        }
+    }
+
+    // Limit a new search to the MTU of the local interface (if known)
+    if (transport->path_mtu_search_high == RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX &&
+            path_mtu_get_interface_limit(&limit, transport) == RAWRTC_CODE_SUCCESS &&
+            limit < transport->path_mtu_search_high) {
+        DEBUG_PRINTF("Limiting path MTU search to %zu bytes (interface MTU)\n", limit);
+        transport->path_mtu_search_high = limit;
+        if (limit < transport->path_mtu + RAWRTC_DTLS_TRANSPORT_PATH_MTU_SEARCH_GRANULARITY) {
+            tmr_start(&transport->path_mtu_timer, 0, path_mtu_timer_handler, transport);
+            return;
+        }
+    }
+
+    // Calculate probe size (aligned to 4 bytes)
+    probe_size = (transport->path_mtu + transport->path_mtu_search_high + 1) / 2;
+    probe_size &= ~(size_t) 3;
+    if (probe_size <= transport->path_mtu) {
+        probe_size = transport->path_mtu + 4;
+    }
+
+    // Send probe
+    error = path_mtu_probe_send(transport, probe_size);
+    switch (error) {
+        case RAWRTC_CODE_SUCCESS:
+            return;
+        case RAWRTC_CODE_MESSAGE_TOO_LONG:
+            // Too large for the local interface: Treat as lost and continue search
+            DEBUG_PRINTF("Path MTU probe of %zu bytes too large to send\n", probe_size);
+            transport->path_mtu_search_high = probe_size - 4;
+            tmr_start(&transport->path_mtu_timer, 0, path_mtu_timer_handler, transport);
+            return;
+        default:
+            goto retry;
+    }
+
+retry:
+    DEBUG_NOTICE("Could not send path MTU probe, reason: %s\n", rawrtc_code_to_str(error));
+    tmr_start(&transport->path_mtu_timer, RAWRTC_DTLS_TRANSPORT_PATH_MTU_RAISE_TIMEOUT,
+              path_mtu_timer_handler, transport);
+}
+
+/*
+ * Start (or restart) path MTU discovery.
+ * In case `reset` is set, the path MTU will fall back to the base
+ * path MTU (e.g. because the path changed).
+ */
+static void path_mtu_start(
+        struct rawrtc_dtls_transport* const transport, // not checked
+        bool const reset
+) {
+    // Cancel pending probe
+    path_mtu_stop(transport);
+
+    // Reset path MTU (if requested)
+    if (reset) {
+        path_mtu_set(transport, RAWRTC_DTLS_TRANSPORT_PATH_MTU_BASE);
+    }
+
+    // Search from the confirmed path MTU to the maximum
+    transport->path_mtu_search_high = RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX;
+    tmr_start(&transport->path_mtu_timer, 0, path_mtu_timer_handler, transport);
+}
+
+/*
+ * Stop path MTU discovery.
+ */
+static void path_mtu_stop(
+        struct rawrtc_dtls_transport* const transport // not checked
+) {
+    tmr_cancel(&transport->path_mtu_timer);
+    transport->path_mtu_transaction = mem_deref(transport->path_mtu_transaction);
+    transport->path_mtu_probe_size = 0;
+    if (transport->path_udp_socket) {
+        path_mtu_set_dont_fragment(transport, false);
+    }
 }
 
 /*
@@ -494,11 +1105,10 @@ static size_t mtu_handler(
  */
 static bool udp_receive_handler(
         struct mbuf* const buffer,
-        void* const context,
+        struct sa* const source,
         void* const arg
 ) {
     struct rawrtc_dtls_transport* const transport = arg;
-    struct sa* source = context;
     struct sa const* peer;
 
     // TODO: Check if DTLS or SRTP packet
@@ -570,17 +1180,48 @@ static void rawrtc_dtls_transport_destroy(
     }
 
     // Un-reference
+    path_mtu_stop(transport);
+    mem_deref(transport->path_mtu_udp_helper);
+    mem_deref(transport->path_mtu_stun);
+    mem_deref(transport->path_udp_socket);
+    mem_deref(transport->path_candidate_pair);
     mem_deref(transport->connection);
+    mem_deref(transport->udp_batch);
     mem_deref(transport->socket);
     mem_deref(transport->context);
     list_flush(&transport->fingerprints);
-    list_flush(&transport->buffered_messages_out);
-    list_flush(&transport->buffered_messages_in);
+    rawrtc_message_buffer_flush(&transport->buffered_messages_out);
+    rawrtc_message_buffer_flush(&transport->buffered_messages_in);
     mem_deref(transport->remote_parameters);
     list_flush(&transport->certificates);
     mem_deref(transport->ice_transport);
 }
 
+/*
+ * Default limits of the incoming and outgoing message buffers.
+ * Note: Buffered messages are SCTP packets, so dropping the oldest
+ *       ones is recovered by SCTP retransmissions.
+ */
+static struct rawrtc_message_buffer_limits const default_buffer_limits = {
+    .max_size = RAWRTC_DTLS_TRANSPORT_DEFAULT_BUFFER_MAX_SIZE,
+    .max_messages = RAWRTC_DTLS_TRANSPORT_DEFAULT_BUFFER_MAX_MESSAGES,
+    .max_age = RAWRTC_DTLS_TRANSPORT_DEFAULT_BUFFER_MAX_AGE,
+    .policy = RAWRTC_MESSAGE_BUFFER_POLICY_DROP_OLDEST,
+};
+
+/*
+ * STUN configuration for path MTU probes.
+ * Note: A probe is considered lost after the maximum amount of
+ *       retransmissions.
+ */
+static struct stun_conf const path_mtu_stun_configuration = {
+    .rto = RAWRTC_DTLS_TRANSPORT_PATH_MTU_PROBE_TIMEOUT,
+    .rc = RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX_PROBES,
+    .rm = 4,
+    .ti = 39500,
+    .tos = 0,
+};
+
 /*
  * Create a new DTLS transport (internal)
  */
@@ -634,9 +1275,29 @@ enum rawrtc_code rawrtc_dtls_transport_create_internal(
     transport->arg = arg;
     transport->role = RAWRTC_DTLS_ROLE_AUTO;
     transport->connection_established = false;
-    list_init(&transport->buffered_messages_in);
-    list_init(&transport->buffered_messages_out);
+    rawrtc_message_buffer_init(&transport->buffered_messages_in);
+    rawrtc_message_buffer_init(&transport->buffered_messages_out);
+    rawrtc_message_buffer_set_limits(&transport->buffered_messages_in, &default_buffer_limits);
+    rawrtc_message_buffer_set_limits(&transport->buffered_messages_out, &default_buffer_limits);
     list_init(&transport->fingerprints);
+    transport->path_mtu = RAWRTC_DTLS_TRANSPORT_PATH_MTU_BASE;
+    tmr_init(&transport->path_mtu_timer);
+    transport->path_mtu_tiebreaker = rand_u64();
+
+    // Create STUN instance for path MTU probes
+    error = rawrtc_error_to_code(stun_alloc(
+            &transport->path_mtu_stun, &path_mtu_stun_configuration, NULL, NULL));
+    if (error) {
+        goto out;
+    }
+
+#ifdef BATCHED_UDP_IO
+    // Create outgoing datagram batch
+    error = rawrtc_udp_batch_create(&transport->udp_batch);
+    if (error) {
+        goto out;
+    }
+#endif
 
     // Create (D)TLS context
     DEBUG_PRINTF("Creating DTLS context\n");
@@ -789,8 +1450,8 @@ enum rawrtc_code rawrtc_dtls_transport_add_candidate_pair(
     }
 
     // Receive buffered packets
-    error = rawrtc_message_buffer_clear(
-            &transport->ice_transport->gatherer->buffered_messages, udp_receive_handler, transport);
+    error = rawrtc_ice_gatherer_early_packets_clear(
+            transport->ice_transport->gatherer, udp_receive_handler, transport);
     if (error) {
         DEBUG_WARNING("Could not handle buffered packets on candidate pair, reason: %s\n",
                       rawrtc_code_to_str(error));
@@ -1022,6 +1683,7 @@ enum rawrtc_code rawrtc_dtls_transport_clear_data_transport(
 
     // Clear handler and argument
     transport->receive_handler = NULL;
+    transport->path_mtu_handler = NULL;
     transport->receive_handler_arg = NULL;
 
     // Done
@@ -1088,6 +1750,145 @@ enum rawrtc_code rawrtc_dtls_transport_stop(
     // TODO: Anything missing?
 }
 
+/*
+ * Notify the DTLS transport that the selected candidate pair may have
+ * changed. The cached path will be invalidated if the selected
+ * candidate pair differs from the cached one.
+ */
+enum rawrtc_code rawrtc_dtls_transport_candidate_pair_change(
+        struct rawrtc_dtls_transport* const transport
+) {
+    struct ice_candpair* candidate_pair;
+
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Invalidate path (if the selected candidate pair changed)
+    candidate_pair = get_selected_candidate_pair(transport);
+    if (candidate_pair != transport->path_candidate_pair) {
+        DEBUG_PRINTF("Selected candidate pair changed, invalidating path\n");
+        path_invalidate(transport);
+
+        // Restart path MTU discovery (if connected and there is a new path)
+        if (candidate_pair && transport->state == RAWRTC_DTLS_TRANSPORT_STATE_CONNECTED) {
+            path_mtu_start(transport, true);
+        }
+    }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Set the path MTU handler of the data transport. The handler will be
+ * called with the amount of bytes available for a single data
+ * transport packet whenever the path MTU changes.
+ * Note: The handler's argument is the data transport's argument.
+ */
+enum rawrtc_code rawrtc_dtls_transport_set_path_mtu_handler(
+        struct rawrtc_dtls_transport* const transport,
+        rawrtc_dtls_transport_path_mtu_handler* const path_mtu_handler // nullable
+) {
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set handler
+    transport->path_mtu_handler = path_mtu_handler;
+
+    // Call handler with the current path MTU (if any)
+    if (path_mtu_handler) {
+        path_mtu_handler(
+                transport->path_mtu - RAWRTC_DTLS_TRANSPORT_RECORD_OVERHEAD,
+                transport->receive_handler_arg);
+    }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the confirmed path MTU (maximum UDP payload size) of the DTLS
+ * transport.
+ */
+enum rawrtc_code rawrtc_dtls_transport_get_path_mtu(
+        size_t* const path_mtup, // de-referenced
+        struct rawrtc_dtls_transport* const transport
+) {
+    // Check arguments
+    if (!path_mtup || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set path MTU & done
+    *path_mtup = transport->path_mtu;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Set the limits of the DTLS transport's incoming and outgoing message
+ * buffers.
+ */
+enum rawrtc_code rawrtc_dtls_transport_set_buffer_limits(
+        struct rawrtc_dtls_transport* const transport,
+        struct rawrtc_message_buffer_limits const* const limits // copied
+) {
+    // Check arguments
+    if (!transport || !limits) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set limits & done
+    rawrtc_message_buffer_set_limits(&transport->buffered_messages_in, limits);
+    rawrtc_message_buffer_set_limits(&transport->buffered_messages_out, limits);
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the statistics of the DTLS transport's incoming and outgoing
+ * message buffers.
+ */
+enum rawrtc_code rawrtc_dtls_transport_get_buffer_stats(
+        struct rawrtc_message_buffer_stats* const inboundp, // de-referenced, nullable
+        struct rawrtc_message_buffer_stats* const outboundp, // de-referenced, nullable
+        struct rawrtc_dtls_transport* const transport
+) {
+    // Check arguments
+    if ((!inboundp && !outboundp) || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set statistics & done
+    if (inboundp) {
+        rawrtc_message_buffer_get_stats(inboundp, &transport->buffered_messages_in);
+    }
+    if (outboundp) {
+        rawrtc_message_buffer_get_stats(outboundp, &transport->buffered_messages_out);
+    }
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the amount of times the cached path (selected candidate pair)
+ * of the DTLS transport has been invalidated.
+ */
+enum rawrtc_code rawrtc_dtls_transport_get_path_invalidations(
+        uint64_t* const countp, // de-referenced
+        struct rawrtc_dtls_transport* const transport
+) {
+    // Check arguments
+    if (!countp || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set count & done
+    *countp = transport->n_path_invalidations;
+    return RAWRTC_CODE_SUCCESS;
+}
+
 /*
  * Get the current state of the DTLS transport.
  */
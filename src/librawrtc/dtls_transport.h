@@ -1,5 +1,28 @@
 #pragma once
 
+/*
+ * Path MTU discovery (RFC 8899) constants.
+ * Sizes refer to the UDP payload (DTLS records).
+ */
+enum {
+    RAWRTC_DTLS_TRANSPORT_PATH_MTU_BASE = 1200,
+    RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX = 8972,
+    RAWRTC_DTLS_TRANSPORT_PATH_MTU_SEARCH_GRANULARITY = 16,
+    RAWRTC_DTLS_TRANSPORT_PATH_MTU_PROBE_TIMEOUT = 500,
+    RAWRTC_DTLS_TRANSPORT_PATH_MTU_MAX_PROBES = 3,
+    RAWRTC_DTLS_TRANSPORT_PATH_MTU_RAISE_TIMEOUT = 600000,
+    RAWRTC_DTLS_TRANSPORT_RECORD_OVERHEAD = 64,
+};
+
+/*
+ * Default limits of the incoming and outgoing message buffers.
+ */
+enum {
+    RAWRTC_DTLS_TRANSPORT_DEFAULT_BUFFER_MAX_SIZE = 262144,
+    RAWRTC_DTLS_TRANSPORT_DEFAULT_BUFFER_MAX_MESSAGES = 256,
+    RAWRTC_DTLS_TRANSPORT_DEFAULT_BUFFER_MAX_AGE = 30000,
+};
+
 enum rawrtc_code rawrtc_dtls_transport_create_internal(
     struct rawrtc_dtls_transport** const transportp, // de-referenced
     struct rawrtc_ice_transport* const ice_transport, // referenced
@@ -14,6 +37,10 @@ enum rawrtc_code rawrtc_dtls_transport_add_candidate_pair(
     struct ice_candpair* const candidate_pair
 );
 
+enum rawrtc_code rawrtc_dtls_transport_candidate_pair_change(
+    struct rawrtc_dtls_transport* const transport
+);
+
 enum rawrtc_code rawrtc_dtls_transport_have_data_transport(
     bool* const have_data_transportp, // de-referenced
     struct rawrtc_dtls_transport* const transport
@@ -25,6 +52,11 @@ enum rawrtc_code rawrtc_dtls_transport_set_data_transport(
     void* const arg
 );
 
+enum rawrtc_code rawrtc_dtls_transport_set_path_mtu_handler(
+    struct rawrtc_dtls_transport* const transport,
+    rawrtc_dtls_transport_path_mtu_handler* const path_mtu_handler // nullable
+);
+
 enum rawrtc_code rawrtc_dtls_transport_clear_data_transport(
     struct rawrtc_dtls_transport* const transport
 );
@@ -1,10 +1,8 @@
 #include <sys/socket.h> // AF_INET, AF_INET6
 #include <netinet/in.h> // IPPROTO_UDP, IPPROTO_TCP
-#include <string.h> // memcpy
 #include <rawrtc.h>
 #include "utils.h"
 #include "ice_candidate.h"
-#include "message_buffer.h"
 #include "candidate_helper.h"
 #include "ice_server.h"
 #include "ice_gather_options.h"
@@ -35,6 +33,23 @@ char const * const rawrtc_ice_gatherer_state_to_name(
     }
 }
 
+/*
+ * Remove and un-reference all buffered early packets.
+ */
+static void early_packets_flush(
+        struct rawrtc_ice_gatherer* const gatherer // not checked
+) {
+    while (gatherer->early_packets_count > 0) {
+        struct rawrtc_ice_gatherer_early_packet* const packet =
+                &gatherer->early_packets[gatherer->early_packets_head];
+        packet->buffer = mem_deref(packet->buffer);
+        gatherer->early_packets_head =
+                (gatherer->early_packets_head + 1) % gatherer->early_packets_capacity;
+        --gatherer->early_packets_count;
+    }
+    gatherer->early_packets_head = 0;
+}
+
 /*
  * Destructor for an existing ICE gatherer.
  */
@@ -51,7 +66,8 @@ static void rawrtc_ice_gatherer_destroy(
     mem_deref(gatherer->dns_client);
     mem_deref(gatherer->ice);
     list_flush(&gatherer->local_candidates);
-    list_flush(&gatherer->buffered_messages);
+    early_packets_flush(gatherer);
+    mem_deref(gatherer->early_packets);
     mem_deref(gatherer->options);
 }
 
@@ -90,7 +106,7 @@ enum rawrtc_code rawrtc_ice_gatherer_create(
     gatherer->error_handler = error_handler;
     gatherer->local_candidate_handler = local_candidate_handler;
     gatherer->arg = arg;
-    list_init(&gatherer->buffered_messages);
+    gatherer->early_packets_capacity = RAWRTC_ICE_GATHERER_DEFAULT_EARLY_PACKETS_CAPACITY;
     list_init(&gatherer->local_candidates);
 
     // Generate random username fragment and password for ICE
@@ -208,6 +224,7 @@ enum rawrtc_code rawrtc_ice_gatherer_close(
 
 /*
  * Handle received UDP messages.
+ * Buffers the packet until a DTLS transport has been attached.
  */
 static bool udp_receive_handler(
         struct sa * source,
@@ -215,35 +232,77 @@ static bool udp_receive_handler(
         void* arg
 ) {
     struct rawrtc_ice_gatherer* const gatherer = arg;
-    enum rawrtc_code error;
+    struct rawrtc_ice_gatherer_early_packet* packet;
 
-    // Allocate context and copy source address
-    void* const context = mem_zalloc(sizeof(*source), NULL);
-    if (!context) {
-        error = RAWRTC_CODE_NO_MEMORY;
-        goto out;
+    // Drop if full
+    if (gatherer->early_packets_count == gatherer->early_packets_capacity) {
+        ++gatherer->n_early_packets_dropped;
+        DEBUG_NOTICE("Dropped UDP packet of size %zu, buffer full\n", mbuf_get_left(buffer));
+        return true;
     }
-    memcpy(context, source, sizeof(*source));
 
-    // Buffer message
-    error = rawrtc_message_buffer_append(&gatherer->buffered_messages, buffer, context);
-    if (error) {
-        goto out;
+    // Allocate ring (if not already allocated)
+    if (!gatherer->early_packets) {
+        gatherer->early_packets = mem_zalloc(
+                gatherer->early_packets_capacity * sizeof(*gatherer->early_packets), NULL);
+        if (!gatherer->early_packets) {
+            DEBUG_WARNING("Could not buffer UDP packet, reason: %s\n",
+                          rawrtc_code_to_str(RAWRTC_CODE_NO_MEMORY));
+            return true;
+        }
     }
 
+    // Buffer packet
+    packet = &gatherer->early_packets[
+            (gatherer->early_packets_head + gatherer->early_packets_count)
+            % gatherer->early_packets_capacity];
+    sa_cpy(&packet->source, source);
+    packet->buffer = mem_ref(buffer);
+    ++gatherer->early_packets_count;
+
     // Done
     DEBUG_PRINTF("Buffered UDP packet of size %zu\n", mbuf_get_left(buffer));
 
-out:
-    if (error) {
-        DEBUG_WARNING("Could not buffer UDP packet, reason: %s\n", rawrtc_code_to_str(error));
+    // Handled
+    return true;
+}
+
+/*
+ * Apply a packet handler to buffered early packets.
+ *
+ * Will stop iterating and return `RAWRTC_CODE_STOP_ITERATION` in case
+ * the packet handler returned `false`.
+ */
+enum rawrtc_code rawrtc_ice_gatherer_early_packets_clear(
+        struct rawrtc_ice_gatherer* const gatherer,
+        rawrtc_ice_gatherer_early_packet_handler* const packet_handler,
+        void* const arg
+) {
+    // Check arguments
+    if (!gatherer || !packet_handler) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Un-reference
-    mem_deref(context);
+    // Handle each packet
+    while (gatherer->early_packets_count > 0) {
+        struct rawrtc_ice_gatherer_early_packet* const packet =
+                &gatherer->early_packets[gatherer->early_packets_head];
 
-    // Handled
-    return true;
+        // Handle packet
+        if (!packet_handler(packet->buffer, &packet->source, arg)) {
+            return RAWRTC_CODE_STOP_ITERATION;
+        }
+
+        // Remove packet
+        packet->buffer = mem_deref(packet->buffer);
+        gatherer->early_packets_head =
+                (gatherer->early_packets_head + 1) % gatherer->early_packets_capacity;
+        --gatherer->early_packets_count;
+    }
+
+    // Done
+    gatherer->early_packets_head = 0;
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
@@ -1158,3 +1217,45 @@ out:
     }
     return error;
 }
+
+/*
+ * Set the maximum amount of packets the ICE gatherer buffers until a
+ * DTLS transport has been attached.
+ */
+enum rawrtc_code rawrtc_ice_gatherer_set_early_packets_capacity(
+        struct rawrtc_ice_gatherer* const gatherer,
+        uint32_t const capacity
+) {
+    // Check arguments
+    if (!gatherer) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Check state
+    if (gatherer->early_packets_count > 0) {
+        return RAWRTC_CODE_INVALID_STATE;
+    }
+
+    // Set capacity (ring will be re-allocated lazily)
+    gatherer->early_packets = mem_deref(gatherer->early_packets);
+    gatherer->early_packets_capacity = capacity;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the amount of packets the ICE gatherer dropped because its early
+ * packet buffer was full.
+ */
+enum rawrtc_code rawrtc_ice_gatherer_get_early_packets_dropped(
+        uint64_t* const countp, // de-referenced
+        struct rawrtc_ice_gatherer* const gatherer
+) {
+    // Check arguments
+    if (!countp || !gatherer) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set count
+    *countp = gatherer->n_early_packets_dropped;
+    return RAWRTC_CODE_SUCCESS;
+}
@@ -1,9 +1,28 @@
 #pragma once
 
 enum {
-    RAWRTC_ICE_GATHERER_DNS_SERVERS = 10
+    RAWRTC_ICE_GATHERER_DNS_SERVERS = 10,
+    RAWRTC_ICE_GATHERER_DEFAULT_EARLY_PACKETS_CAPACITY = 64
 };
 
+/*
+ * Handle a packet received before a DTLS transport has been attached.
+ *
+ * Return `true` if the packet has been handled and can be removed,
+ * `false` to stop processing packets and keep the current packet.
+ */
+typedef bool (rawrtc_ice_gatherer_early_packet_handler)(
+    struct mbuf* const buffer,
+    struct sa* const source,
+    void* const arg
+);
+
+enum rawrtc_code rawrtc_ice_gatherer_early_packets_clear(
+    struct rawrtc_ice_gatherer* const gatherer,
+    rawrtc_ice_gatherer_early_packet_handler* const packet_handler,
+    void* const arg
+);
+
 enum rawrtc_code rawrtc_ice_server_url_dns_context_create(
     struct rawrtc_ice_server_url_dns_context** const contextp,
     uint_fast16_t const dns_type,
@@ -161,6 +161,11 @@ static void ice_established_handler(
         }
     }
 
+    // Notify DTLS transport (selected candidate pair may have changed)
+    if (transport->dtls_transport) {
+        rawrtc_dtls_transport_candidate_pair_change(transport->dtls_transport);
+    }
+
     // TODO: Call candidate_pair_change_handler (?)
 
     // Completed all candidate pairs?
@@ -195,6 +200,11 @@ static void ice_failed_handler(
         return;
     }
 
+    // Notify DTLS transport (selected candidate pair may have changed)
+    if (transport->dtls_transport) {
+        rawrtc_dtls_transport_candidate_pair_change(transport->dtls_transport);
+    }
+
     // Ignore if completed
     // Note: This case can happen when the checklist is completed but an ICE candidate triggers
     //       a late failed event.
@@ -341,6 +351,11 @@ enum rawrtc_code rawrtc_ice_transport_stop(
         trice_checklist_stop(transport->gatherer->ice);
     }
 
+    // Notify DTLS transport (drops the cached path and its UDP socket)
+    if (transport->dtls_transport) {
+        rawrtc_dtls_transport_candidate_pair_change(transport->dtls_transport);
+    }
+
     // TODO: Remove remote candidates, role, username fragment and password from rew
 
     // TODO: Remove from RTCICETransportController (once we have it)
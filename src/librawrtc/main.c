@@ -2,6 +2,7 @@
 #include <strings.h>
 #include <rawrtc.h>
 #include "main.h"
+#include "buffer_pool.h"
 
 #define DEBUG_MODULE "rawrtc-main"
 //#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
@@ -15,6 +16,7 @@ struct rawrtc_global rawrtc_global;
  */
 enum rawrtc_code rawrtc_init() {
     int err;
+    enum rawrtc_code error;
     pthread_mutexattr_t mutex_attribute;
 
     // Initialise re
@@ -51,6 +53,24 @@ enum rawrtc_code rawrtc_init() {
 
     tmr_init (&rawrtc_global.usrsctp_tick_timer);
 
+    // Create library-wide buffer pool
+    error = rawrtc_buffer_pool_create(
+            &rawrtc_global.buffer_pool, RAWRTC_BUFFER_POOL_DEFAULT_MIN_SIZE,
+            RAWRTC_BUFFER_POOL_DEFAULT_MAX_SIZE, RAWRTC_BUFFER_POOL_DEFAULT_CLASS_CAPACITY);
+    if (error) {
+        DEBUG_WARNING("Failed to create buffer pool, reason: %s\n", rawrtc_code_to_str(error));
+        return error;
+    }
+
+    // Initialise command queue
+    error = rawrtc_command_queue_init(&rawrtc_global.command_queue);
+    if (error) {
+        DEBUG_WARNING("Failed to initialise command queue, reason: %s\n",
+                      rawrtc_code_to_str(error));
+        rawrtc_global.buffer_pool = mem_deref(rawrtc_global.buffer_pool);
+        return error;
+    }
+
     // Done
     return RAWRTC_CODE_SUCCESS;
 }
@@ -63,6 +83,12 @@ enum rawrtc_code rawrtc_close() {
 
     // TODO: Close usrsctp if initialised
 
+    // Close command queue
+    rawrtc_command_queue_close(&rawrtc_global.command_queue);
+
+    // Un-reference buffer pool
+    rawrtc_global.buffer_pool = mem_deref(rawrtc_global.buffer_pool);
+
     // Destroy mutex
     err = pthread_mutex_destroy(&rawrtc_global.mutex);
     if (err) {
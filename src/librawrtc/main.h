@@ -1,8 +1,11 @@
 #pragma once
 #include <rawrtc.h>
+#include "command_queue.h"
 
 /*
  * Global rawrtc vars.
+ * Note: These are process-wide as usrsctp only provides a single stack
+ *       instance per process (which is shared by all SCTP transports).
  */
 struct rawrtc_global {
     pthread_mutex_t mutex;
@@ -10,7 +13,13 @@ struct rawrtc_global {
     uint_fast16_t mutex_counter;
     uint_fast32_t usrsctp_initialized;
     struct tmr usrsctp_tick_timer;
+    uint64_t usrsctp_tick_time;
+    uint32_t usrsctp_tick_timeout;
+    uint64_t usrsctp_tick_activity_time;
+    struct list usrsctp_transports;
     size_t usrsctp_chunk_size;
+    struct rawrtc_buffer_pool* buffer_pool;
+    struct rawrtc_command_queue command_queue;
 };
 
 extern struct rawrtc_global rawrtc_global;
@@ -1,4 +1,6 @@
+#include <string.h> // memset
 #include <rawrtc.h>
+#include "buffer_pool.h"
 #include "message_buffer.h"
 
 #define DEBUG_MODULE "message-buffer"
@@ -6,22 +8,93 @@
 #include "debug.h"
 
 /*
- * Get the sum of bytes of all message buffer's left.
+ * Unlink a buffered message from the message buffer and update the
+ * message buffer's counters.
  */
-size_t buffer_sum_left(
-        struct list* const message_buffer // not checked
+static void message_buffer_unlink(
+        struct rawrtc_message_buffer* const message_buffer, // not checked
+        struct rawrtc_buffered_message* const buffered_message // not checked
 ) {
-    struct le* le;
-    size_t size = 0;
+    list_unlink(&buffered_message->le);
+    message_buffer->size -= buffered_message->size;
+    --message_buffer->n_messages;
+}
 
-    // Handle each message
-    for (le = list_head(message_buffer); le != NULL; le = le->next) {
-        struct rawrtc_buffered_message* const buffered_message = le->data;
-        size += mbuf_get_left(buffered_message->buffer);
+/*
+ * Remove and un-reference the oldest buffered message.
+ */
+static void message_buffer_remove_oldest(
+        struct rawrtc_message_buffer* const message_buffer // not checked
+) {
+    struct rawrtc_buffered_message* const buffered_message =
+            list_ledata(list_head(&message_buffer->messages));
+    message_buffer_unlink(message_buffer, buffered_message);
+    mem_deref(buffered_message);
+}
+
+static void message_buffer_expire_timer_handler(
+    void* arg
+);
+
+/*
+ * Remove buffered messages that exceeded the maximum age and schedule
+ * the expiry of the (new) oldest message, so messages also expire
+ * while the message buffer is idle.
+ */
+static void message_buffer_expire(
+        struct rawrtc_message_buffer* const message_buffer // not checked
+) {
+    uint64_t now;
+    struct rawrtc_buffered_message* buffered_message;
+
+    // Expiring?
+    if (message_buffer->limits.max_age == 0) {
+        tmr_cancel(&message_buffer->expire_timer);
+        return;
     }
 
-    // Done
-    return size;
+    // Remove messages that are too old (oldest first)
+    now = tmr_jiffies();
+    while (message_buffer->n_messages > 0) {
+        buffered_message = list_ledata(list_head(&message_buffer->messages));
+        if (now - buffered_message->timestamp <= message_buffer->limits.max_age) {
+            break;
+        }
+        message_buffer_remove_oldest(message_buffer);
+        ++message_buffer->n_expired;
+    }
+
+    // Schedule expiry of the oldest message (if any)
+    if (message_buffer->n_messages > 0) {
+        buffered_message = list_ledata(list_head(&message_buffer->messages));
+        tmr_start(&message_buffer->expire_timer,
+                  buffered_message->timestamp + message_buffer->limits.max_age + 1 - now,
+                  message_buffer_expire_timer_handler, message_buffer);
+    } else {
+        tmr_cancel(&message_buffer->expire_timer);
+    }
+}
+
+/*
+ * Handle expiry timer.
+ */
+static void message_buffer_expire_timer_handler(
+        void* arg
+) {
+    message_buffer_expire(arg);
+}
+
+/*
+ * Return whether a message of a specific size fits into the message
+ * buffer.
+ */
+static bool message_buffer_fits(
+        struct rawrtc_message_buffer const* const message_buffer, // not checked
+        size_t const size
+) {
+    struct rawrtc_message_buffer_limits const* const limits = &message_buffer->limits;
+    return (limits->max_messages == 0 || message_buffer->n_messages < limits->max_messages)
+           && (limits->max_size == 0 || message_buffer->size + size <= limits->max_size);
 }
 
 /*
@@ -33,27 +106,111 @@ static void rawrtc_message_buffer_destroy(
     struct rawrtc_buffered_message* const buffered_message = arg;
 
     // Un-reference
+    // Note: Buffered messages may be owned by the application, so they are never recycled.
     mem_deref(buffered_message->context);
     mem_deref(buffered_message->buffer);
 }
 
 /*
- * Create a message buffer.
- *
- * TODO: Add timestamp to be able to ignore old messages
+ * Initialise a message buffer.
  */
-enum rawrtc_code rawrtc_message_buffer_append(
-        struct list* const message_buffer,
+void rawrtc_message_buffer_init(
+        struct rawrtc_message_buffer* const message_buffer // not checked
+) {
+    list_init(&message_buffer->messages);
+    message_buffer->size = 0;
+    message_buffer->n_messages = 0;
+    memset(&message_buffer->limits, 0, sizeof(message_buffer->limits));
+    tmr_init(&message_buffer->expire_timer);
+    message_buffer->n_dropped = 0;
+    message_buffer->n_expired = 0;
+}
+
+/*
+ * Set the limits of a message buffer.
+ * Already buffered messages that exceed the new maximum age will be
+ * removed. Other limits will be applied on the next append.
+ */
+void rawrtc_message_buffer_set_limits(
+        struct rawrtc_message_buffer* const message_buffer, // not checked
+        struct rawrtc_message_buffer_limits const* const limits // copied, not checked
+) {
+    message_buffer->limits = *limits;
+    message_buffer_expire(message_buffer);
+}
+
+/*
+ * Get the statistics of a message buffer.
+ */
+void rawrtc_message_buffer_get_stats(
+        struct rawrtc_message_buffer_stats* const statsp, // de-referenced, not checked
+        struct rawrtc_message_buffer* const message_buffer // not checked
+) {
+    // Remove expired messages
+    message_buffer_expire(message_buffer);
+
+    // Copy statistics
+    statsp->size = message_buffer->size;
+    statsp->n_messages = message_buffer->n_messages;
+    statsp->n_dropped = message_buffer->n_dropped;
+    statsp->n_expired = message_buffer->n_expired;
+}
+
+/*
+ * Remove and un-reference all buffered messages and reset the
+ * statistics.
+ */
+void rawrtc_message_buffer_flush(
+        struct rawrtc_message_buffer* const message_buffer // not checked
+) {
+    tmr_cancel(&message_buffer->expire_timer);
+    list_flush(&message_buffer->messages);
+    message_buffer->size = 0;
+    message_buffer->n_messages = 0;
+    message_buffer->n_dropped = 0;
+    message_buffer->n_expired = 0;
+}
+
+/*
+ * Append a message to a message buffer, optionally ignoring the
+ * limits.
+ */
+static enum rawrtc_code message_buffer_append(
+        struct rawrtc_message_buffer* const message_buffer,
         struct mbuf* const buffer, // referenced
-        void* const context // referenced, nullable
+        void* const context, // referenced, nullable
+        bool const limited
 ) {
     struct rawrtc_buffered_message* buffered_message;
+    size_t size;
 
     // Check arguments
     if (!message_buffer || !buffer) {
         return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
+    // Remove expired messages
+    message_buffer_expire(message_buffer);
+
+    // Make room (if possible)
+    size = mbuf_get_left(buffer);
+    if (!limited) {
+        goto append;
+    }
+    if (message_buffer->limits.policy == RAWRTC_MESSAGE_BUFFER_POLICY_DROP_OLDEST) {
+        while (message_buffer->n_messages > 0 && !message_buffer_fits(message_buffer, size)) {
+            message_buffer_remove_oldest(message_buffer);
+            ++message_buffer->n_dropped;
+        }
+    }
+
+    // Drop message (if it still does not fit)
+    if (!message_buffer_fits(message_buffer, size)) {
+        ++message_buffer->n_dropped;
+        return RAWRTC_CODE_INSUFFICIENT_SPACE;
+    }
+
+append:
     // Create buffered message
     buffered_message = mem_zalloc(sizeof(*buffered_message), rawrtc_message_buffer_destroy);
     if (!buffered_message) {
@@ -63,12 +220,52 @@ enum rawrtc_code rawrtc_message_buffer_append(
     // Set fields
     buffered_message->buffer = mem_ref(buffer);
     buffered_message->context = mem_ref(context);
+    buffered_message->size = size;
+    buffered_message->timestamp = tmr_jiffies();
 
-    // Add to list
-    list_append(message_buffer, &buffered_message->le, buffered_message);
+    // Add to list & update counters
+    list_append(&message_buffer->messages, &buffered_message->le, buffered_message);
+    message_buffer->size += buffered_message->size;
+    ++message_buffer->n_messages;
+
+    // Schedule expiry (if not already scheduled)
+    if (message_buffer->limits.max_age > 0 && !tmr_isrunning(&message_buffer->expire_timer)) {
+        message_buffer_expire(message_buffer);
+    }
     return RAWRTC_CODE_SUCCESS;
 }
 
+/*
+ * Append a message to a message buffer.
+ *
+ * In case the message exceeds the limits of the message buffer, either
+ * the oldest messages will be dropped to make room for it or the
+ * message will be dropped and `RAWRTC_CODE_INSUFFICIENT_SPACE` will be
+ * returned, depending on the message buffer's policy.
+ */
+enum rawrtc_code rawrtc_message_buffer_append(
+        struct rawrtc_message_buffer* const message_buffer,
+        struct mbuf* const buffer, // referenced
+        void* const context // referenced, nullable
+) {
+    return message_buffer_append(message_buffer, buffer, context, true);
+}
+
+/*
+ * Append a message to a message buffer regardless of its limits.
+ *
+ * This is meant for data that must not be dropped, such as the
+ * remainder of a message that has already been partially handed to
+ * the lower layer.
+ */
+enum rawrtc_code rawrtc_message_buffer_append_unlimited(
+        struct rawrtc_message_buffer* const message_buffer,
+        struct mbuf* const buffer, // referenced
+        void* const context // referenced, nullable
+) {
+    return message_buffer_append(message_buffer, buffer, context, false);
+}
+
 /*
  * Apply a receive handler to buffered messages.
  *
@@ -76,7 +273,7 @@ enum rawrtc_code rawrtc_message_buffer_append(
  * the message handler returned `false`.
  */
 enum rawrtc_code rawrtc_message_buffer_clear(
-        struct list* const message_buffer,
+        struct rawrtc_message_buffer* const message_buffer,
         rawrtc_message_buffer_handler* const message_handler,
         void* arg
 ) {
@@ -88,26 +285,28 @@ enum rawrtc_code rawrtc_message_buffer_clear(
         return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
+    // Remove expired messages
+    message_buffer_expire(message_buffer);
+
     // Handle each message
-    le = list_head(message_buffer);
+    le = list_head(&message_buffer->messages);
     while (le != NULL) {
         struct rawrtc_buffered_message* const buffered_message = le->data;
 
+        // Get next message
+        // Note: This needs to be done before unlinking as unlinking resets the element's links.
+        struct le* const next = le->next;
+
         // Handle message
         unlink = message_handler(buffered_message->buffer, buffered_message->context, arg);
-        if (unlink) {
-            list_unlink(le);
+        if (!unlink) {
+            return RAWRTC_CODE_STOP_ITERATION;
         }
 
-        // Get next message
-        le = le->next;
-
         // Remove message
-        if (unlink) {
-            mem_deref(buffered_message);
-        } else {
-            return RAWRTC_CODE_STOP_ITERATION;
-        }
+        message_buffer_unlink(message_buffer, buffered_message);
+        mem_deref(buffered_message);
+        le = next;
     }
 
     // Done
@@ -131,7 +330,7 @@ enum rawrtc_code rawrtc_message_buffer_clear(
 enum rawrtc_code rawrtc_message_buffer_merge(
         struct mbuf** const bufferp, // de-referenced
         void** const contextp, // de-referenced
-        struct list* const message_buffer
+        struct rawrtc_message_buffer* const message_buffer
 ) {
     struct le* le;
     struct rawrtc_buffered_message* buffered_message;
@@ -147,7 +346,7 @@ enum rawrtc_code rawrtc_message_buffer_merge(
     }
 
     // Get first message (or return none)
-    le = list_head(message_buffer);
+    le = list_head(&message_buffer->messages);
     if (!le) {
         DEBUG_PRINTF("Nothing to merge\n");
         *bufferp = NULL;
@@ -159,7 +358,7 @@ enum rawrtc_code rawrtc_message_buffer_merge(
     buffered_message = le->data;
     context = buffered_message->context;
 
-    DEBUG_PRINTF("Merging %zu buffered messages\n", list_count(message_buffer));
+    DEBUG_PRINTF("Merging %"PRIuFAST32" buffered messages\n", message_buffer->n_messages);
 
     // Handle each message
     for (; le != NULL; le = le->next) {
@@ -172,7 +371,7 @@ enum rawrtc_code rawrtc_message_buffer_merge(
                 buffer = buffered_message->buffer;
                 pos = buffer->pos;
                 end = buffer->end;
-                err = mbuf_resize(buffer, pos + buffer_sum_left(message_buffer));
+                err = mbuf_resize(buffer, pos + message_buffer->size);
                 if (err) {
                     goto out;
                 }
@@ -218,7 +417,7 @@ out:
         *contextp = mem_ref(context);
 
         // Un-reference all messages
-        list_flush(message_buffer);
+        rawrtc_message_buffer_flush(message_buffer);
         DEBUG_PRINTF("Merging complete\n");
     }
 
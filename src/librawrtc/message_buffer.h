@@ -13,14 +13,47 @@ typedef bool (rawrtc_message_buffer_handler)(
     void* const arg
 );
 
+void rawrtc_message_buffer_init(
+    struct rawrtc_message_buffer* const message_buffer // not checked
+);
+
+void rawrtc_message_buffer_flush(
+    struct rawrtc_message_buffer* const message_buffer // not checked
+);
+
+/*
+ * Return whether the message buffer is empty.
+ */
+static inline bool rawrtc_message_buffer_is_empty(
+    struct rawrtc_message_buffer const * const message_buffer // not checked
+) {
+    return message_buffer->n_messages == 0;
+}
+
+void rawrtc_message_buffer_set_limits(
+    struct rawrtc_message_buffer* const message_buffer, // not checked
+    struct rawrtc_message_buffer_limits const* const limits // copied, not checked
+);
+
+void rawrtc_message_buffer_get_stats(
+    struct rawrtc_message_buffer_stats* const statsp, // de-referenced, not checked
+    struct rawrtc_message_buffer* const message_buffer // not checked
+);
+
 enum rawrtc_code rawrtc_message_buffer_append(
-    struct list* const message_buffer,
+    struct rawrtc_message_buffer* const message_buffer,
+    struct mbuf* const buffer, // referenced
+    void* const context // referenced, nullable
+);
+
+enum rawrtc_code rawrtc_message_buffer_append_unlimited(
+    struct rawrtc_message_buffer* const message_buffer,
     struct mbuf* const buffer, // referenced
     void* const context // referenced, nullable
 );
 
 enum rawrtc_code rawrtc_message_buffer_clear(
-    struct list* const message_buffer,
+    struct rawrtc_message_buffer* const message_buffer,
     rawrtc_message_buffer_handler* const message_handler,
     void* arg
 );
@@ -28,5 +61,5 @@ enum rawrtc_code rawrtc_message_buffer_clear(
 enum rawrtc_code rawrtc_message_buffer_merge(
     struct mbuf** const bufferp, // de-referenced
     void** const contextp, // de-referenced
-    struct list* const message_buffer
+    struct rawrtc_message_buffer* const message_buffer
 );
@@ -1,7 +1,7 @@
 #pragma once
 
 enum {
-    RAWRTC_SCTP_CAPABILITIES_MAX_MESSAGE_SIZE = 0,
+    RAWRTC_SCTP_CAPABILITIES_MAX_MESSAGE_SIZE = 262144, // 256 KiB, advertised and enforced
 };
 
 int rawrtc_sctp_capabilities_debug(
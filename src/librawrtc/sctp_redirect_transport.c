@@ -1,10 +1,13 @@
-#include <string.h> // memset
+#define _GNU_SOURCE // recvmmsg, sendmmsg
+#include <string.h> // memset, memcpy, memmove
 #include <sys/types.h>
-#include <sys/socket.h> // AF_INET, SOCK_RAW, sendto, recvfrom
+#include <sys/socket.h> // AF_INET, SOCK_RAW, recvmmsg, sendmmsg
 #include <netinet/in.h> // IPPROTO_RAW, ntohs, htons
 #include <unistd.h> // close
+#include <fcntl.h> // fcntl
 #include <errno.h>
 #include <rawrtc.h>
+#include "buffer_pool.h"
 #include "crc32c.h"
 #include "dtls_transport.h"
 #include "sctp_redirect_transport.h"
@@ -15,16 +18,39 @@
 
 /*
  * Patch local and remote port in the SCTP packet header.
+ * The checksum is updated incrementally from the old and new ports, so
+ * the cost does not depend on the packet size.
+ * Note: This preserves an invalid checksum. Use
+ *       `rawrtc_sctp_redirect_transport_set_checksum_recompute` in case
+ *       the raw socket delivers packets without a valid checksum (e.g.
+ *       due to SCTP checksum offloading on the loopback interface).
  */
 static void patch_sctp_header(
         struct mbuf* const buffer,
         uint16_t const source,
-        uint16_t const destination
+        uint16_t const destination,
+        bool const recompute_checksum
 ) {
     size_t const start = buffer->pos;
+    uint8_t old_ports[4];
+    uint8_t new_ports[4];
     int err;
     uint32_t checksum;
 
+    // Check length (ports, verification tag and checksum)
+    if (mbuf_get_left(buffer) < 12) {
+        DEBUG_WARNING("Could not patch header, packet too short\n");
+        return;
+    }
+
+    // Read old ports
+    err = mbuf_read_mem(buffer, old_ports, sizeof(old_ports));
+    if (err) {
+        DEBUG_WARNING("Could not read ports, reason: %m\n", err);
+        return;
+    }
+    mbuf_set_pos(buffer, start);
+
     // Patch source port
     err = mbuf_write_u16(buffer, htons(source));
     if (err) {
@@ -42,13 +68,26 @@ static void patch_sctp_header(
     // Skip verification tag
     mbuf_advance(buffer, 4);
 
-    // Reset checksum field to '0' and rewind back
-    memset(mbuf_buf(buffer), 0, 4);
-    mbuf_set_pos(buffer, start);
-    // Recalculate checksum
-    checksum = crc32c(0, mbuf_buf(buffer), mbuf_get_left(buffer));
-    // Advance to checksum field, set it and rewind back
-    mbuf_advance(buffer, 8);
+    if (recompute_checksum) {
+        // Reset checksum field to '0' and rewind back
+        memset(mbuf_buf(buffer), 0, 4);
+        mbuf_set_pos(buffer, start);
+        // Recalculate checksum
+        checksum = crc32c(0, mbuf_buf(buffer), mbuf_get_left(buffer));
+        // Advance to checksum field
+        mbuf_advance(buffer, 8);
+    } else {
+        // Update checksum with the changed ports
+        // Note: The checksum has been calculated with the checksum field set to '0'.
+        memcpy(new_ports, buffer->buf + start, sizeof(new_ports));
+        checksum = mbuf_read_u32(buffer);
+        checksum = crc32c_patch(
+                checksum, old_ports, new_ports, sizeof(new_ports),
+                buffer->end - start - sizeof(new_ports));
+        mbuf_advance(buffer, -4);
+    }
+
+    // Set checksum and rewind back
     err = mbuf_write_u32(buffer, checksum);
     if (err) {
         DEBUG_WARNING("Could not patch checksum, reason: %m\n", err);
@@ -58,94 +97,301 @@ static void patch_sctp_header(
 }
 
 /*
- * Handle outgoing messages (that came in from the raw socket).
+ * Handle an outgoing message (that came in from the raw socket).
  */
-static void redirect_from_raw(
-        int flags,
-        void* arg
+static void redirect_raw_message(
+        struct rawrtc_sctp_redirect_transport* const transport, // not checked
+        struct mbuf* const buffer, // not checked
+        struct sockaddr_storage const* const from_address // not checked
 ) {
-    struct rawrtc_sctp_redirect_transport* const transport = arg;
-    struct mbuf* buffer;
     enum rawrtc_code error;
-    struct sockaddr_in from_address;
-    socklen_t address_length;
-    ssize_t length;
     struct sa from = {{{0}}};
     size_t header_length;
     uint16_t source;
     uint16_t destination;
 
-    if ((flags & FD_READ) == FD_READ) {
-        buffer = transport->buffer;
+    // Check address
+    error = rawrtc_error_to_code(sa_set_sa(&from, (struct sockaddr*) from_address));
+    if (error) {
+        DEBUG_WARNING("Invalid sender address: %m\n", error);
+        return;
+    }
+    DEBUG_PRINTF("Received %zu bytes via RAW from %j\n", mbuf_get_left(buffer), &from);
+    if (!sa_isset(&from, SA_ADDR) && !sa_cmp(&transport->redirect_address, &from, SA_ADDR)) {
+        DEBUG_WARNING("Ignoring data from unknown address");
+        return;
+    }
+
+    // Skip IPv4 header
+    // Note: IPv6 raw sockets do not deliver the IP header.
+    if (sa_af(&from) == AF_INET) {
+        header_length = (size_t) (mbuf_read_u8(buffer) & 0xf);
+        mbuf_advance(buffer, -1);
+        DEBUG_PRINTF("RAW IPv4 header length: %zu\n", header_length);
+        mbuf_advance(buffer, header_length * 4);
+    }
+
+    // Check length (ports, verification tag and checksum)
+    if (mbuf_get_left(buffer) < 12) {
+        DEBUG_WARNING("Ignored truncated SCTP packet\n");
+        return;
+    }
+
+    // Read source and destination port
+    source = ntohs(mbuf_read_u16(buffer));
+    destination = ntohs(mbuf_read_u16(buffer));
+    sa_set_port(&from, source);
+    (void) destination;
+    DEBUG_PRINTF("RAW from %J to %"PRIu16"\n", &from, destination);
+    mbuf_advance(buffer, -4);
+
+    // Is this from the correct source?
+    if (source != sa_port(&transport->redirect_address)) {
+        DEBUG_WARNING("Ignored data from different source\n");
+        return;
+    }
 
-        // Rewind buffer
-        mbuf_rewind(buffer);
+    // Update SCTP header with changed ports
+    patch_sctp_header(
+            buffer, transport->local_port, transport->remote_port,
+            transport->recompute_checksum);
+
+    // Send data
+    error = rawrtc_dtls_transport_send(transport->dtls_transport, buffer);
+    if (error) {
+        DEBUG_WARNING("Could not send, error: %m\n", error);
+        return;
+    }
+}
+
+static void send_flush(
+    struct rawrtc_sctp_redirect_transport* const transport // not checked
+);
+
+/*
+ * Handle outgoing messages (that came in from the raw socket).
+ * Drains the raw socket in batches until it would block or the
+ * receive budget has been exhausted.
+ * Also resumes sending queued messages once the raw socket is
+ * writable again.
+ */
+static void redirect_from_raw(
+        int flags,
+        void* arg
+) {
+    struct rawrtc_sctp_redirect_transport* const transport = arg;
+    struct mmsghdr messages[RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE];
+    struct iovec vectors[RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE];
+    struct sockaddr_storage addresses[RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE];
+    unsigned int budget = RAWRTC_SCTP_REDIRECT_TRANSPORT_RECEIVE_BUDGET;
+    unsigned int batch;
+    unsigned int i;
+    int n;
+
+    // Send queued messages (if writable again)
+    if (flags & FD_WRITE) {
+        send_flush(transport);
+    }
+
+    if ((flags & FD_READ) != FD_READ) {
+        return;
+    }
+
+    while (budget > 0) {
+        batch = budget < RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE ?
+                budget : RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE;
+
+        // Prepare messages
+        memset(messages, 0, sizeof(messages[0]) * batch);
+        for (i = 0; i < batch; ++i) {
+            struct mbuf* const buffer = transport->receive_buffers[i];
+            mbuf_rewind(buffer);
+            vectors[i].iov_base = buffer->buf;
+            vectors[i].iov_len = buffer->size;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
 
         // Receive
-        address_length = sizeof(from_address);
-        length = recvfrom(transport->socket, mbuf_buf(buffer), mbuf_get_space(buffer),
-                0, (struct sockaddr*) &from_address, &address_length);
-        if (length == -1) {
-            DEBUG_WARNING("Unable to receive raw message: %m\n", errno);
+        n = recvmmsg(transport->socket, messages, batch, MSG_DONTWAIT, NULL);
+        if (n == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                DEBUG_WARNING("Unable to receive raw messages: %m\n", errno);
+            }
             return;
         }
-        mbuf_set_end(buffer, (size_t) length);
+        DEBUG_PRINTF("Received %d raw messages in one batch\n", n);
 
-        // TODO: Receive remaining bytes (if any)
+        // Handle messages
+        for (i = 0; i < (unsigned int) n; ++i) {
+            struct mbuf* const buffer = transport->receive_buffers[i];
 
-        // Check address
-        error = rawrtc_error_to_code(sa_set_sa(&from, (struct sockaddr*) &from_address));
-        if (error) {
-            DEBUG_WARNING("Invalid sender address: %m\n", error);
-            return;
+            // Drop truncated message
+            // Note: The remaining bytes of a raw message cannot be received.
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                DEBUG_WARNING("Dropped raw message exceeding %zu bytes\n", buffer->size);
+                continue;
+            }
+            mbuf_set_end(buffer, messages[i].msg_len);
+
+            // Redirect
+            redirect_raw_message(transport, buffer, &addresses[i]);
+
+            // Stop (if closed in the meantime)
+            if (transport->state != RAWRTC_SCTP_REDIRECT_TRANSPORT_STATE_OPEN) {
+                return;
+            }
+
+            // Replace buffer (if still referenced, e.g. buffered by the DTLS transport)
+            if (mem_nrefs(buffer) > 1) {
+                mem_deref(buffer);
+                transport->receive_buffers[i] = mbuf_alloc(
+                        RAWRTC_SCTP_REDIRECT_TRANSPORT_BUFFER_SIZE);
+                if (!transport->receive_buffers[i]) {
+                    DEBUG_WARNING("Could not replace receive buffer, closing\n");
+                    rawrtc_sctp_redirect_transport_stop(transport);
+                    return;
+                }
+            }
         }
-        DEBUG_PRINTF("Received %zu bytes via RAW from %j\n", mbuf_get_left(buffer), &from);
-        if (!sa_isset(&from, SA_ADDR) && !sa_cmp(&transport->redirect_address, &from, SA_ADDR)) {
-            DEBUG_WARNING("Ignoring data from unknown address");
+
+        // Drained?
+        if ((unsigned int) n < batch) {
             return;
         }
+        budget -= (unsigned int) n;
+    }
+}
 
-        // Skip IPv4 header
-        header_length = (size_t) (mbuf_read_u8(buffer) & 0xf);
-        mbuf_advance(buffer, -1);
-        DEBUG_PRINTF("RAW IPv4 header length: %zu\n", header_length);
-        mbuf_advance(buffer, header_length * 4);
+/*
+ * Wait (or stop waiting) for the raw socket to become writable.
+ */
+static void set_send_blocked(
+        struct rawrtc_sctp_redirect_transport* const transport, // not checked
+        bool const blocked
+) {
+    int err;
 
-        // Read source and destination port
-        source = ntohs(mbuf_read_u16(buffer));
-        destination = ntohs(mbuf_read_u16(buffer));
-        sa_set_port(&from, source);
-        (void) destination;
-        DEBUG_PRINTF("RAW from %J to %"PRIu16"\n", &from, destination);
-        mbuf_advance(buffer, -4);
+    // Unchanged?
+    if (transport->send_blocked == blocked) {
+        return;
+    }
 
-        // Is this from the correct source?
-        if (source != sa_port(&transport->redirect_address)) {
-            DEBUG_WARNING("Ignored data from different source\n");
-            return;
-        }
+    // Update events to listen on
+    err = fd_listen(
+            transport->socket, blocked ? FD_READ | FD_WRITE : FD_READ, redirect_from_raw,
+            transport);
+    if (err) {
+        DEBUG_WARNING("Unable to update raw socket events: %m\n", err);
+        return;
+    }
+    transport->send_blocked = blocked;
+}
+
+/*
+ * Send all queued messages over the raw socket.
+ * In case the raw socket would block, the unsent messages remain
+ * queued until the raw socket is writable again.
+ */
+static void send_flush(
+        struct rawrtc_sctp_redirect_transport* const transport // not checked
+) {
+    struct mmsghdr messages[RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE] = {{{0}}};
+    struct iovec vectors[RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE];
+    struct sa address;
+    size_t n_sent = 0;
+    size_t i;
+    bool blocked = false;
+
+    // Nothing to send?
+    if (transport->n_send_buffers == 0) {
+        return;
+    }
+
+    // Cancel timer
+    tmr_cancel(&transport->send_timer);
+
+    // Set destination address
+    // Note: The port field of a raw socket address must be zero (it is interpreted as the
+    //       protocol for IPv6).
+    address = transport->redirect_address;
+    sa_set_port(&address, 0);
+
+    // Prepare messages
+    for (i = 0; i < transport->n_send_buffers; ++i) {
+        vectors[i].iov_base = mbuf_buf(transport->send_buffers[i]);
+        vectors[i].iov_len = mbuf_get_left(transport->send_buffers[i]);
+        messages[i].msg_hdr.msg_name = &address.u.sa;
+        messages[i].msg_hdr.msg_namelen = address.len;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
 
-        // Update SCTP header with changed ports
-        patch_sctp_header(buffer, transport->local_port, transport->remote_port);
+    // Send over raw socket
+    DEBUG_PRINTF("Redirecting %zu messages to %J\n",
+                 transport->n_send_buffers, &transport->redirect_address);
+    while (n_sent < transport->n_send_buffers) {
+        int const n = sendmmsg(
+                transport->socket, &messages[n_sent],
+                (unsigned int) (transport->n_send_buffers - n_sent), 0);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
 
-        // Send data
-        error = rawrtc_dtls_transport_send(transport->dtls_transport, buffer);
-        if (error) {
-            DEBUG_WARNING("Could not send, error: %m\n", error);
-            return;
+            // Would block: Keep the remaining messages queued
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                DEBUG_PRINTF("Raw socket would block, %zu messages remain queued\n",
+                             transport->n_send_buffers - n_sent);
+                blocked = true;
+                break;
+            }
+
+            // Drop the failing message and continue with the next one
+            DEBUG_WARNING("Unable to redirect message: %m\n", errno);
+            ++n_sent;
+            continue;
         }
+        n_sent += (size_t) n;
+    }
+
+    // Return sent buffers to the pool
+    for (i = 0; i < n_sent; ++i) {
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), transport->send_buffers[i]);
+        transport->send_buffers[i] = NULL;
     }
+
+    // Move unsent buffers to the front of the queue
+    transport->n_send_buffers -= n_sent;
+    memmove(transport->send_buffers, &transport->send_buffers[n_sent],
+            transport->n_send_buffers * sizeof(*transport->send_buffers));
+
+    // Wait for the raw socket to become writable (if blocked)
+    set_send_blocked(transport, blocked);
+}
+
+/*
+ * Send queued messages at the end of the current event loop iteration.
+ */
+static void send_timer_handler(
+        void* arg
+) {
+    send_flush(arg);
 }
 
 /*
  * Handle incoming messages (that are sent out via the raw socket).
+ * Messages are queued and sent in batches.
  */
 static void redirect_to_raw(
         struct mbuf* const buffer,
         void* const arg
 ) {
     struct rawrtc_sctp_redirect_transport* const transport = arg;
-    ssize_t length;
+    struct mbuf* copy;
+    enum rawrtc_code error;
 
     // Check state
     if (transport->state != RAWRTC_SCTP_REDIRECT_TRANSPORT_STATE_OPEN) {
@@ -154,19 +400,49 @@ static void redirect_to_raw(
         return;
     }
 
+    // Make room in the queue (if full)
+    // Note: The queue can only remain full in case the raw socket would block in which case
+    //       the packet is dropped. SCTP will retransmit it.
+    if (transport->n_send_buffers == RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE) {
+        send_flush(transport);
+        if (transport->n_send_buffers == RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE) {
+            DEBUG_NOTICE("Dropped packet of %zu bytes as raw socket would block\n",
+                         mbuf_get_left(buffer));
+            return;
+        }
+    }
+
     // Update SCTP header with changed ports
-    patch_sctp_header(buffer, transport->local_port, sa_port(&transport->redirect_address));
+    patch_sctp_header(
+            buffer, transport->local_port, sa_port(&transport->redirect_address),
+            transport->recompute_checksum);
 
-    // Send over raw socket
-    DEBUG_PRINTF("Redirecting message (%zu bytes) to %J\n",
-            mbuf_get_left(buffer), &transport->redirect_address);
-    length = sendto(transport->socket, mbuf_buf(buffer), mbuf_get_left(buffer), 0,
-            &transport->redirect_address.u.sa, transport->redirect_address.len);
-    if (length == -1) {
-        DEBUG_WARNING("Unable to redirect message: %m\n", errno);
+    // Copy message
+    error = rawrtc_buffer_pool_get(&copy, rawrtc_buffer_pool_global(), mbuf_get_left(buffer));
+    if (error) {
+        DEBUG_WARNING("Unable to queue message: %s\n", rawrtc_code_to_str(error));
+        return;
+    }
+    error = rawrtc_error_to_code(mbuf_write_mem(copy, mbuf_buf(buffer), mbuf_get_left(buffer)));
+    if (error) {
+        DEBUG_WARNING("Unable to queue message: %s\n", rawrtc_code_to_str(error));
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), copy);
         return;
     }
-    mbuf_advance(buffer, length);
+    mbuf_set_pos(copy, 0);
+    mbuf_skip_to_end(buffer);
+
+    // Queue message
+    // Note: No timer needed while blocked as the queue will be flushed once writable.
+    if (transport->n_send_buffers == 0 && !transport->send_blocked) {
+        tmr_start(&transport->send_timer, 0, send_timer_handler, transport);
+    }
+    transport->send_buffers[transport->n_send_buffers++] = copy;
+
+    // Send (if batch is full)
+    if (transport->n_send_buffers == RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE) {
+        send_flush(transport);
+    }
 }
 
 /*
@@ -179,6 +455,16 @@ static void set_state(
 ) {
     // Closed?
     if (state == RAWRTC_SCTP_REDIRECT_TRANSPORT_STATE_CLOSED) {
+        size_t i;
+
+        // Send queued messages & drop those that could not be sent
+        send_flush(transport);
+        for (i = 0; i < transport->n_send_buffers; ++i) {
+            rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), transport->send_buffers[i]);
+            transport->send_buffers[i] = NULL;
+        }
+        transport->n_send_buffers = 0;
+
         // Stop listening and close raw socket
         if (transport->socket != -1) {
             fd_close(transport->socket);
@@ -211,7 +497,23 @@ static void rawrtc_sctp_redirect_transport_destroy(
 
     // Un-reference
     mem_deref(transport->dtls_transport);
-    mem_deref(transport->buffer);
+    mem_deref(transport->send_buffers);
+    mem_deref(transport->receive_buffers);
+}
+
+/*
+ * Destructor for an existing receive buffer array.
+ */
+static void receive_buffers_destroy(
+        void* arg
+) {
+    struct mbuf** const buffers = arg;
+    size_t i;
+
+    // Un-reference
+    for (i = 0; i < RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE; ++i) {
+        mem_deref(buffers[i]);
+    }
 }
 
 /*
@@ -226,6 +528,8 @@ enum rawrtc_code rawrtc_sctp_redirect_transport_create(
 ) {
     bool have_data_transport;
     struct rawrtc_sctp_redirect_transport* transport;
+    size_t i;
+    int flags;
     enum rawrtc_code error;
 
     // Check arguments
@@ -256,6 +560,8 @@ enum rawrtc_code rawrtc_sctp_redirect_transport_create(
 
     // Set fields
     transport->state = RAWRTC_SCTP_REDIRECT_TRANSPORT_STATE_NEW;
+    transport->socket = -1;
+    tmr_init(&transport->send_timer);
     transport->dtls_transport = mem_ref(dtls_transport);
     transport->local_port = port ? port : RAWRTC_SCTP_REDIRECT_TRANSPORT_DEFAULT_PORT;
     error = rawrtc_error_to_code(sa_set_str(
@@ -264,21 +570,43 @@ enum rawrtc_code rawrtc_sctp_redirect_transport_create(
         goto out;
     }
 
-    // Create buffer
-    transport->buffer = mbuf_alloc(2048);
-    if (!transport->buffer) {
+    // Create receive buffers
+    transport->receive_buffers = mem_zalloc(
+            RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE * sizeof(*transport->receive_buffers),
+            receive_buffers_destroy);
+    if (!transport->receive_buffers) {
         error = RAWRTC_CODE_NO_MEMORY;
         goto out;
     }
+    for (i = 0; i < RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE; ++i) {
+        transport->receive_buffers[i] = mbuf_alloc(RAWRTC_SCTP_REDIRECT_TRANSPORT_BUFFER_SIZE);
+        if (!transport->receive_buffers[i]) {
+            error = RAWRTC_CODE_NO_MEMORY;
+            goto out;
+        }
+    }
 
-    // Create raw socket
-    transport->socket = socket(AF_INET, SOCK_RAW, IPPROTO_SCTP);
+    // Create send queue
+    transport->send_buffers = mem_zalloc(
+            RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE * sizeof(*transport->send_buffers), NULL);
+    if (!transport->send_buffers) {
+        error = RAWRTC_CODE_NO_MEMORY;
+        goto out;
+    }
+
+    // Create raw socket (IPv4 or IPv6, depending on the redirect address)
+    transport->socket = socket(sa_af(&transport->redirect_address), SOCK_RAW, IPPROTO_SCTP);
     if (transport->socket == -1) {
         error = rawrtc_error_to_code(errno);
         goto out;
     }
 
-    // TODO: Set non-blocking
+    // Set non-blocking
+    flags = fcntl(transport->socket, F_GETFL);
+    if (flags == -1 || fcntl(transport->socket, F_SETFL, flags | O_NONBLOCK) == -1) {
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
 
 out:
     if (error) {
@@ -383,3 +711,21 @@ enum rawrtc_code rawrtc_sctp_redirect_transport_get_port(
     // Done
     return RAWRTC_CODE_SUCCESS;
 }
+
+/*
+ * Set whether the SCTP redirect transport recalculates the checksum of
+ * each redirected packet instead of updating it incrementally.
+ */
+enum rawrtc_code rawrtc_sctp_redirect_transport_set_checksum_recompute(
+        struct rawrtc_sctp_redirect_transport* const transport,
+        bool const recompute
+) {
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set flag & done
+    transport->recompute_checksum = recompute;
+    return RAWRTC_CODE_SUCCESS;
+}
@@ -2,3 +2,9 @@
 #include <inttypes.h>
 
 #define RAWRTC_SCTP_REDIRECT_TRANSPORT_DEFAULT_PORT (uint16_t) 5000
+
+enum {
+    RAWRTC_SCTP_REDIRECT_TRANSPORT_BATCH_SIZE = 16,
+    RAWRTC_SCTP_REDIRECT_TRANSPORT_RECEIVE_BUDGET = 64,
+    RAWRTC_SCTP_REDIRECT_TRANSPORT_BUFFER_SIZE = 9216,
+};
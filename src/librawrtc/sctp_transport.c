@@ -10,10 +10,12 @@
 #include <rawrtc.h>
 #include "main.h"
 #include "utils.h"
+#include "buffer_pool.h"
 #include "message_buffer.h"
 #include "dtls_transport.h"
 #include "data_transport.h"
 #include "data_channel_parameters.h"
+#include "sctp_capabilities.h"
 #include "sctp_transport.h"
 
 #define DEBUG_MODULE "sctp-transport"
@@ -28,6 +30,14 @@ struct send_context {
         struct sctp_sendv_spa spa;
     } info;
     int flags;
+    struct rawrtc_sctp_data_channel_context* channel_context; // referenced, nullable
+    size_t size;
+};
+
+// Context for releasing messages waiting for their outgoing stream
+struct pending_release_context {
+    struct rawrtc_sctp_transport* transport;
+    struct rawrtc_message_buffer held; // still waiting for their outgoing stream
 };
 
 // Events to subscribe to
@@ -56,6 +66,12 @@ static bool channel_registered(
     struct rawrtc_data_channel* const channel // not checked
 );
 
+static enum rawrtc_code data_channels_alloc(
+    struct rawrtc_data_channel*** channelsp, // de-referenced
+    uint_fast16_t const n_channels,
+    uint_fast16_t const n_channels_previously
+);
+
 static void channel_register(
     struct rawrtc_sctp_transport* const transport, // not checked
     struct rawrtc_data_channel* const channel, // referenced, not checked
@@ -72,6 +88,43 @@ enum rawrtc_code sctp_transport_send(
     int const flags
 );
 
+static enum rawrtc_code transport_send(
+    struct rawrtc_sctp_transport* const transport, // not checked
+    struct rawrtc_sctp_data_channel_context* const channel_context, // nullable
+    struct mbuf* const buffer, // not checked
+    void* const info,
+    socklen_t const info_size,
+    unsigned int const info_type,
+    int const flags
+);
+
+static enum rawrtc_code transport_buffer(
+    struct rawrtc_sctp_transport* const transport, // not checked
+    struct rawrtc_sctp_data_channel_context* const channel_context, // nullable
+    struct mbuf* const buffer, // not checked
+    void* const info,
+    unsigned int const info_type,
+    int const flags,
+    bool const in_flight
+);
+
+static enum rawrtc_code sctp_transport_sendv(
+    struct rawrtc_sctp_transport* const transport, // not checked
+    struct iovec const * const segments, // not checked
+    size_t const n_segments,
+    void* const info, // not checked
+    socklen_t const info_size,
+    unsigned int const info_type,
+    int const flags,
+    size_t* const writtenp // de-referenced, not checked
+);
+
+static void timer_activity();
+
+static void event_timer_handler(
+    void* arg
+);
+
 /*
  * Parse a data channel open message.
  */
@@ -181,6 +234,7 @@ static enum rawrtc_code data_channel_open_message_create(
     size_t label_length;
     size_t protocol_length;
     struct mbuf* buffer;
+    enum rawrtc_code error;
     int err;
 
     // Get length of label and protocol
@@ -194,16 +248,18 @@ static enum rawrtc_code data_channel_open_message_create(
     }
 #endif
 
-    // Allocate
-    buffer = mbuf_alloc(RAWRTC_DCEP_MESSAGE_OPEN_BASE_SIZE + label_length + protocol_length);
-    if (!buffer) {
-        return RAWRTC_CODE_NO_MEMORY;
+    // Get buffer
+    error = rawrtc_buffer_pool_get(
+            &buffer, rawrtc_buffer_pool_global(),
+            RAWRTC_DCEP_MESSAGE_OPEN_BASE_SIZE + label_length + protocol_length);
+    if (error) {
+        return error;
     }
 
     // Set fields
     err = mbuf_write_u8(buffer, RAWRTC_DCEP_MESSAGE_TYPE_OPEN);
     err |= mbuf_write_u8(buffer, parameters->channel_type);
-    err |= mbuf_write_u16(buffer, htons(RAWRTC_DCEP_CHANNEL_PRIORITY_NORMAL)); // TODO: Ok?
+    err |= mbuf_write_u16(buffer, htons(parameters->priority));
     err |= mbuf_write_u32(buffer, htonl(parameters->reliability_parameter));
     err |= mbuf_write_u16(buffer, htons((uint16_t) label_length));
     err |= mbuf_write_u16(buffer, htons((uint16_t) protocol_length));
@@ -215,7 +271,7 @@ static enum rawrtc_code data_channel_open_message_create(
     }
 
     if (err) {
-        mem_deref(buffer);
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
         return rawrtc_error_to_code(err);
     } else {
         // Set position
@@ -233,19 +289,22 @@ static enum rawrtc_code data_channel_open_message_create(
 static enum rawrtc_code data_channel_ack_message_create(
         struct mbuf** const bufferp // de-referenced, not checked
 ) {
+    struct mbuf* buffer;
+    enum rawrtc_code error;
     int err;
 
-    // Allocate
-    struct mbuf* const buffer = mbuf_alloc(RAWRTC_DCEP_MESSAGE_ACK_BASE_SIZE);
-    if (!buffer) {
-        return RAWRTC_CODE_NO_MEMORY;
+    // Get buffer
+    error = rawrtc_buffer_pool_get(
+            &buffer, rawrtc_buffer_pool_global(), RAWRTC_DCEP_MESSAGE_ACK_BASE_SIZE);
+    if (error) {
+        return error;
     }
 
     // Set fields
     err = mbuf_write_u8(buffer, RAWRTC_DCEP_MESSAGE_TYPE_ACK);
 
     if (err) {
-        mem_deref(buffer);
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
         return rawrtc_error_to_code(err);
     } else {
         // Set position
@@ -302,6 +361,67 @@ static void trace_packet(
     }
 }
 
+/*
+ * Enable or disable usrsctp's no-delay option (nagle).
+ */
+static enum rawrtc_code set_no_delay(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        bool const enable
+) {
+    int option_value = enable ? 1 : 0;
+
+    // Set no delay option
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_NODELAY,
+                           &option_value, sizeof(option_value))) {
+        DEBUG_WARNING("Could not set no-delay, reason: %m\n", errno);
+        return rawrtc_error_to_code(errno);
+    }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Update the resumable send state of a data channel after (parts of)
+ * a message have been handed out to usrsctp.
+ */
+static void update_outbound_state(
+        struct rawrtc_sctp_data_channel_context* const context, // nullable
+        enum rawrtc_code const error,
+        size_t const written
+) {
+    // Nothing to do?
+    if (!context) {
+        return;
+    }
+
+    switch (error) {
+        case RAWRTC_CODE_SUCCESS:
+            // Message complete (EOR has been handed out)
+            context->outbound_offset = 0;
+            context->flags &= ~RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE;
+            break;
+        case RAWRTC_CODE_TRY_AGAIN_LATER:
+            // Message partially handed out (will be resumed on the next write event)
+            if (written > 0 || context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE) {
+                context->outbound_offset += written;
+                context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE;
+                DEBUG_PRINTF("Outgoing message on SID %"PRIu16" paused at offset %zu\n",
+                             context->sid, context->outbound_offset);
+            }
+            break;
+        default:
+            // Message aborted
+            if (context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE) {
+                DEBUG_WARNING("Outgoing message on SID %"PRIu16" aborted at offset %zu\n",
+                              context->sid, context->outbound_offset + written);
+            }
+            context->outbound_offset = 0;
+            context->flags &= ~RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE;
+            break;
+    }
+}
+
 /*
  * Send a deferred SCTP message.
  */
@@ -315,6 +435,8 @@ static bool sctp_send_deferred_message(
     enum rawrtc_code error;
     void* info;
     socklen_t info_size;
+    size_t left;
+    size_t written;
 
     // Determine info pointer and info size
     switch (send_context->info_type) {
@@ -331,10 +453,40 @@ static bool sctp_send_deferred_message(
             goto out;
     }
 
+    // Last message of a bundle? Disable nagle, so usrsctp flushes all pending chunks.
+    if (transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_BUNDLING &&
+            transport->buffered_messages_outgoing.n_messages == 1) {
+        set_no_delay(transport, true);
+        transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_BUNDLING;
+    }
+
     // Try sending
-    DEBUG_PRINTF("Sending deferred message\n");
+    // Note: The buffer's position reflects the bytes that have already been handed out to
+    //       usrsctp, so a partially sent message will be resumed from that offset.
+    if (send_context->channel_context &&
+            send_context->channel_context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE) {
+        DEBUG_PRINTF("Resuming deferred message on SID %"PRIu16" at offset %zu\n",
+                     send_context->channel_context->sid,
+                     send_context->channel_context->outbound_offset);
+    } else {
+        DEBUG_PRINTF("Sending deferred message\n");
+    }
+    left = mbuf_get_left(buffer);
     error = sctp_transport_send(
             transport, buffer, info, info_size, send_context->info_type, send_context->flags);
+
+    // Update resumable send state
+    written = left - mbuf_get_left(buffer);
+    update_outbound_state(send_context->channel_context, error, written);
+
+    // Move written bytes from the channel's queued amount to usrsctp's amount (if any)
+    if (send_context->channel_context) {
+        written = written > send_context->size ? send_context->size : written;
+        send_context->size -= written;
+        send_context->channel_context->buffered_amount -= written;
+        send_context->channel_context->usrsctp_buffered_amount += written;
+    }
+
     switch (error) {
         case RAWRTC_CODE_TRY_AGAIN_LATER:
             // Stop iterating through message queue
@@ -362,2334 +514,4230 @@ out:
 static enum rawrtc_code sctp_send_deferred_messages(
         struct rawrtc_sctp_transport* const transport // not checked
 ) {
+    enum rawrtc_code error;
+
+    // Bundle messages (if more than one)
+    // Note: Nagle is being enabled for all but the last message. This prevents usrsctp from
+    //       creating a packet for each message. Sending the last message with nagle disabled
+    //       will then flush all pending chunks in as few packets as possible.
+    if (transport->buffered_messages_outgoing.n_messages > 1 &&
+            set_no_delay(transport, false) == RAWRTC_CODE_SUCCESS) {
+        transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_BUNDLING;
+    }
+
     // Send buffered outgoing SCTP packets
-    return rawrtc_message_buffer_clear(
+    error = rawrtc_message_buffer_clear(
             &transport->buffered_messages_outgoing, sctp_send_deferred_message, transport);
+
+    // Disable nagle (if not already done)
+    if (transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_BUNDLING) {
+        set_no_delay(transport, true);
+        transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_BUNDLING;
+    }
+
+    // Done
+    return error;
 }
 
 /*
- * Send an SCTP message on the data channel.
- * TODO: Add EOR marking and some kind of an id (does ndata provide that?)
+ * Return whether the outgoing stream of a data channel exists.
+ * Messages without a channel are assumed to target an existing stream.
  */
-static enum rawrtc_code send_message(
+static bool have_outbound_stream(
         struct rawrtc_sctp_transport* const transport, // not checked
-        struct rawrtc_data_channel* const channel, // nullable (if DCEP message)
-        struct rawrtc_sctp_data_channel_context* const context, // not checked
-        struct mbuf* const buffer, // not checked
-        uint_fast32_t const ppid
+        struct rawrtc_sctp_data_channel_context* const channel_context // nullable
 ) {
-    struct sctp_sendv_spa spa = {0};
-    enum rawrtc_code error;
+    return !channel_context || channel_context->sid < transport->n_outbound_streams;
+}
 
-    // Set stream identifier, protocol identifier and flags
-    spa.sendv_sndinfo.snd_sid = context->sid;
-    spa.sendv_sndinfo.snd_flags = SCTP_EOR; // TODO: Update signature
-    spa.sendv_sndinfo.snd_ppid = htonl((uint32_t) ppid);
-    spa.sendv_flags = SCTP_SEND_SNDINFO_VALID;
+/*
+ * Return whether messages can be handed out to usrsctp directly.
+ */
+static bool can_send_directly(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    return transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED &&
+           !(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_CORKED) &&
+           rawrtc_message_buffer_is_empty(&transport->buffered_messages_outgoing);
+}
 
-    // Set ordered/unordered and partial reliability policy
-    if (ppid != RAWRTC_SCTP_TRANSPORT_PPID_DCEP) {
-        // Check channel
-        if (!channel) {
-            return RAWRTC_CODE_INVALID_ARGUMENT;
-        }
+/*
+ * Return whether deferred messages may be sent (i.e. the transport is
+ * not corked).
+ * Note: Messages waiting for their outgoing stream are held back
+ *       separately, so they do not block messages of other streams.
+ */
+static bool can_send_deferred(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    return !(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_CORKED);
+}
 
-        // Unordered?
-        if (channel->parameters->channel_type & RAWRTC_DATA_CHANNEL_TYPE_IS_UNORDERED &&
-                context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED) {
-            spa.sendv_sndinfo.snd_flags |= SCTP_UNORDERED;
-        }
+/*
+ * Move a message waiting for its outgoing stream into the outgoing
+ * message buffer (if the stream exists by now) or hold it back (if
+ * not).
+ */
+static bool release_pending_message(
+        struct mbuf* const buffer,
+        void* const context,
+        void* const arg
+) {
+    struct pending_release_context* const release_context = arg;
+    struct rawrtc_sctp_transport* const transport = release_context->transport;
+    struct send_context* const send_context = context;
+    struct rawrtc_message_buffer* target;
+    enum rawrtc_code error;
 
-        // Partial reliability policy
-        switch (ppid) {
-            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_ORDERED_RETRANSMIT:
-            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_UNORDERED_RETRANSMIT:
-                // Set amount of retransmissions
-                spa.sendv_prinfo.pr_policy = SCTP_PR_SCTP_RTX;
-                spa.sendv_prinfo.pr_value = channel->parameters->reliability_parameter;
-                spa.sendv_flags |= SCTP_SEND_PRINFO_VALID;
-            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_ORDERED_TIMED:
-            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_UNORDERED_TIMED:
-                // Set TTL
-                spa.sendv_prinfo.pr_policy = SCTP_PR_SCTP_TTL;
-                spa.sendv_prinfo.pr_value = channel->parameters->reliability_parameter;
-                spa.sendv_flags |= SCTP_SEND_PRINFO_VALID;
-            default:
-                // Nothing to do
-                break;
-        }
+    // Determine target
+    if (have_outbound_stream(transport, send_context->channel_context)) {
+        target = &transport->buffered_messages_outgoing;
+    } else {
+        target = &release_context->held;
     }
 
-    // Send message
-    DEBUG_PRINTF("Sending message with SID %"PRIu16", PPID: %"PRIu32"\n", context->sid, ppid);
-    error = rawrtc_sctp_transport_send(
-            transport, buffer, &spa, sizeof(spa), SCTP_SENDV_SPA, 0);
+    // Move message
+    // Note: The message has already been accepted, so the limits do not apply again.
+    error = rawrtc_message_buffer_append_unlimited(target, buffer, context);
     if (error) {
-        DEBUG_WARNING("Unable to send message, reason: %s\n", rawrtc_code_to_str(error));
-        return error;
+        DEBUG_WARNING("Could not move pending message, reason: %s\n",
+                      rawrtc_code_to_str(error));
     }
 
-    // Done
-    return RAWRTC_CODE_SUCCESS;
+    // Continue iterating through message queue
+    return true;
 }
 
 /*
- * Change the states of all data channels.
- * Caller MUST ensure that the same state is not set twice.
+ * Move a held back message back into the message buffer provided as
+ * argument.
  */
-static void set_data_channel_states(
-        struct rawrtc_sctp_transport* const transport, // not checked
-        enum rawrtc_data_channel_state const to_state,
-        enum rawrtc_data_channel_state const * const from_state // optional current state
+static bool hold_pending_message(
+        struct mbuf* const buffer,
+        void* const context,
+        void* const arg
 ) {
-    uint_fast16_t i;
-
-    // Set state on all data channels
-    for (i = 0; i < transport->n_channels; ++i) {
-        struct rawrtc_data_channel* const channel = transport->channels[i];
-        if (!channel) {
-            continue;
-        }
+    struct rawrtc_message_buffer* const message_buffer = arg;
+    enum rawrtc_code error;
 
-        // Update state
-        if (!from_state || channel->state == *from_state) {
-            rawrtc_data_channel_set_state(channel, to_state);
-        }
+    // Move message
+    error = rawrtc_message_buffer_append_unlimited(message_buffer, buffer, context);
+    if (error) {
+        DEBUG_WARNING("Could not hold back pending message, reason: %s\n",
+                      rawrtc_code_to_str(error));
     }
+
+    // Continue iterating through message queue
+    return true;
 }
 
 /*
- * Close all data channels.
- * Warning: This will not use the closing procedure, use `channel_close_handler` instead.
+ * Move messages whose outgoing stream has been added into the
+ * outgoing message buffer. Messages keep their order per stream.
  */
-static void close_data_channels(
+static void release_pending_messages(
         struct rawrtc_sctp_transport* const transport // not checked
 ) {
-    uint_fast16_t i;
+    struct pending_release_context context;
 
-    // Set state on all data channels
-    for (i = 0; i < transport->n_channels; ++i) {
-        struct rawrtc_data_channel* const channel = transport->channels[i];
-        if (!channel) {
-            continue;
-        }
+    // Nothing to do?
+    if (rawrtc_message_buffer_is_empty(&transport->buffered_messages_pending_streams)) {
+        return;
+    }
 
-        // Update state
-        DEBUG_PRINTF("Closing channel with SID %"PRIu16"\n", i);
-        rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
+    // Move messages
+    context.transport = transport;
+    rawrtc_message_buffer_init(&context.held);
+    rawrtc_message_buffer_clear(
+            &transport->buffered_messages_pending_streams, release_pending_message, &context);
+    rawrtc_message_buffer_clear(
+            &context.held, hold_pending_message, &transport->buffered_messages_pending_streams);
+    DEBUG_PRINTF("%"PRIuFAST32" messages still waiting for their outgoing stream\n",
+                 transport->buffered_messages_pending_streams.n_messages);
+}
 
-        // Remove from transport
-        transport->channels[i] = mem_deref(channel);
+/*
+ * Get the data channel registered for a stream identifier (if any).
+ */
+static struct rawrtc_data_channel* get_channel(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        uint_fast16_t const sid
+) {
+    if (sid >= transport->n_channels) {
+        return NULL;
     }
+    return transport->channels[sid];
 }
 
 /*
- * Change the state of the SCTP transport.
- * Will call the corresponding handler.
- * Caller MUST ensure that the same state is not set twice.
+ * Ensure the data channel array can hold a data channel with the
+ * stream identifier. The array grows exponentially (but never beyond
+ * the maximum amount of streams).
  */
-static void set_state(
+static enum rawrtc_code reserve_channel(
         struct rawrtc_sctp_transport* const transport, // not checked
-        enum rawrtc_sctp_transport_state const state
+        uint_fast16_t const sid
 ) {
-    // Closed?
-    if (state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        DEBUG_INFO("SCTP connection closed\n");
+    uint_fast32_t n_channels;
+    enum rawrtc_code error;
 
-        // Close all data channels
-        close_data_channels(transport);
+    // Already large enough?
+    if (sid < transport->n_channels) {
+        return RAWRTC_CODE_SUCCESS;
+    }
 
-        // Remove from DTLS transport
-        // Note: No NULL checking needed as the function will do that for us
-        rawrtc_dtls_transport_clear_data_transport(transport->dtls_transport);
+    // Check SID against maximum amount of streams
+    if (sid >= transport->max_streams) {
+        return RAWRTC_CODE_INSUFFICIENT_SPACE;
+    }
 
-        // Close socket and deregister transport
-        if (transport->socket) {
-            usrsctp_close(transport->socket);
-            usrsctp_deregister_address(transport);
-            transport->socket = NULL;
-        }
+    // Calculate new size
+    n_channels = (uint_fast32_t) transport->n_channels * 2;
+    if (n_channels < RAWRTC_SCTP_TRANSPORT_INITIAL_NUMBER_OF_CHANNELS) {
+        n_channels = RAWRTC_SCTP_TRANSPORT_INITIAL_NUMBER_OF_CHANNELS;
+    }
+    if (n_channels < (uint_fast32_t) sid + 1) {
+        n_channels = (uint_fast32_t) sid + 1;
+    }
+    if (n_channels > transport->max_streams) {
+        n_channels = transport->max_streams;
+    }
 
-        // Close trace file (if any)
-        if (transport->trace_handle) {
-            if (fclose(transport->trace_handle)) {
-                DEBUG_WARNING("Could not close trace file, reason: %m\n", errno);
-            }
-            transport->trace_handle = NULL;
-        }
+    // Grow
+    DEBUG_PRINTF("Growing channel array from %"PRIuFAST16" to %"PRIuFAST32" entries\n",
+                 transport->n_channels, n_channels);
+    error = data_channels_alloc(
+            &transport->channels, (uint_fast16_t) n_channels, transport->n_channels);
+    if (error) {
+        return error;
     }
+    transport->n_channels = (uint_fast16_t) n_channels;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-    // Set state
-    transport->state = state;
+/*
+ * Set the amount of streams to be requested when the association is
+ * being established.
+ */
+static enum rawrtc_code set_init_streams(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    struct sctp_initmsg init = {0};
 
-    // Connected?
-    // Note: This needs to be done after the state has been updated because it uses the
-    //       send function which checks the state.
-    if (state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
-        enum rawrtc_code error;
-        enum rawrtc_data_channel_state const from_channel_state =
-                RAWRTC_DATA_CHANNEL_STATE_CONNECTING;
-        DEBUG_INFO("SCTP connection established\n");
+    // Request the maximum amount of outgoing streams and allow the other peer to open up to the
+    // maximum amount of streams (see RFC 8831, section 6.2)
+    // Note: Only the data channel array is grown on demand. Peers do not support adding streams
+    //       later on reliably.
+    init.sinit_num_ostreams = transport->max_streams;
+    init.sinit_max_instreams = transport->max_streams;
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_INITMSG, &init, sizeof(init))) {
+        DEBUG_WARNING("Could not set amount of streams, reason: %m\n", errno);
+        return rawrtc_error_to_code(errno);
+    }
 
-        // Send deferred messages
-        error = sctp_send_deferred_messages(transport);
-        if (error && error != RAWRTC_CODE_STOP_ITERATION) {
-            DEBUG_WARNING("Could not send deferred messages, reason: %s\n",
-                          rawrtc_code_to_str(error));
-        }
-
-        // Open waiting channels
-        // Note: This call must be above calling the state handler to prevent the user from
-        //       being able to close the transport before the data channels are being opened.
-        set_data_channel_states(transport, RAWRTC_DATA_CHANNEL_STATE_OPEN, &from_channel_state);
-    }
-
-    // Call handler (if any)
-    if (transport->state_change_handler) {
-        transport->state_change_handler(state, transport->arg);
-    }
+    // Done
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Reset the outgoing stream of a data channel.
- * Note: This function will only return an error in case the stream could not be reset properly
- *       In this case, the channel will be closed and removed from the transport immediately.
+ * Request additional outgoing streams (if needed and no request is
+ * currently in progress). This is only necessary in case the peer
+ * negotiated fewer streams than the maximum amount of streams. The
+ * amount of streams grows exponentially (but never beyond the maximum
+ * amount of streams).
  */
-static enum rawrtc_code reset_outgoing_stream(
-    struct rawrtc_sctp_transport* const transport, // not checked
-    struct rawrtc_data_channel* const channel // not checked
+static enum rawrtc_code add_outbound_streams(
+        struct rawrtc_sctp_transport* const transport // not checked
 ) {
-    struct sctp_reset_streams* reset_streams = NULL;
-    size_t length;
-    enum rawrtc_code error;
-
-    // Get context
-    struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
-
-    // Check if there are pending outgoing messages
-    if (!list_isempty(&transport->buffered_messages_outgoing)) {
-        context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET;
+    struct sctp_add_streams add = {0};
+    uint_fast32_t n_streams;
+
+    // Check state and whether there's anything to do
+    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED ||
+            transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_ADDING_STREAMS ||
+            transport->n_outbound_streams >= transport->max_streams ||
+            transport->n_outbound_streams_wanted <= transport->n_outbound_streams) {
         return RAWRTC_CODE_SUCCESS;
     }
 
-    // Calculate length
-    length = sizeof(*reset_streams) + sizeof(uint16_t);
-
-    // Allocate
-    reset_streams = mem_zalloc(length, NULL);
-    if (!reset_streams) {
-        error = RAWRTC_CODE_NO_MEMORY;
-        goto out;
+    // Calculate new amount of outgoing streams
+    n_streams = (uint_fast32_t) transport->n_outbound_streams * 2;
+    if (n_streams < transport->n_outbound_streams_wanted) {
+        n_streams = transport->n_outbound_streams_wanted;
     }
-
-    // Set fields
-    reset_streams->srs_flags = SCTP_STREAM_RESET_OUTGOING;
-    reset_streams->srs_number_streams = 1;
-    reset_streams->srs_stream_list[0] = context->sid;
-
-    // Reset stream
-    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_RESET_STREAMS,
-                           reset_streams, (socklen_t) length)) {
-        error = rawrtc_error_to_code(errno);
-        goto out;
+    if (n_streams > transport->max_streams) {
+        n_streams = transport->max_streams;
     }
 
-    // Done
-    DEBUG_PRINTF("Outgoing stream %"PRIu16" reset procedure started\n", context->sid);
-    error = RAWRTC_CODE_SUCCESS;
-
-out:
-    // Un-reference
-    mem_deref(reset_streams);
-
-    if (error) {
-        // Improper closing
-        DEBUG_WARNING("Could not reset outgoing stream %"PRIu16", reason: %s, closing channel "
-                      "improperly\n", context->sid, rawrtc_code_to_str(error));
-
-        // Close
-        rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
-
-        // Sanity check
-        if (!channel_registered(transport, channel)) {
-            return RAWRTC_CODE_SCTP_TRANSPORT_ERROR;
+    // Request streams
+    add.sas_assoc_id = SCTP_ALL_ASSOC;
+    add.sas_outstrms = (uint16_t) (n_streams - transport->n_outbound_streams);
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_ADD_STREAMS,
+                           &add, sizeof(add))) {
+        // Another reconfiguration request is in progress, retry once it has been completed
+        if (errno == EBUSY || errno == EALREADY) {
+            DEBUG_NOTICE("Reconfiguration in progress, adding streams later\n");
+            return RAWRTC_CODE_SUCCESS;
         }
+        DEBUG_WARNING("Could not add %"PRIu16" outgoing streams, reason: %m\n",
+                      add.sas_outstrms, errno);
+        return rawrtc_error_to_code(errno);
+    }
 
-        // Remove from transport
-        transport->channels[context->sid] = mem_deref(channel);
+    // Set flag & done
+    DEBUG_PRINTF("Requested %"PRIu16" additional outgoing streams\n", add.sas_outstrms);
+    transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_ADDING_STREAMS;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Ensure an outgoing stream exists for the stream identifier.
+ * Messages of that stream will be held back until the stream has been
+ * added.
+ */
+static enum rawrtc_code want_outbound_stream(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        uint_fast16_t const sid
+) {
+    // Update amount of wanted outgoing streams
+    if (sid >= transport->n_outbound_streams_wanted) {
+        transport->n_outbound_streams_wanted = (uint16_t) (sid + 1);
     }
-    return error;
+
+    // Request streams (if needed)
+    return add_outbound_streams(transport);
 }
 
 /*
- * Print debug information for an SCTP association change event.
+ * Apply the stream scheduler to the socket.
  */
-int debug_association_change_event(
-        struct re_printf* const pf,
-        struct sctp_assoc_change* const event
+static enum rawrtc_code set_scheduler(
+        struct rawrtc_sctp_transport* const transport // not checked
 ) {
-    int err = 0;
-    uint_fast32_t length;
-    uint_fast32_t i;
+    struct sctp_assoc_value av;
 
-    switch (event->sac_state) {
-        case SCTP_COMM_UP:
-            err |= re_hprintf(pf, "SCTP_COMM_UP");
-            break;
-        case SCTP_COMM_LOST:
-            err |= re_hprintf(pf, "SCTP_COMM_LOST");
+    // Translate scheduler
+    switch (transport->scheduler) {
+        case RAWRTC_SCTP_TRANSPORT_SCHEDULER_ROUND_ROBIN:
+            av.assoc_value = SCTP_SS_ROUND_ROBIN;
             break;
-        case SCTP_RESTART:
-            err |= re_hprintf(pf, "SCTP_RESTART");
+        case RAWRTC_SCTP_TRANSPORT_SCHEDULER_FIRST_COME:
+            av.assoc_value = SCTP_SS_FIRST_COME;
             break;
-        case SCTP_SHUTDOWN_COMP:
-            err |= re_hprintf(pf, "SCTP_SHUTDOWN_COMP");
+        case RAWRTC_SCTP_TRANSPORT_SCHEDULER_PRIORITY:
+            av.assoc_value = SCTP_SS_PRIORITY;
             break;
-        case SCTP_CANT_STR_ASSOC:
-            err |= re_hprintf(pf, "SCTP_CANT_STR_ASSOC");
+        case RAWRTC_SCTP_TRANSPORT_SCHEDULER_FAIR_BANDWIDTH:
+            av.assoc_value = SCTP_SS_FAIR_BANDWIDTH;
             break;
         default:
-            err |= re_hprintf(pf, "???");
-            break;
+            return RAWRTC_CODE_INVALID_ARGUMENT;
     }
-    err |= re_hprintf(pf, ", streams (in/out) = (%"PRIu16"/%"PRIu16")",
-               event->sac_inbound_streams, event->sac_outbound_streams);
-    length = event->sac_length - sizeof(*event);
-    if (length > 0) {
-        switch (event->sac_state) {
-            case SCTP_COMM_UP:
-            case SCTP_RESTART:
-                err |= re_hprintf(pf, ", supports");
-                for (i = 0; i < length; ++i) {
-                    switch (event->sac_info[i]) {
-                        case SCTP_ASSOC_SUPPORTS_PR:
-                            err |= re_hprintf(pf, " PR");
-                            break;
-                        case SCTP_ASSOC_SUPPORTS_AUTH:
-                            err |= re_hprintf(pf, " AUTH");
-                            break;
-                        case SCTP_ASSOC_SUPPORTS_ASCONF:
-                            err |= re_hprintf(pf, " ASCONF");
-                            break;
-                        case SCTP_ASSOC_SUPPORTS_MULTIBUF:
-                            err |= re_hprintf(pf, " MULTIBUF");
-                            break;
-                        case SCTP_ASSOC_SUPPORTS_RE_CONFIG:
-                            err |= re_hprintf(pf, " RE-CONFIG");
-                            break;
-                        default:
-                            err |= re_hprintf(pf, " ??? (0x%02x)", event->sac_info[i]);
-                            break;
-                    }
-                }
-                break;
-            case SCTP_COMM_LOST:
-            case SCTP_CANT_STR_ASSOC:
-                err |= re_hprintf(pf, ", ABORT =");
-                for (i = 0; i < length; ++i) {
-                    err |= re_hprintf(pf, " 0x%02x", event->sac_info[i]);
-                }
-                break;
-            default:
-                break;
-        }
+
+    // Set scheduler
+    av.assoc_id = SCTP_ALL_ASSOC;
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_PLUGGABLE_SS,
+                           &av, sizeof(av))) {
+        DEBUG_WARNING("Could not set stream scheduler, reason: %m\n", errno);
+        return rawrtc_error_to_code(errno);
     }
-    err |= re_hprintf(pf, "\n");
-    return err;
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Print debug information for an SCTP partial delivery event.
+ * Apply the priority of a data channel to its outgoing stream (if the
+ * priority scheduler is being used).
+ * Note: The stream must exist. usrsctp sends streams with a lower
+ *       value first, so the priority will be inverted.
  */
-int debug_partial_delivery_event(
-        struct re_printf* const pf,
-        struct sctp_pdapi_event* const event
+static enum rawrtc_code set_stream_priority(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel* const channel, // not checked
+        struct rawrtc_sctp_data_channel_context* const context // not checked
 ) {
-    int err = 0;
+    struct sctp_stream_value value = {0};
 
-    switch (event->pdapi_indication) {
-        case SCTP_PARTIAL_DELIVERY_ABORTED:
-            re_hprintf(pf, "Partial delivery aborted ");
-            break;
-        default:
-            re_hprintf(pf, "??? ");
-            break;
+    // Stream values are only supported by the priority scheduler
+    if (transport->scheduler != RAWRTC_SCTP_TRANSPORT_SCHEDULER_PRIORITY) {
+        return RAWRTC_CODE_SUCCESS;
     }
-    err |= re_hprintf(pf, "(flags = %x) ", event->pdapi_flags);
-    err |= re_hprintf(pf, "stream = %"PRIu32" ", event->pdapi_stream);
-    err |= re_hprintf(pf, "sn = %"PRIu32, event->pdapi_seq);
-    err |= re_hprintf(pf, "\n");
-    return err;
+
+    // Set priority
+    value.assoc_id = SCTP_ALL_ASSOC;
+    value.stream_id = context->sid;
+    value.stream_value = (uint16_t) (UINT16_MAX - channel->parameters->priority);
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_SS_VALUE,
+                           &value, sizeof(value))) {
+        DEBUG_WARNING("Could not set priority of stream %"PRIu16", reason: %m\n",
+                      context->sid, errno);
+        return rawrtc_error_to_code(errno);
+    }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Print debug information for an SCTP send failed event.
+ * Apply the priorities of all data channels to their outgoing streams
+ * (if the stream exists and the priority scheduler is being used).
  */
-int debug_send_failed_event(
-        struct re_printf* const pf,
-        struct sctp_send_failed_event* const event
+static void apply_stream_priorities(
+        struct rawrtc_sctp_transport* const transport // not checked
 ) {
-    int err = 0;
+    uint_fast32_t i;
 
-    if (event->ssfe_flags & SCTP_DATA_UNSENT) {
-        err |= re_hprintf(pf, "Unsent ");
-    }
-    if (event->ssfe_flags & SCTP_DATA_SENT) {
-        err |= re_hprintf(pf, "Sent ");
+    // Stream values are only supported by the priority scheduler
+    if (transport->scheduler != RAWRTC_SCTP_TRANSPORT_SCHEDULER_PRIORITY) {
+        return;
     }
-    if (event->ssfe_flags & ~(SCTP_DATA_SENT | SCTP_DATA_UNSENT)) {
-        err |= re_hprintf(pf, "(flags = %x) ", event->ssfe_flags);
+
+    for (i = 0; i < transport->n_channels && i < transport->n_outbound_streams; ++i) {
+        struct rawrtc_data_channel* const channel = transport->channels[i];
+        if (channel) {
+            // Note: Failing to apply a priority is not fatal
+            set_stream_priority(transport, channel, channel->transport_arg);
+        }
     }
-    err |= re_hprintf(
-            pf,
-            "message with PPID %"PRIu32", SID = %"PRIu16", flags: 0x%04x due to error = 0x%08x\n",
-            ntohl(event->ssfe_info.snd_ppid), event->ssfe_info.snd_sid,
-            event->ssfe_info.snd_flags, event->ssfe_error);
-    return err;
 }
 
 /*
- * Print debug information for an SCTP stream reset event.
+ * Offer message interleaving (I-DATA) to the other peer.
+ * Note: This requires fragments of messages on different streams to be
+ *       interleaved on the receiving side (level 2) as well.
  */
-int debug_stream_reset_event(
-        struct re_printf* const pf,
-        struct sctp_stream_reset_event* const event
+static enum rawrtc_code enable_interleaving(
+        struct rawrtc_sctp_transport* const transport // not checked
 ) {
-    int err = 0;
-    uint_fast32_t length;
-    uint_fast32_t i;
-
-    // Get #sid's
-    length = (event->strreset_length - sizeof(*event)) / sizeof(uint16_t);
+    struct sctp_assoc_value av;
+    int option_value;
 
-    err |= re_hprintf(pf, "flags = %x, ", event->strreset_flags);
-    if (event->strreset_flags & SCTP_STREAM_RESET_INCOMING_SSN) {
-        if (event->strreset_flags & SCTP_STREAM_RESET_OUTGOING_SSN) {
-            err |= re_hprintf(pf, "incoming/");
-        }
-        err |= re_hprintf(pf, "incoming ");
-    }
-    if (event->strreset_flags & SCTP_STREAM_RESET_OUTGOING_SSN) {
-        err |= re_hprintf(pf, "outgoing ");
+    // Allow interleaving fragments of messages on different streams (incoming)
+    option_value = 2;
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_FRAGMENT_INTERLEAVE,
+                           &option_value, sizeof(option_value))) {
+        DEBUG_WARNING("Could not set fragment interleave level, reason: %m\n", errno);
+        return rawrtc_error_to_code(errno);
     }
-    err |= re_hprintf(pf, "stream ids = ");
-    for (i = 0; i < length; ++i) {
-        if (i > 0) {
-            err |= re_hprintf(pf, ", ");
-        }
-        err |= re_hprintf(pf, "%"PRIu16, event->strreset_stream_list[i]);
+
+    // Offer the I-DATA extension (outgoing)
+    av.assoc_id = SCTP_FUTURE_ASSOC;
+    av.assoc_value = 1;
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_INTERLEAVING_SUPPORTED,
+                           &av, sizeof(av))) {
+        DEBUG_WARNING("Could not enable message interleaving, reason: %m\n", errno);
+        return rawrtc_error_to_code(errno);
     }
-    err |= re_hprintf(pf, "\n");
-    return err;
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Handle SCTP association change event.
+ * Set the send information for an SCTP message on the data channel.
  */
-static void handle_association_change_event(
-        struct rawrtc_sctp_transport* const transport,
-        struct sctp_assoc_change* const event
+static enum rawrtc_code set_send_info(
+        struct sctp_sendv_spa* const spa, // not checked
+        struct rawrtc_data_channel* const channel, // nullable (if DCEP message)
+        struct rawrtc_sctp_data_channel_context* const context, // not checked
+        uint_fast32_t const ppid
 ) {
-    // Print debug output for event
-    DEBUG_PRINTF("Association change: %H", debug_association_change_event, event);
+    // Set stream identifier, protocol identifier and flags
+    spa->sendv_sndinfo.snd_sid = context->sid;
+    spa->sendv_sndinfo.snd_flags = SCTP_EOR; // TODO: Update signature
+    spa->sendv_sndinfo.snd_ppid = htonl((uint32_t) ppid);
+    spa->sendv_flags = SCTP_SEND_SNDINFO_VALID;
 
-    // Handle state
-    switch (event->sac_state) {
-        case SCTP_COMM_UP:
-            // Connected
-            if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTING) {
-                set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED);
-            }
-            break;
-        case SCTP_RESTART:
-            // TODO: Handle?
-            break;
-        case SCTP_CANT_STR_ASSOC:
-        case SCTP_SHUTDOWN_COMP:
-        case SCTP_COMM_LOST:
-            // Disconnected
-            // TODO: Is this the correct behaviour?
-            if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-                set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CLOSED);
-            }
-            break;
-        default:
-            break;
+    // Set ordered/unordered and partial reliability policy
+    if (ppid != RAWRTC_SCTP_TRANSPORT_PPID_DCEP) {
+        // Check channel
+        if (!channel) {
+            return RAWRTC_CODE_INVALID_ARGUMENT;
+        }
+
+        // Unordered?
+        if (channel->parameters->channel_type & RAWRTC_DATA_CHANNEL_TYPE_IS_UNORDERED &&
+                context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED) {
+            spa->sendv_sndinfo.snd_flags |= SCTP_UNORDERED;
+        }
+
+        // Partial reliability policy
+        switch (ppid) {
+            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_ORDERED_RETRANSMIT:
+            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_UNORDERED_RETRANSMIT:
+                // Set amount of retransmissions
+                spa->sendv_prinfo.pr_policy = SCTP_PR_SCTP_RTX;
+                spa->sendv_prinfo.pr_value = channel->parameters->reliability_parameter;
+                spa->sendv_flags |= SCTP_SEND_PRINFO_VALID;
+            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_ORDERED_TIMED:
+            case RAWRTC_DATA_CHANNEL_TYPE_UNRELIABLE_UNORDERED_TIMED:
+                // Set TTL
+                spa->sendv_prinfo.pr_policy = SCTP_PR_SCTP_TTL;
+                spa->sendv_prinfo.pr_value = channel->parameters->reliability_parameter;
+                spa->sendv_flags |= SCTP_SEND_PRINFO_VALID;
+            default:
+                // Nothing to do
+                break;
+        }
     }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Handle SCTP partial delivery event.
+ * Send an SCTP message on the data channel.
+ * TODO: Add EOR marking and some kind of an id (does ndata provide that?)
  */
-static void handle_partial_delivery_event(
-        struct rawrtc_sctp_transport* const transport,
-        struct sctp_pdapi_event* const event
+static enum rawrtc_code send_message(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel* const channel, // nullable (if DCEP message)
+        struct rawrtc_sctp_data_channel_context* const context, // not checked
+        struct mbuf* const buffer, // not checked
+        uint_fast32_t const ppid
 ) {
-    uint16_t sid;
-    struct rawrtc_data_channel* channel;
-    struct rawrtc_sctp_data_channel_context* context;
-
-    // Print debug output for event
-    DEBUG_PRINTF("Partial delivery event: %H", debug_partial_delivery_event, event);
+    struct sctp_sendv_spa spa = {0};
+    enum rawrtc_code error;
 
-    // Validate stream ID
-    if (event->pdapi_stream >= UINT16_MAX) {
-        DEBUG_WARNING("Invalid stream id in partial delivery event: %"PRIu32"\n",
-                      event->pdapi_stream);
-        return;
+    // Set send info
+    error = set_send_info(&spa, channel, context, ppid);
+    if (error) {
+        return error;
     }
-    sid = (uint16_t) event->pdapi_stream;
 
-    // Check if channel exists
-    // TODO: Need to check if channel is open?
-    if (sid >= transport->n_channels || !transport->channels[sid]) {
-        DEBUG_NOTICE("No channel registered for sid %"PRIu16"\n", sid);
-        return;
+    // Send message
+    // Note: DCEP messages are not accounted for in the channel's buffered amount
+    DEBUG_PRINTF("Sending message with SID %"PRIu16", PPID: %"PRIu32"\n", context->sid, ppid);
+    error = transport_send(
+            transport, channel ? context : NULL, buffer, &spa, sizeof(spa), SCTP_SENDV_SPA, 0);
+    if (error) {
+        DEBUG_WARNING("Unable to send message, reason: %s\n", rawrtc_code_to_str(error));
+        return error;
     }
 
-    // Get channel and context
-    channel = transport->channels[sid];
-    context = channel->transport_arg;
+    // Done
+    return RAWRTC_CODE_SUCCESS;
+}
 
-    // Abort pending message
-    if (context->buffer_inbound) {
-        DEBUG_NOTICE("Abort partially delivered message of %zu bytes\n",
-                     mbuf_get_left(context->buffer_inbound));
-        context->buffer_inbound = mem_deref(context->buffer_inbound);
+/*
+ * Change the states of all data channels.
+ * Caller MUST ensure that the same state is not set twice.
+ */
+static void set_data_channel_states(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        enum rawrtc_data_channel_state const to_state,
+        enum rawrtc_data_channel_state const * const from_state // optional current state
+) {
+    uint_fast16_t i;
 
-        // Sanity-check
-        if (channel->options->deliver_partially) {
-            DEBUG_WARNING("We deliver partially but there was a buffered message?!\n");
+    // Set state on all data channels
+    for (i = 0; i < transport->n_channels; ++i) {
+        struct rawrtc_data_channel* const channel = transport->channels[i];
+        if (!channel) {
+            continue;
         }
-    }
 
-    // Pass abort notification to handler
-    if (channel->options->deliver_partially) {
-        enum rawrtc_data_channel_message_flag const message_flags =
-                RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_ABORTED;
-        if (channel->message_handler) {
-            channel->message_handler(NULL, message_flags, channel->arg);
-        } else {
-            DEBUG_NOTICE("No message handler, message abort notification has been discarded\n");
+        // Update state
+        if (!from_state || channel->state == *from_state) {
+            rawrtc_data_channel_set_state(channel, to_state);
         }
     }
 }
 
 /*
- * Handle SCTP send failed event.
+ * Close all data channels.
+ * Warning: This will not use the closing procedure, use `channel_close_handler` instead.
  */
-static void handle_send_failed_event(
-        struct rawrtc_sctp_transport* const transport,
-        struct sctp_send_failed_event* const event
+static void close_data_channels(
+        struct rawrtc_sctp_transport* const transport // not checked
 ) {
-    // Print debug output for event
-    DEBUG_PRINTF("Send failed event: %H", debug_send_failed_event, event);
-    (void) transport;
-    (void) event;
-}
+    uint_fast16_t i;
 
-/*
- * Raise buffered amount low on a data channel.
- */
-static void raise_buffered_amount_low_event(
-        struct rawrtc_data_channel* const channel // not checked
-) {
-    // Check for event handler
-    if (channel->buffered_amount_low_handler) {
-        // Get context
-        struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
-        (void) context;
+    // Set state on all data channels
+    for (i = 0; i < transport->n_channels; ++i) {
+        struct rawrtc_data_channel* const channel = transport->channels[i];
+        if (!channel) {
+            continue;
+        }
 
-        // Raise event
-        DEBUG_PRINTF("Raising buffered amount low event on channel with SID %"PRIu16"\n",
-                     context->sid);
-        channel->buffered_amount_low_handler(channel->arg);
+        // Update state
+        DEBUG_PRINTF("Closing channel with SID %"PRIu16"\n", i);
+        rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
+
+        // Remove from transport
+        transport->channels[i] = mem_deref(channel);
     }
+
+    // Remove channels waiting for a buffered amount low event
+    list_flush(&transport->buffered_amount_high_channels);
 }
 
 /*
- * Handle SCTP sender dry (no outstanding data) event.
+ * Change the state of the SCTP transport.
+ * Will call the corresponding handler.
+ * Caller MUST ensure that the same state is not set twice.
  */
-static void handle_sender_dry_event(
-        struct rawrtc_sctp_transport* const transport,
-        struct sctp_sender_dry_event* const event
+static void set_state(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        enum rawrtc_sctp_transport_state const state
 ) {
-    uint_fast16_t i;
-    uint_fast16_t stop;
-    (void) event;
+    // Closed?
+    if (state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        DEBUG_INFO("SCTP connection closed\n");
 
-    // If there are outstanding messages, don't raise an event
-    if (!list_isempty(&transport->buffered_messages_outgoing)) {
-        DEBUG_PRINTF("Pending messages, ignoring sender dry event\n");
-        return;
-    }
+        // Close all data channels
+        close_data_channels(transport);
 
-    // Set buffered amount low
-    transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW;
+        // Remove from DTLS transport
+        // Note: No NULL checking needed as the function will do that for us
+        rawrtc_dtls_transport_clear_data_transport(transport->dtls_transport);
 
-    // Reset counter if #channels has been reduced
-    if (transport->current_channel_sid >= transport->n_channels) {
-        i = 0;
-    } else {
-        i = transport->current_channel_sid;
-    }
+        // Close socket and deregister transport
+        if (transport->socket) {
+            usrsctp_close(transport->socket);
+            usrsctp_deregister_address(transport);
+            list_unlink(&transport->le);
+            transport->socket = NULL;
+        }
 
-    // Raise event on each data channel
-    stop = i;
-    do {
-        struct rawrtc_data_channel* const channel = transport->channels[i];
-        if (channel) {
-            struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
+        // Cancel deferred event processing
+        tmr_cancel(&transport->event_timer);
 
-            // Handle flags
-            if (context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET) {
-                // Reset pending outgoing stream
-                // TODO: This should probably be handled earlier but requires having separate
-                //       lists for each data channel to be sure that the stream is not reset before
-                //       all pending messages have been sent.
-                reset_outgoing_stream(transport, channel);
-                context->flags &= ~RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET;
-            } else {
-                // Raise event
-                raise_buffered_amount_low_event(transport->channels[i]);
+        // Close trace file (if any)
+        if (transport->trace_handle) {
+            if (fclose(transport->trace_handle)) {
+                DEBUG_WARNING("Could not close trace file, reason: %m\n", errno);
             }
+            transport->trace_handle = NULL;
         }
+    }
 
-        // Update/wrap
-        // Note: uint16 is sufficient here as the maximum number of channels is
-        //       65534, so 65535 will still fit
-        i = (i + 1) % transport->n_channels;
+    // Set state
+    transport->state = state;
 
-        // Stop if the flag has been cleared
-        if (!(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW)) {
-            break;
-        }
-    } while (i != stop);
+    // Connected?
+    // Note: This needs to be done after the state has been updated because it uses the
+    //       send function which checks the state.
+    if (state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
+        enum rawrtc_code error;
+        enum rawrtc_data_channel_state const from_channel_state =
+                RAWRTC_DATA_CHANNEL_STATE_CONNECTING;
+        DEBUG_INFO("SCTP connection established\n");
 
-    // Update current channel SID
-    transport->current_channel_sid = i;
-}
+        // Apply priorities of data channels created in the meantime
+        apply_stream_priorities(transport);
 
-/*
- * Handle stream reset event (data channel closed).
- */
-static void handle_stream_reset_event(
-        struct rawrtc_sctp_transport* const transport,
-        struct sctp_stream_reset_event* const event
-) {
-    uint_fast32_t length;
-    uint_fast32_t i;
+        // Request outgoing streams for data channels created in the meantime (if needed)
+        error = add_outbound_streams(transport);
+        if (error) {
+            DEBUG_WARNING("Could not add outgoing streams, reason: %s\n",
+                          rawrtc_code_to_str(error));
+        }
 
-    // Get #sid's
-    length = (event->strreset_length - sizeof(*event)) / sizeof(uint16_t);
+        // Release messages whose outgoing stream has been negotiated
+        release_pending_messages(transport);
 
-    // Print debug output for event
-    DEBUG_PRINTF("Stream reset event: %H", debug_stream_reset_event, event, length);
+        // Send deferred messages (if not corked)
+        if (can_send_deferred(transport)) {
+            error = sctp_send_deferred_messages(transport);
+            if (error && error != RAWRTC_CODE_STOP_ITERATION) {
+                DEBUG_WARNING("Could not send deferred messages, reason: %s\n",
+                              rawrtc_code_to_str(error));
+            }
+        }
 
-    // Ignore denied/failed events
-    if (event->strreset_flags & SCTP_STREAM_RESET_DENIED
-        || event->strreset_flags & SCTP_STREAM_RESET_FAILED) {
-        return;
+        // Open waiting channels
+        // Note: This call must be above calling the state handler to prevent the user from
+        //       being able to close the transport before the data channels are being opened.
+        set_data_channel_states(transport, RAWRTC_DATA_CHANNEL_STATE_OPEN, &from_channel_state);
     }
 
-    // Handle stream resets
-    for (i = 0; i < length; ++i) {
-        uint_fast16_t const sid = (uint_fast16_t) event->strreset_stream_list[i];
-        struct rawrtc_data_channel* channel;
-        struct rawrtc_sctp_data_channel_context* context;
+    // Call handler (if any)
+    if (transport->state_change_handler) {
+        transport->state_change_handler(state, transport->arg);
+    }
+}
 
-        // Check if channel exists
-        if (sid >= transport->n_channels || !transport->channels[sid]) {
-            DEBUG_NOTICE("No channel registered for sid %"PRIuFAST16"\n", sid);
-            continue;
-        }
+/*
+ * Reset the outgoing stream of a data channel.
+ * Note: This function will only return an error in case the stream could not be reset properly
+ *       In this case, the channel will be closed and removed from the transport immediately.
+ */
+static enum rawrtc_code reset_outgoing_stream(
+    struct rawrtc_sctp_transport* const transport, // not checked
+    struct rawrtc_data_channel* const channel // not checked
+) {
+    struct sctp_reset_streams* reset_streams = NULL;
+    size_t length;
+    enum rawrtc_code error;
 
-        // Get channel and context
-        channel = transport->channels[sid];
-        context = channel->transport_arg;
+    // Get context
+    struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
 
-        // Incoming stream reset
-        if (event->strreset_flags & SCTP_STREAM_RESET_INCOMING_SSN) {
-            // Set flag
-            channel->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_INCOMING_STREAM_RESET;
+    // Check if there are pending outgoing messages (or a partially sent message)
+    if (!rawrtc_message_buffer_is_empty(&transport->buffered_messages_outgoing) ||
+            context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE) {
+        context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET;
+        return RAWRTC_CODE_SUCCESS;
+    }
 
-            // Reset outgoing stream (if needed)
-            if (channel->state != RAWRTC_DATA_CHANNEL_STATE_CLOSING
-                && channel->state != RAWRTC_DATA_CHANNEL_STATE_CLOSED) {
-                if (reset_outgoing_stream(transport, channel)) {
-                    // Error, channel has been closed automatically
-                    continue;
-                }
+    // Calculate length
+    length = sizeof(*reset_streams) + sizeof(uint16_t);
 
-                // Set to closing
-                rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSING);
-            }
-        }
+    // Allocate
+    reset_streams = mem_zalloc(length, NULL);
+    if (!reset_streams) {
+        error = RAWRTC_CODE_NO_MEMORY;
+        goto out;
+    }
 
-        // Outgoing stream reset (this is raised from our own stream reset)
-        if (event->strreset_flags & SCTP_STREAM_RESET_OUTGOING_SSN) {
-            // Set flag
-            channel->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTGOING_STREAM_RESET;
-        }
+    // Set fields
+    reset_streams->srs_flags = SCTP_STREAM_RESET_OUTGOING;
+    reset_streams->srs_number_streams = 1;
+    reset_streams->srs_stream_list[0] = context->sid;
 
-        // Close if both incoming and outgoing stream has been reset
-        if (channel->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_INCOMING_STREAM_RESET
-            && channel->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTGOING_STREAM_RESET) {
-            // Set to closed
-            rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
+    // Reset stream
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_RESET_STREAMS,
+                           reset_streams, (socklen_t) length)) {
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
 
-            // Remove from transport
-            transport->channels[context->sid] = mem_deref(channel);
+    // Done
+    DEBUG_PRINTF("Outgoing stream %"PRIu16" reset procedure started\n", context->sid);
+    error = RAWRTC_CODE_SUCCESS;
+
+out:
+    // Un-reference
+    mem_deref(reset_streams);
+
+    if (error) {
+        // Improper closing
+        DEBUG_WARNING("Could not reset outgoing stream %"PRIu16", reason: %s, closing channel "
+                      "improperly\n", context->sid, rawrtc_code_to_str(error));
+
+        // Close
+        rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
+
+        // Sanity check
+        if (!channel_registered(transport, channel)) {
+            return RAWRTC_CODE_SCTP_TRANSPORT_ERROR;
         }
+
+        // Remove from transport
+        transport->channels[context->sid] = mem_deref(channel);
     }
+    return error;
 }
 
 /*
- * Handle SCTP notification.
+ * Print debug information for an SCTP association change event.
  */
-static void handle_notification(
-        struct rawrtc_sctp_transport* const transport,
-        struct mbuf* const buffer
+int debug_association_change_event(
+        struct re_printf* const pf,
+        struct sctp_assoc_change* const event
 ) {
-    union sctp_notification* const notification = (union sctp_notification*) buffer->buf;
-
-    // TODO: Are all of these checks necessary or can we reduce that?
-#if (SIZE_MAX > UINT32_MAX)
-    if (buffer->end > UINT32_MAX) {
-        return;
-    }
-#endif
-#if (UINT32_MAX > SIZE_MAX)
-    if (notification->sn_header.sn_length > SIZE_MAX) {
-        return;
-    }
-#endif
-    if (notification->sn_header.sn_length != buffer->end) {
-        return;
-    }
+    int err = 0;
+    uint_fast32_t length;
+    uint_fast32_t i;
 
-    // Handle notification by type
-    switch (notification->sn_header.sn_type) {
-        case SCTP_ASSOC_CHANGE:
-            handle_association_change_event(transport, &notification->sn_assoc_change);
-            break;
-        case SCTP_PARTIAL_DELIVERY_EVENT:
-            handle_partial_delivery_event(transport, &notification->sn_pdapi_event);
-            break;
-        case SCTP_SEND_FAILED_EVENT:
-            handle_send_failed_event(transport, &notification->sn_send_failed_event);
+    switch (event->sac_state) {
+        case SCTP_COMM_UP:
+            err |= re_hprintf(pf, "SCTP_COMM_UP");
             break;
-        case SCTP_SENDER_DRY_EVENT:
-            handle_sender_dry_event(transport, &notification->sn_sender_dry_event);
+        case SCTP_COMM_LOST:
+            err |= re_hprintf(pf, "SCTP_COMM_LOST");
             break;
-        case SCTP_SHUTDOWN_EVENT:
-            // TODO: Stop sending (this is a bit tricky to implement, so skipping for now)
-            //handle_shutdown_event(transport, &notification->sn_shutdown_event);
+        case SCTP_RESTART:
+            err |= re_hprintf(pf, "SCTP_RESTART");
             break;
-        case SCTP_STREAM_CHANGE_EVENT:
-            // TODO: Handle
-            DEBUG_WARNING("TODO: HANDLE STREAM CHANGE\n");
-            // handle_stream_change_event(transport, ...);
+        case SCTP_SHUTDOWN_COMP:
+            err |= re_hprintf(pf, "SCTP_SHUTDOWN_COMP");
             break;
-        case SCTP_STREAM_RESET_EVENT:
-            handle_stream_reset_event(transport, &notification->sn_strreset_event);
+        case SCTP_CANT_STR_ASSOC:
+            err |= re_hprintf(pf, "SCTP_CANT_STR_ASSOC");
             break;
         default:
-            DEBUG_WARNING("Unexpected notification event: %"PRIu16"\n",
-                          notification->sn_header.sn_type);
+            err |= re_hprintf(pf, "???");
             break;
     }
+    err |= re_hprintf(pf, ", streams (in/out) = (%"PRIu16"/%"PRIu16")",
+               event->sac_inbound_streams, event->sac_outbound_streams);
+    length = event->sac_length - sizeof(*event);
+    if (length > 0) {
+        switch (event->sac_state) {
+            case SCTP_COMM_UP:
+            case SCTP_RESTART:
+                err |= re_hprintf(pf, ", supports");
+                for (i = 0; i < length; ++i) {
+                    switch (event->sac_info[i]) {
+                        case SCTP_ASSOC_SUPPORTS_PR:
+                            err |= re_hprintf(pf, " PR");
+                            break;
+                        case SCTP_ASSOC_SUPPORTS_AUTH:
+                            err |= re_hprintf(pf, " AUTH");
+                            break;
+                        case SCTP_ASSOC_SUPPORTS_ASCONF:
+                            err |= re_hprintf(pf, " ASCONF");
+                            break;
+                        case SCTP_ASSOC_SUPPORTS_MULTIBUF:
+                            err |= re_hprintf(pf, " MULTIBUF");
+                            break;
+                        case SCTP_ASSOC_SUPPORTS_RE_CONFIG:
+                            err |= re_hprintf(pf, " RE-CONFIG");
+                            break;
+                        case SCTP_ASSOC_SUPPORTS_INTERLEAVING:
+                            err |= re_hprintf(pf, " INTERLEAVING");
+                            break;
+                        default:
+                            err |= re_hprintf(pf, " ??? (0x%02x)", event->sac_info[i]);
+                            break;
+                    }
+                }
+                break;
+            case SCTP_COMM_LOST:
+            case SCTP_CANT_STR_ASSOC:
+                err |= re_hprintf(pf, ", ABORT =");
+                for (i = 0; i < length; ++i) {
+                    err |= re_hprintf(pf, " 0x%02x", event->sac_info[i]);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    err |= re_hprintf(pf, "\n");
+    return err;
 }
 
 /*
- * Handle outgoing SCTP messages.
+ * Print debug information for an SCTP partial delivery event.
  */
-static int sctp_packet_handler(
-        void* arg,
-        void* buffer,
-        size_t length,
-        uint8_t tos,
-        uint8_t set_df
+int debug_partial_delivery_event(
+        struct re_printf* const pf,
+        struct sctp_pdapi_event* const event
 ) {
-    struct rawrtc_sctp_transport* const transport = arg;
-    enum rawrtc_code error;
-    (void) tos; // TODO: Handle?
-    (void) set_df; // TODO: Handle?
-
-    // Lock event loop mutex
-    rawrtc_thread_enter();
+    int err = 0;
 
-    // Closed?
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        DEBUG_PRINTF("Ignoring SCTP packet ready event, transport is closed\n");
-        goto out;
+    switch (event->pdapi_indication) {
+        case SCTP_PARTIAL_DELIVERY_ABORTED:
+            re_hprintf(pf, "Partial delivery aborted ");
+            break;
+        default:
+            re_hprintf(pf, "??? ");
+            break;
     }
+    err |= re_hprintf(pf, "(flags = %x) ", event->pdapi_flags);
+    err |= re_hprintf(pf, "stream = %"PRIu32" ", event->pdapi_stream);
+    err |= re_hprintf(pf, "sn = %"PRIu32, event->pdapi_seq);
+    err |= re_hprintf(pf, "\n");
+    return err;
+}
 
-    // Trace (if trace handle)
-    // Note: No need to check if NULL as the function does it for us
-    trace_packet(transport, buffer, length, SCTP_DUMP_OUTBOUND);
-
-    // Note: We only need to copy the buffer if we add it to the outgoing queue
-    if (transport->dtls_transport->state == RAWRTC_DTLS_TRANSPORT_STATE_CONNECTED) {
-        struct mbuf mbuffer;
+/*
+ * Print debug information for an SCTP send failed event.
+ */
+int debug_send_failed_event(
+        struct re_printf* const pf,
+        struct sctp_send_failed_event* const event
+) {
+    int err = 0;
 
-        // Note: dtls_send does not reference the buffer, so we can safely fake an mbuf structure
-        // to avoid copying. This may change in the future, so be aware!
-        mbuffer.buf = buffer;
-        mbuffer.pos = 0;
-        mbuffer.size = length;
-        mbuffer.end = length;
+    if (event->ssfe_flags & SCTP_DATA_UNSENT) {
+        err |= re_hprintf(pf, "Unsent ");
+    }
+    if (event->ssfe_flags & SCTP_DATA_SENT) {
+        err |= re_hprintf(pf, "Sent ");
+    }
+    if (event->ssfe_flags & ~(SCTP_DATA_SENT | SCTP_DATA_UNSENT)) {
+        err |= re_hprintf(pf, "(flags = %x) ", event->ssfe_flags);
+    }
+    err |= re_hprintf(
+            pf,
+            "message with PPID %"PRIu32", SID = %"PRIu16", flags: 0x%04x due to error = 0x%08x\n",
+            ntohl(event->ssfe_info.snd_ppid), event->ssfe_info.snd_sid,
+            event->ssfe_info.snd_flags, event->ssfe_error);
+    return err;
+}
 
-        // Send
-        error = rawrtc_dtls_transport_send(transport->dtls_transport, &mbuffer);
-    } else {
-        int err;
+/*
+ * Print debug information for an SCTP stream reset event.
+ */
+int debug_stream_reset_event(
+        struct re_printf* const pf,
+        struct sctp_stream_reset_event* const event
+) {
+    int err = 0;
+    uint_fast32_t length;
+    uint_fast32_t i;
 
-        // Allocate
-        struct mbuf* const mbuffer = mbuf_alloc(length);
-        if (!mbuffer) {
-            DEBUG_WARNING("Could not create buffer for outgoing packet, no memory\n");
-            goto out;
-        }
+    // Get #sid's
+    length = (event->strreset_length - sizeof(*event)) / sizeof(uint16_t);
 
-        // Copy and set position
-        err = mbuf_write_mem(mbuffer, buffer, length);
-        if (err) {
-            DEBUG_WARNING("Could not write to buffer, reason: %m\n", err);
-            mem_deref(mbuffer);
-            goto out;
+    err |= re_hprintf(pf, "flags = %x, ", event->strreset_flags);
+    if (event->strreset_flags & SCTP_STREAM_RESET_INCOMING_SSN) {
+        if (event->strreset_flags & SCTP_STREAM_RESET_OUTGOING_SSN) {
+            err |= re_hprintf(pf, "incoming/");
         }
-        mbuf_set_pos(mbuffer, 0);
-
-        // Send (well, actually buffer...)
-        error = rawrtc_dtls_transport_send(transport->dtls_transport, mbuffer);
-        mem_deref(mbuffer);
+        err |= re_hprintf(pf, "incoming ");
     }
-
-    // Handle error
-    if (error) {
-        DEBUG_WARNING("Could not send packet, reason: %s\n", rawrtc_code_to_str(error));
-        goto out;
+    if (event->strreset_flags & SCTP_STREAM_RESET_OUTGOING_SSN) {
+        err |= re_hprintf(pf, "outgoing ");
     }
-
-out:
-    // Unlock event loop mutex
-    rawrtc_thread_leave();
-
-    // TODO: What does the return code do?
-    return 0;
+    err |= re_hprintf(pf, "stream ids = ");
+    for (i = 0; i < length; ++i) {
+        if (i > 0) {
+            err |= re_hprintf(pf, ", ");
+        }
+        err |= re_hprintf(pf, "%"PRIu16, event->strreset_stream_list[i]);
+    }
+    err |= re_hprintf(pf, "\n");
+    return err;
 }
 
 /*
- * Handle data channel ack message.
+ * Update the negotiated amount of streams and features of the
+ * association.
  */
-static void handle_data_channel_ack_message(
-        struct rawrtc_sctp_transport* const transport,
-        struct sctp_rcvinfo* const info
+static void update_association_features(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct sctp_assoc_change* const event // not checked
 ) {
-    struct rawrtc_sctp_data_channel_context* context;
+    uint_fast32_t const length = event->sac_length - sizeof(*event);
+    uint_fast32_t i;
 
-    // Get channel and context
-    struct rawrtc_data_channel* const channel = transport->channels[info->rcv_sid];
-    if (!channel) {
-        DEBUG_WARNING("Received ack on an invalid channel with SID %"PRIu16"\n", info->rcv_sid);
-        goto error;
-    }
-    context = channel->transport_arg;
+    // Store amount of streams
+    transport->n_inbound_streams = event->sac_inbound_streams;
+    transport->n_outbound_streams = event->sac_outbound_streams;
 
-    // TODO: We should probably track the state and close the channel if an ack is being received
-    //       on an already negotiated channel. For now, we only check that the ack is the first
-    //       message received (which is fair enough but may not be 100% correct in the future).
-    if (context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED) {
-        DEBUG_WARNING("Received ack but channel %"PRIu16" is already negotiated\n", info->rcv_sid);
-        goto error;
+    // Check whether message interleaving is active
+    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_INTERLEAVING;
+    for (i = 0; i < length; ++i) {
+        if (event->sac_info[i] == SCTP_ASSOC_SUPPORTS_INTERLEAVING) {
+            transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_INTERLEAVING;
+            break;
+        }
     }
-
-    // Messages may now be sent unordered
-    context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED;
-    return;
-
-error:
-    // TODO: Reset stream with SID on error
-    return;
+    DEBUG_INFO("Message interleaving (I-DATA): %s\n",
+               transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_INTERLEAVING ? "yes" : "no");
 }
 
 /*
- * Handle data channel open message.
+ * Handle SCTP association change event.
  */
-static void handle_data_channel_open_message(
+static void handle_association_change_event(
         struct rawrtc_sctp_transport* const transport,
-        struct mbuf* const buffer_in,
-        struct sctp_rcvinfo* const info
+        struct sctp_assoc_change* const event
 ) {
-    enum rawrtc_code error;
-    struct rawrtc_data_channel_parameters* parameters;
-    uint_fast16_t priority;
-    struct rawrtc_data_transport* data_transport = NULL;
-    struct rawrtc_data_channel* channel = NULL;
-    struct rawrtc_sctp_data_channel_context* context = NULL;
-    struct mbuf* buffer_out = NULL;
+    // Print debug output for event
+    DEBUG_PRINTF("Association change: %H", debug_association_change_event, event);
 
-    // Check SID corresponds to other peer's role
-    switch (transport->dtls_transport->role) {
-        case RAWRTC_DTLS_ROLE_AUTO:
-            // Note: This case should be impossible. If it happens, report it!
-            DEBUG_WARNING("Cannot validate SID due to undetermined DTLS role\n");
-            return;
-        case RAWRTC_DTLS_ROLE_CLIENT:
-            // Other peer must have chosen an odd SID
-            if (info->rcv_sid % 2 != 1) {
-                DEBUG_WARNING("Other peer incorrectly chose an even SID\n");
-                return;
+    // Handle state
+    switch (event->sac_state) {
+        case SCTP_COMM_UP:
+            // Store negotiated amount of streams and features
+            update_association_features(transport, event);
+
+            // Connected
+            if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTING) {
+                set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED);
             }
             break;
-        case RAWRTC_DTLS_ROLE_SERVER:
-            // Other peer must have chosen an even SID
-            if (info->rcv_sid % 2 != 0) {
-                DEBUG_WARNING("Other peer incorrectly chose an odd SID\n");
-                return;
+        case SCTP_RESTART:
+            // Store negotiated amount of streams and features
+            // TODO: Handle further?
+            update_association_features(transport, event);
+            break;
+        case SCTP_CANT_STR_ASSOC:
+        case SCTP_SHUTDOWN_COMP:
+        case SCTP_COMM_LOST:
+            // Disconnected
+            // TODO: Is this the correct behaviour?
+            if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+                set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CLOSED);
             }
             break;
         default:
-            return;
+            break;
     }
+}
 
-    // Check if slot is occupied
-    if (transport->channels[info->rcv_sid]) {
-        DEBUG_WARNING("Other peer chose already occupied SID %"PRIu16"\n", info->rcv_sid);
-        return;
-    }
+/*
+ * Append a received message chunk to a chain.
+ *
+ * Chunks that fill most of their buffer are referenced without copying
+ * them. Smaller chunks (e.g. a single DATA chunk received into a
+ * buffer of the partial delivery point's size) are copied into the
+ * free space of the last chunk or into a new pooled buffer, so the
+ * memory held by a chain stays close to the size of the message.
+ */
+static enum rawrtc_code chunk_chain_append(
+        struct rawrtc_sctp_chunk_chain* const chain, // not checked
+        struct mbuf* const buffer // referenced, not checked
+) {
+    size_t const length = mbuf_get_left(buffer);
+    struct mbuf* chunk;
+    enum rawrtc_code error;
 
-    // Get parameters from data channel open message
-    error = data_channel_open_message_parse(&parameters, &priority, info->rcv_sid, buffer_in);
-    if (error) {
-        DEBUG_WARNING("Unable to parse DCEP open message, reason: %s\n", rawrtc_code_to_str(error));
-        return;
+    // Copy into the free space of the last chunk (if it fits)
+    if (chain->n_chunks > 0) {
+        struct mbuf* const tail = chain->chunks[chain->n_chunks - 1];
+        if (tail->size - tail->end >= length) {
+            size_t const pos = tail->pos;
+            mbuf_skip_to_end(tail);
+            error = rawrtc_error_to_code(mbuf_write_mem(tail, mbuf_buf(buffer), length));
+            mbuf_set_pos(tail, pos);
+            if (error) {
+                return error;
+            }
+            chain->size += length;
+            return RAWRTC_CODE_SUCCESS;
+        }
     }
 
-    // Get data transport
-    error = rawrtc_sctp_transport_get_data_transport(&data_transport, transport);
-    if (error) {
-        DEBUG_WARNING("Unable to get data transport, reason: %s\n", rawrtc_code_to_str(error));
-        goto out;
+    // Reference the chunk (if it fills at least half of its buffer) or copy it into a compact
+    // buffer which further chunks will be copied into
+    if (length * 2 >= buffer->size) {
+        chunk = mem_ref(buffer);
+    } else {
+        size_t const size = length > rawrtc_global.usrsctp_chunk_size ?
+                length : rawrtc_global.usrsctp_chunk_size;
+        error = rawrtc_buffer_pool_get(&chunk, rawrtc_buffer_pool_global(), size);
+        if (error) {
+            return error;
+        }
+        error = rawrtc_error_to_code(mbuf_write_mem(chunk, mbuf_buf(buffer), length));
+        if (error) {
+            rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), chunk);
+            return error;
+        }
+        mbuf_set_pos(chunk, 0);
     }
 
-    // Create data channel
-    error = rawrtc_data_channel_create_internal(
-            &channel, data_transport, parameters, NULL,
-            NULL, NULL, NULL, NULL, NULL, NULL,
-            false);
-    if (error) {
-        DEBUG_WARNING("Unable to create data channel, reason: %s\n", rawrtc_code_to_str(error));
-        goto out;
+    // Grow chunk array (if needed)
+    if (chain->n_chunks == chain->capacity) {
+        size_t const capacity = chain->capacity > 0 ? chain->capacity * 2 : 8;
+        struct mbuf** const chunks = mem_reallocarray(
+                chain->chunks, capacity, sizeof(*chunks), NULL);
+        if (!chunks) {
+            rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), chunk);
+            return RAWRTC_CODE_NO_MEMORY;
+        }
+        chain->chunks = chunks;
+        chain->capacity = capacity;
     }
 
-    // Allocate context to be used as an argument for the data channel handlers
-    error = channel_context_create(&context, info->rcv_sid, true);
-    if (error) {
-        DEBUG_WARNING("Unable to create data channel context, reason: %s\n",
-                      rawrtc_code_to_str(error));
-        goto out;
+    // Append chunk
+    chain->chunks[chain->n_chunks++] = chunk;
+    chain->size += length;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Release all chunks of a chain (the chunk array will be kept for
+ * further messages).
+ */
+static void chunk_chain_clear(
+        struct rawrtc_sctp_chunk_chain* const chain // not checked
+) {
+    size_t i;
+
+    // Release chunks (back into the pool if unused)
+    for (i = 0; i < chain->n_chunks; ++i) {
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), chain->chunks[i]);
+        chain->chunks[i] = NULL;
     }
+    chain->n_chunks = 0;
+    chain->size = 0;
+}
+
+/*
+ * Release all chunks and the chunk array of a chain.
+ */
+static void chunk_chain_flush(
+        struct rawrtc_sctp_chunk_chain* const chain // not checked
+) {
+    chunk_chain_clear(chain);
+    chain->chunks = mem_deref(chain->chunks);
+    chain->capacity = 0;
+}
 
-    // TODO: Store priority for SCTP ndata,
-    //       see https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.4
-    (void) priority;
+/*
+ * Merge all chunks of a chain into a single buffer (copying each chunk
+ * exactly once) and clear the chain.
+ */
+static enum rawrtc_code chunk_chain_merge(
+        struct mbuf** const bufferp, // de-referenced, not checked
+        struct rawrtc_sctp_chunk_chain* const chain // not checked
+) {
+    struct mbuf* buffer;
+    size_t i;
+    enum rawrtc_code error;
 
-    // Create ack message
-    buffer_out = NULL;
-    error = data_channel_ack_message_create(&buffer_out);
-    if (error) {
-        DEBUG_WARNING("Unable to create data channel ack message, reason: %s\n",
-                      rawrtc_code_to_str(error));
+    // Single chunk? Hand it out directly.
+    if (chain->n_chunks == 1) {
+        buffer = mem_ref(chain->chunks[0]);
+        error = RAWRTC_CODE_SUCCESS;
         goto out;
     }
 
-    // Send message
-    DEBUG_PRINTF("Sending data channel ack message for channel with SID %"PRIu16"\n", context->sid);
-    error = send_message(transport, NULL, context, buffer_out, RAWRTC_SCTP_TRANSPORT_PPID_DCEP);
+    // Allocate buffer with the final size
+    error = rawrtc_buffer_pool_get(&buffer, rawrtc_buffer_pool_global(), chain->size);
     if (error) {
-        DEBUG_WARNING("Unable to send data channel ack message, reason: %s\n",
-                      rawrtc_code_to_str(error));
         goto out;
     }
 
-    // Register data channel
-    channel_register(transport, channel, context, true);
-
-    // TODO: Reset stream with SID on error
+    // Copy chunks
+    for (i = 0; i < chain->n_chunks; ++i) {
+        struct mbuf* const chunk = chain->chunks[i];
+        error = rawrtc_error_to_code(mbuf_write_mem(buffer, mbuf_buf(chunk), mbuf_get_left(chunk)));
+        if (error) {
+            rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
+            goto out;
+        }
+    }
+    mbuf_set_pos(buffer, 0);
+    DEBUG_PRINTF("Merged %zu incoming message chunks to size %zu\n",
+                 chain->n_chunks, mbuf_get_left(buffer));
 
 out:
-    mem_deref(buffer_out);
-    mem_deref(context);
-    mem_deref(channel);
-    mem_deref(data_transport);
-    mem_deref(parameters);
+    // Clear chain
+    chunk_chain_clear(chain);
+
+    if (!error) {
+        // Set pointer
+        *bufferp = buffer;
+    }
+    return error;
 }
 
 /*
- * Buffer incoming messages
- *
- * Return `RAWRTC_CODE_SUCCESS` in case the message is complete and
- * should be handled. Otherwise, return `RAWRTC_CODE_NO_VALUE`.
+ * Destructor for an existing chained message.
  */
-static enum rawrtc_code buffer_message_received_raise_complete(
-        struct mbuf** const buffer_inboundp, // de-referenced, not checked
-        struct sctp_rcvinfo* const info_inboundp, // de-referenced, not checked
-        struct mbuf* const message_buffer, // not checked
-        struct sctp_rcvinfo* const info, // not checked
-        int const flags
+static void chained_message_destroy(
+        void* arg
 ) {
-    bool const complete =
-            (flags & MSG_EOR) &&
-            info->rcv_ppid != RAWRTC_SCTP_TRANSPORT_PPID_UTF16_PARTIAL &&
-            info->rcv_ppid != RAWRTC_SCTP_TRANSPORT_PPID_BINARY_PARTIAL;
-    enum rawrtc_code error;
+    struct rawrtc_data_channel_chained_message* const message = arg;
+    size_t i;
 
-    // Reference buffer and copy receive info (if first)
-    if (*buffer_inboundp == NULL) {
-        // Reference & set buffer
-        *buffer_inboundp = mem_ref(message_buffer);
+    // Release buffers (back into the pool if unused)
+    for (i = 0; i < message->n_segments; ++i) {
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), message->buffers[i]);
+    }
+}
 
-        // Copy receive info
-        memcpy(info_inboundp, info, sizeof(*info));
+/*
+ * Create a chained message from the chunks of a chain (if any) or from
+ * a single buffer. References to the chunks will be moved from the
+ * chain into the message.
+ */
+static enum rawrtc_code chained_message_create(
+        struct rawrtc_data_channel_chained_message** const messagep, // de-referenced, not checked
+        struct rawrtc_sctp_chunk_chain* const chain, // not checked
+        struct mbuf* const buffer // nullable, referenced
+) {
+    struct rawrtc_data_channel_chained_message* message;
+    size_t n_segments;
+    size_t i;
 
-        // Complete?
-        if (complete) {
-            DEBUG_PRINTF("Incoming message of size %zu is already complete\n",
-                         mbuf_get_left(message_buffer));
-            error = RAWRTC_CODE_SUCCESS;
-            goto out;
-        }
+    // Determine amount of segments
+    if (chain->n_chunks > 0) {
+        n_segments = chain->n_chunks;
+    } else {
+        n_segments = buffer && mbuf_get_left(buffer) > 0 ? 1 : 0;
+    }
 
-        // Clear headroom (if any)
-        if ((*buffer_inboundp)->pos > 0) {
-            error = rawrtc_error_to_code(mbuf_shift(*buffer_inboundp, -(*buffer_inboundp)->pos));
-            if (error) {
-                goto out;
-            }
+    // Allocate message, segments and buffers at once
+    message = mem_zalloc(
+            sizeof(*message) + n_segments * (sizeof(*message->segments) +
+                                             sizeof(*message->buffers)),
+            chained_message_destroy);
+    if (!message) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+    message->segments = (struct iovec*) (message + 1);
+    message->buffers = (struct mbuf**) (message->segments + n_segments);
+
+    // Set buffers
+    if (chain->n_chunks > 0) {
+        // Move chunks
+        for (i = 0; i < n_segments; ++i) {
+            message->buffers[i] = chain->chunks[i];
+            chain->chunks[i] = NULL;
         }
+        chain->n_chunks = 0;
+        chain->size = 0;
+    } else if (n_segments > 0) {
+        message->buffers[0] = mem_ref(buffer);
+    }
 
-        // Skip to end (for upcoming chunks)
-        mbuf_skip_to_end(*buffer_inboundp);
+    // Set segments
+    for (i = 0; i < n_segments; ++i) {
+        message->segments[i].iov_base = mbuf_buf(message->buffers[i]);
+        message->segments[i].iov_len = mbuf_get_left(message->buffers[i]);
+        message->size += message->segments[i].iov_len;
     }
+    message->n_segments = n_segments;
 
-    // Copy message into existing buffer
-    error = rawrtc_error_to_code(mbuf_write_mem(
-            *buffer_inboundp, mbuf_buf(message_buffer), mbuf_get_left(message_buffer)));
-    if (error) {
-        goto out;
+    // Set pointer & done
+    *messagep = message;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Handle SCTP partial delivery event.
+ */
+static void handle_partial_delivery_event(
+        struct rawrtc_sctp_transport* const transport,
+        struct sctp_pdapi_event* const event
+) {
+    uint16_t sid;
+    struct rawrtc_data_channel* channel;
+    struct rawrtc_sctp_data_channel_context* context;
+
+    // Print debug output for event
+    DEBUG_PRINTF("Partial delivery event: %H", debug_partial_delivery_event, event);
+
+    // Validate stream ID
+    if (event->pdapi_stream >= UINT16_MAX) {
+        DEBUG_WARNING("Invalid stream id in partial delivery event: %"PRIu32"\n",
+                      event->pdapi_stream);
+        return;
     }
-    DEBUG_PRINTF("Buffered incoming message chunk of size %zu\n", mbuf_get_left(message_buffer));
+    sid = (uint16_t) event->pdapi_stream;
 
-    // Stop (if not last message)
-    if (!complete) {
-        error = RAWRTC_CODE_NO_VALUE;
-        goto out;
+    // Check if channel exists
+    // TODO: Need to check if channel is open?
+    if (sid >= transport->n_channels || !transport->channels[sid]) {
+        DEBUG_NOTICE("No channel registered for sid %"PRIu16"\n", sid);
+        return;
     }
 
-    // Set position & done
-    mbuf_set_pos(*buffer_inboundp, 0);
-    DEBUG_PRINTF("Merged incoming message chunks to size %zu\n", mbuf_get_left(*buffer_inboundp));
-    error = RAWRTC_CODE_SUCCESS;
+    // Get channel and context
+    channel = transport->channels[sid];
+    context = channel->transport_arg;
 
-out:
-    if (error && error != RAWRTC_CODE_NO_VALUE) {
-        // Discard the message
-        *buffer_inboundp = mem_deref(*buffer_inboundp);
+    // Abort pending message
+    if (context->chain_inbound.n_chunks > 0) {
+        DEBUG_NOTICE("Abort partially delivered message of %zu bytes\n",
+                     context->chain_inbound.size);
+        chunk_chain_clear(&context->chain_inbound);
+
+        // Sanity-check
+        if (channel->options->deliver_partially) {
+            DEBUG_WARNING("We deliver partially but there was a buffered message?!\n");
+        }
+    }
+
+    // Pass abort notification to handler
+    if (channel->options->deliver_partially) {
+        enum rawrtc_data_channel_message_flag const message_flags =
+                RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_ABORTED;
+        if (channel->chained_message_handler) {
+            channel->chained_message_handler(NULL, message_flags, channel->arg);
+        } else if (channel->message_handler) {
+            channel->message_handler(NULL, message_flags, channel->arg);
+        } else {
+            DEBUG_NOTICE("No message handler, message abort notification has been discarded\n");
+        }
     }
-    return error;
 }
 
 /*
- * Handle incoming application data messages.
+ * Handle SCTP send failed event.
  */
-static void handle_application_message(
+static void handle_send_failed_event(
+        struct rawrtc_sctp_transport* const transport,
+        struct sctp_send_failed_event* const event
+) {
+    // Print debug output for event
+    DEBUG_PRINTF("Send failed event: %H", debug_send_failed_event, event);
+    (void) transport;
+    (void) event;
+}
+
+/*
+ * Raise buffered amount low on a data channel.
+ */
+static void raise_buffered_amount_low_event(
+        struct rawrtc_data_channel* const channel // not checked
+) {
+    // Check for event handler
+    if (channel->buffered_amount_low_handler) {
+        // Get context
+        struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
+        (void) context;
+
+        // Raise event
+        DEBUG_PRINTF("Raising buffered amount low event on channel with SID %"PRIu16"\n",
+                     context->sid);
+        channel->buffered_amount_low_handler(channel->arg);
+    }
+}
+
+/*
+ * Get the amount of bytes in usrsctp's send buffer of the association.
+ */
+static size_t get_send_buffer_usage(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    struct sctp_sockstat sockstat = {0};
+    socklen_t length = sizeof(sockstat);
+
+    // Get send buffer usage
+    if (usrsctp_getsockopt(transport->socket, IPPROTO_SCTP, SCTP_GET_SNDBUF_USE,
+                           &sockstat, &length)) {
+        // Note: Don't cap the estimation in this case
+        DEBUG_WARNING("Unable to retrieve send buffer usage, reason: %m\n", errno);
+        return SIZE_MAX;
+    }
+    return sockstat.ss_total_sndbuf;
+}
+
+/*
+ * Get the buffered amount of a data channel.
+ *
+ * usrsctp does not provide the amount of buffered bytes per stream, so
+ * the amount of bytes handed out to usrsctp is capped by the amount of
+ * bytes in the association's send buffer.
+ */
+static uint64_t get_channel_buffered_amount(
+        struct rawrtc_sctp_data_channel_context* const context, // not checked
+        size_t const send_buffer_usage
+) {
+    // Cap bytes handed out to usrsctp
+    if (context->usrsctp_buffered_amount > send_buffer_usage) {
+        context->usrsctp_buffered_amount = send_buffer_usage;
+    }
+
+    // Sum of buffered bytes in our queue and in usrsctp's send buffer
+    return context->buffered_amount + context->usrsctp_buffered_amount;
+}
+
+/*
+ * Add a data channel to the list of channels waiting for a buffered
+ * amount low event in case its buffered amount is above its threshold.
+ */
+static void update_buffered_amount_high(
         struct rawrtc_sctp_transport* const transport, // not checked
-        struct mbuf* const buffer, // not checked
-        struct sctp_rcvinfo* info, // not checked
-        int const flags
+        struct rawrtc_data_channel* const channel // not checked
 ) {
-    enum rawrtc_code error;
-    struct rawrtc_sctp_data_channel_context* context = NULL;
-    enum rawrtc_data_channel_message_flag message_flags = RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_NONE;
+    struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
+    uint64_t amount;
 
-    // Get channel and context
-    struct rawrtc_data_channel* const channel = transport->channels[info->rcv_sid];
-    if (!channel) {
-        DEBUG_WARNING("Received application message on an invalid channel with SID %"PRIu16"\n",
-                      info->rcv_sid);
-        error = RAWRTC_CODE_INVALID_MESSAGE;
-        goto out;
+    // Already waiting?
+    if (context->buffered_amount_le.list) {
+        return;
     }
-    context = mem_ref(channel->transport_arg);
 
-    // Messages may now be sent unordered
-    // TODO: Should we update this flag before or after the message has been received completely
-    //       (EOR)? Guessing: Once first chunk has been received.
-    context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED;
+    // Above threshold?
+    amount = get_channel_buffered_amount(context, get_send_buffer_usage(transport));
+    if (amount <= channel->buffered_amount_low_threshold) {
+        return;
+    }
 
-    // Handle empty / Buffer if partial delivery is off / deliver directly
-    if (info->rcv_ppid == RAWRTC_SCTP_TRANSPORT_PPID_UTF16_EMPTY ||
-            info->rcv_ppid == RAWRTC_SCTP_TRANSPORT_PPID_BINARY_EMPTY) {
-        // Incomplete empty message?
-        if (flags & SCTP_EOR) {
-            DEBUG_WARNING("Empty but incomplete message, WTF are you doing?\n");
-            error = RAWRTC_CODE_INVALID_MESSAGE;
-            goto out;
-        }
+    // Add to list (referenced)
+    DEBUG_PRINTF("Buffered amount of channel with SID %"PRIu16" is above threshold (%"PRIu64" > "
+                 "%"PRIu64")\n", context->sid, amount, channel->buffered_amount_low_threshold);
+    list_append(&transport->buffered_amount_high_channels, &context->buffered_amount_le,
+                mem_ref(channel));
+}
 
-        // Reference (because we un-reference at the end and copy info)
-        context->buffer_inbound = mem_ref(buffer);
+/*
+ * Raise buffered amount low events on all data channels whose buffered
+ * amount decreased to or below their threshold.
+ */
+static void raise_buffered_amount_low_events(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    struct le* le;
+    size_t send_buffer_usage;
 
-        // Let the buffer appear to be empty
-        mbuf_skip_to_end(context->buffer_inbound);
+    // Nothing to do?
+    if (list_isempty(&transport->buffered_amount_high_channels)) {
+        return;
+    }
 
-        // Empty message is complete
-        message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_COMPLETE;
+    // Handle each waiting channel
+    send_buffer_usage = get_send_buffer_usage(transport);
+    le = list_head(&transport->buffered_amount_high_channels);
+    while (le != NULL) {
+        struct rawrtc_data_channel* const channel = le->data;
+        struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
+        struct rawrtc_data_channel* const next = le->next ? mem_ref(le->next->data) : NULL;
+        bool const closed = channel->state == RAWRTC_DATA_CHANNEL_STATE_CLOSED;
+
+        // Dropped to or below threshold (or closed)?
+        if (closed || get_channel_buffered_amount(context, send_buffer_usage)
+                <= channel->buffered_amount_low_threshold) {
+            list_unlink(le);
+
+            // Raise event (if not closed)
+            // Note: The handler may send data, so we need to update the send buffer usage.
+            if (!closed) {
+                raise_buffered_amount_low_event(channel);
+                send_buffer_usage = get_send_buffer_usage(transport);
+            }
 
-    } else if (!channel->options->deliver_partially) {
-        // Buffer message (if needed) and get complete message (if any)
-        error = buffer_message_received_raise_complete(
-                &context->buffer_inbound, &context->info_inbound,
-                buffer, info, flags);
-        switch (error) {
-            case RAWRTC_CODE_SUCCESS:
-                break;
-            case RAWRTC_CODE_NO_VALUE:
-                // Message buffered, early return here
-                return;
-            default:
-                DEBUG_WARNING("Could not buffer/complete application message, reason: %s\n",
-                              rawrtc_code_to_str(error));
-                goto out;
-                break;
+            // Un-reference
+            mem_deref(channel);
         }
 
-        // Update info pointer
-        info = &context->info_inbound;
+        // Get next channel
+        // Note: Restart from the beginning in case the next channel has been removed by a handler
+        if (next) {
+            struct rawrtc_sctp_data_channel_context* const next_context = next->transport_arg;
+            if (next_context->buffered_amount_le.list) {
+                le = &next_context->buffered_amount_le;
+            } else {
+                le = list_head(&transport->buffered_amount_high_channels);
+            }
+            mem_deref(next);
+        } else {
+            le = NULL;
+        }
+    }
+}
 
-        // Message is complete
-        message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_COMPLETE;
-    } else {
-        // Partial delivery on, pass buffer directly
-        context->buffer_inbound = mem_ref(buffer);
+/*
+ * Handle SCTP sender dry (no outstanding data) event.
+ */
+static void handle_sender_dry_event(
+        struct rawrtc_sctp_transport* const transport,
+        struct sctp_sender_dry_event* const event
+) {
+    uint_fast16_t i;
+    uint_fast16_t stop;
+    (void) event;
 
-        // Complete?
-        if (flags & MSG_EOR) {
-            message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_COMPLETE;
-        }
+    // Raise buffered amount low events (if any)
+    // Note: usrsctp's send buffer is empty, so only bytes in our queue are still buffered
+    raise_buffered_amount_low_events(transport);
+
+    // If there are outstanding messages, don't reset pending streams
+    if (!rawrtc_message_buffer_is_empty(&transport->buffered_messages_outgoing)) {
+        DEBUG_PRINTF("Pending messages, ignoring sender dry event\n");
+        return;
     }
 
-    // Handle application message
-    switch (info->rcv_ppid) {
-        case RAWRTC_SCTP_TRANSPORT_PPID_UTF16:
-        case RAWRTC_SCTP_TRANSPORT_PPID_UTF16_EMPTY:
-        case RAWRTC_SCTP_TRANSPORT_PPID_UTF16_PARTIAL:
-            break;
-        case RAWRTC_SCTP_TRANSPORT_PPID_BINARY:
-        case RAWRTC_SCTP_TRANSPORT_PPID_BINARY_EMPTY:
-        case RAWRTC_SCTP_TRANSPORT_PPID_BINARY_PARTIAL:
-            message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_BINARY;
+    // Set buffered amount low
+    transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW;
+
+    // No data channels?
+    if (transport->n_channels == 0) {
+        return;
+    }
+
+    // Reset counter if #channels has been reduced
+    if (transport->current_channel_sid >= transport->n_channels) {
+        i = 0;
+    } else {
+        i = transport->current_channel_sid;
+    }
+
+    // Reset pending outgoing streams of each data channel
+    stop = i;
+    do {
+        struct rawrtc_data_channel* const channel = transport->channels[i];
+        if (channel) {
+            struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
+
+            // Handle flags
+            if (context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET) {
+                // Reset pending outgoing stream
+                // TODO: This should probably be handled earlier but requires having separate
+                //       lists for each data channel to be sure that the stream is not reset before
+                //       all pending messages have been sent.
+                reset_outgoing_stream(transport, channel);
+                context->flags &= ~RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET;
+            }
+        }
+
+        // Update/wrap
+        // Note: uint16 is sufficient here as the maximum number of channels is
+        //       65534, so 65535 will still fit
+        i = (i + 1) % transport->n_channels;
+
+        // Stop if the flag has been cleared
+        if (!(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW)) {
+            break;
+        }
+    } while (i != stop);
+
+    // Update current channel SID
+    transport->current_channel_sid = i;
+}
+
+/*
+ * Handle stream reset event (data channel closed).
+ */
+static void handle_stream_reset_event(
+        struct rawrtc_sctp_transport* const transport,
+        struct sctp_stream_reset_event* const event
+) {
+    uint_fast32_t length;
+    uint_fast32_t i;
+
+    // Get #sid's
+    length = (event->strreset_length - sizeof(*event)) / sizeof(uint16_t);
+
+    // Print debug output for event
+    DEBUG_PRINTF("Stream reset event: %H", debug_stream_reset_event, event, length);
+
+    // Request outgoing streams that could not be requested during the reset (if any)
+    if (add_outbound_streams(transport)) {
+        DEBUG_WARNING("Could not add outgoing streams\n");
+    }
+
+    // Ignore denied/failed events
+    if (event->strreset_flags & SCTP_STREAM_RESET_DENIED
+        || event->strreset_flags & SCTP_STREAM_RESET_FAILED) {
+        return;
+    }
+
+    // Handle stream resets
+    for (i = 0; i < length; ++i) {
+        uint_fast16_t const sid = (uint_fast16_t) event->strreset_stream_list[i];
+        struct rawrtc_data_channel* channel;
+        struct rawrtc_sctp_data_channel_context* context;
+
+        // Check if channel exists
+        if (sid >= transport->n_channels || !transport->channels[sid]) {
+            DEBUG_NOTICE("No channel registered for sid %"PRIuFAST16"\n", sid);
+            continue;
+        }
+
+        // Get channel and context
+        channel = transport->channels[sid];
+        context = channel->transport_arg;
+
+        // Incoming stream reset
+        if (event->strreset_flags & SCTP_STREAM_RESET_INCOMING_SSN) {
+            // Set flag
+            channel->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_INCOMING_STREAM_RESET;
+
+            // Reset outgoing stream (if needed)
+            if (channel->state != RAWRTC_DATA_CHANNEL_STATE_CLOSING
+                && channel->state != RAWRTC_DATA_CHANNEL_STATE_CLOSED) {
+                if (reset_outgoing_stream(transport, channel)) {
+                    // Error, channel has been closed automatically
+                    continue;
+                }
+
+                // Set to closing
+                rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSING);
+            }
+        }
+
+        // Outgoing stream reset (this is raised from our own stream reset)
+        if (event->strreset_flags & SCTP_STREAM_RESET_OUTGOING_SSN) {
+            // Set flag
+            channel->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTGOING_STREAM_RESET;
+        }
+
+        // Close if both incoming and outgoing stream has been reset
+        if (channel->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_INCOMING_STREAM_RESET
+            && channel->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTGOING_STREAM_RESET) {
+            // Set to closed
+            rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
+
+            // Remove from transport
+            transport->channels[context->sid] = mem_deref(channel);
+        }
+    }
+}
+
+/*
+ * Handle stream change event (outgoing streams added).
+ */
+static void handle_stream_change_event(
+        struct rawrtc_sctp_transport* const transport,
+        struct sctp_stream_change_event* const event
+) {
+    enum rawrtc_code error;
+    uint_fast32_t i;
+
+    // Print debug output for event
+    DEBUG_PRINTF("Stream change event: in=%"PRIu16", out=%"PRIu16", flags=%"PRIu16"\n",
+                 event->strchange_instrms, event->strchange_outstrms, event->strchange_flags);
+
+    // Update amount of streams
+    transport->n_inbound_streams = event->strchange_instrms;
+    transport->n_outbound_streams = event->strchange_outstrms;
+    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_ADDING_STREAMS;
+
+    // Denied or failed? Close data channels that have no outgoing stream.
+    if (event->strchange_flags & (SCTP_STREAM_CHANGE_DENIED | SCTP_STREAM_CHANGE_FAILED)) {
+        DEBUG_WARNING("Adding outgoing streams has been denied or failed\n");
+        for (i = transport->n_outbound_streams; i < transport->n_channels; ++i) {
+            struct rawrtc_data_channel* const channel = transport->channels[i];
+            if (channel) {
+                rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSED);
+                transport->channels[i] = mem_deref(channel);
+            }
+        }
+        transport->n_outbound_streams_wanted = transport->n_outbound_streams;
+    }
+
+    // Release messages whose outgoing stream has been added
+    release_pending_messages(transport);
+
+    // Drop messages of data channels that will not get an outgoing stream
+    if (event->strchange_flags & (SCTP_STREAM_CHANGE_DENIED | SCTP_STREAM_CHANGE_FAILED)) {
+        rawrtc_message_buffer_flush(&transport->buffered_messages_pending_streams);
+    }
+
+    // Apply priorities (to the streams that have been added)
+    apply_stream_priorities(transport);
+
+    // Request further outgoing streams (if needed)
+    error = add_outbound_streams(transport);
+    if (error) {
+        DEBUG_WARNING("Could not add outgoing streams, reason: %s\n", rawrtc_code_to_str(error));
+    }
+
+    // Send deferred messages (if not corked)
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED &&
+            can_send_deferred(transport) &&
+            !(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS)) {
+        transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
+        error = sctp_send_deferred_messages(transport);
+        transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
+        if (error && error != RAWRTC_CODE_STOP_ITERATION) {
+            DEBUG_WARNING("Could not send deferred messages, reason: %s\n",
+                          rawrtc_code_to_str(error));
+        }
+
+        // Raise buffered amount low events (if any)
+        raise_buffered_amount_low_events(transport);
+    }
+}
+
+/*
+ * Handle SCTP notification.
+ */
+static void handle_notification(
+        struct rawrtc_sctp_transport* const transport,
+        struct mbuf* const buffer
+) {
+    union sctp_notification* const notification = (union sctp_notification*) buffer->buf;
+
+    // TODO: Are all of these checks necessary or can we reduce that?
+#if (SIZE_MAX > UINT32_MAX)
+    if (buffer->end > UINT32_MAX) {
+        return;
+    }
+#endif
+#if (UINT32_MAX > SIZE_MAX)
+    if (notification->sn_header.sn_length > SIZE_MAX) {
+        return;
+    }
+#endif
+    if (notification->sn_header.sn_length != buffer->end) {
+        return;
+    }
+
+    // Handle notification by type
+    switch (notification->sn_header.sn_type) {
+        case SCTP_ASSOC_CHANGE:
+            handle_association_change_event(transport, &notification->sn_assoc_change);
+            break;
+        case SCTP_PARTIAL_DELIVERY_EVENT:
+            handle_partial_delivery_event(transport, &notification->sn_pdapi_event);
+            break;
+        case SCTP_SEND_FAILED_EVENT:
+            handle_send_failed_event(transport, &notification->sn_send_failed_event);
+            break;
+        case SCTP_SENDER_DRY_EVENT:
+            handle_sender_dry_event(transport, &notification->sn_sender_dry_event);
+            break;
+        case SCTP_SHUTDOWN_EVENT:
+            // TODO: Stop sending (this is a bit tricky to implement, so skipping for now)
+            //handle_shutdown_event(transport, &notification->sn_shutdown_event);
+            break;
+        case SCTP_STREAM_CHANGE_EVENT:
+            handle_stream_change_event(transport, &notification->sn_strchange_event);
+            break;
+        case SCTP_STREAM_RESET_EVENT:
+            handle_stream_reset_event(transport, &notification->sn_strreset_event);
             break;
         default:
-            DEBUG_WARNING("Ignored incoming message with unknown PPID: %"PRIu32"\n",
-                          info->rcv_ppid);
-            error = RAWRTC_CODE_INVALID_MESSAGE;
+            DEBUG_WARNING("Unexpected notification event: %"PRIu16"\n",
+                          notification->sn_header.sn_type);
+            break;
+    }
+}
+
+/*
+ * Handle outgoing SCTP messages.
+ */
+static int sctp_packet_handler(
+        void* arg,
+        void* buffer,
+        size_t length,
+        uint8_t tos,
+        uint8_t set_df
+) {
+    struct rawrtc_sctp_transport* const transport = arg;
+    enum rawrtc_code error;
+    (void) tos; // TODO: Handle?
+    (void) set_df; // TODO: Handle?
+
+    // Lock event loop mutex
+    rawrtc_thread_enter();
+
+    // Closed?
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        DEBUG_PRINTF("Ignoring SCTP packet ready event, transport is closed\n");
+        goto out;
+    }
+
+    // Speed up timer (packets are flowing)
+    timer_activity();
+
+    // Trace (if trace handle)
+    // Note: No need to check if NULL as the function does it for us
+    trace_packet(transport, buffer, length, SCTP_DUMP_OUTBOUND);
+
+    // Note: We only need to copy the buffer if we add it to the outgoing queue
+    if (transport->dtls_transport->state == RAWRTC_DTLS_TRANSPORT_STATE_CONNECTED) {
+        struct mbuf mbuffer;
+
+        // Note: dtls_send does not reference the buffer, so we can safely fake an mbuf structure
+        // to avoid copying. This may change in the future, so be aware!
+        mbuffer.buf = buffer;
+        mbuffer.pos = 0;
+        mbuffer.size = length;
+        mbuffer.end = length;
+
+        // Send
+        error = rawrtc_dtls_transport_send(transport->dtls_transport, &mbuffer);
+    } else {
+        struct mbuf* mbuffer;
+        int err;
+
+        // Get buffer
+        error = rawrtc_buffer_pool_get(&mbuffer, rawrtc_buffer_pool_global(), length);
+        if (error) {
+            DEBUG_WARNING("Could not create buffer for outgoing packet, no memory\n");
+            goto out;
+        }
+
+        // Copy and set position
+        err = mbuf_write_mem(mbuffer, buffer, length);
+        if (err) {
+            DEBUG_WARNING("Could not write to buffer, reason: %m\n", err);
+            rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), mbuffer);
+            goto out;
+        }
+        mbuf_set_pos(mbuffer, 0);
+
+        // Send (well, actually buffer...)
+        // Note: The buffer will be returned to the pool once the DTLS transport has sent it.
+        error = rawrtc_dtls_transport_send(transport->dtls_transport, mbuffer);
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), mbuffer);
+    }
+
+    // Handle error
+    if (error) {
+        DEBUG_WARNING("Could not send packet, reason: %s\n", rawrtc_code_to_str(error));
+        goto out;
+    }
+
+out:
+    // Unlock event loop mutex
+    rawrtc_thread_leave();
+
+    // TODO: What does the return code do?
+    return 0;
+}
+
+/*
+ * Handle data channel ack message.
+ */
+static void handle_data_channel_ack_message(
+        struct rawrtc_sctp_transport* const transport,
+        struct sctp_rcvinfo* const info
+) {
+    struct rawrtc_sctp_data_channel_context* context;
+
+    // Get channel and context
+    struct rawrtc_data_channel* const channel = get_channel(transport, info->rcv_sid);
+    if (!channel) {
+        DEBUG_WARNING("Received ack on an invalid channel with SID %"PRIu16"\n", info->rcv_sid);
+        goto error;
+    }
+    context = channel->transport_arg;
+
+    // TODO: We should probably track the state and close the channel if an ack is being received
+    //       on an already negotiated channel. For now, we only check that the ack is the first
+    //       message received (which is fair enough but may not be 100% correct in the future).
+    if (context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED) {
+        DEBUG_WARNING("Received ack but channel %"PRIu16" is already negotiated\n", info->rcv_sid);
+        goto error;
+    }
+
+    // Messages may now be sent unordered
+    context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED;
+    return;
+
+error:
+    // TODO: Reset stream with SID on error
+    return;
+}
+
+/*
+ * Handle data channel open message.
+ */
+static void handle_data_channel_open_message(
+        struct rawrtc_sctp_transport* const transport,
+        struct mbuf* const buffer_in,
+        struct sctp_rcvinfo* const info
+) {
+    enum rawrtc_code error;
+    struct rawrtc_data_channel_parameters* parameters;
+    uint_fast16_t priority;
+    struct rawrtc_data_transport* data_transport = NULL;
+    struct rawrtc_data_channel* channel = NULL;
+    struct rawrtc_sctp_data_channel_context* context = NULL;
+    struct mbuf* buffer_out = NULL;
+
+    // Check SID corresponds to other peer's role
+    switch (transport->dtls_transport->role) {
+        case RAWRTC_DTLS_ROLE_AUTO:
+            // Note: This case should be impossible. If it happens, report it!
+            DEBUG_WARNING("Cannot validate SID due to undetermined DTLS role\n");
+            return;
+        case RAWRTC_DTLS_ROLE_CLIENT:
+            // Other peer must have chosen an odd SID
+            if (info->rcv_sid % 2 != 1) {
+                DEBUG_WARNING("Other peer incorrectly chose an even SID\n");
+                return;
+            }
+            break;
+        case RAWRTC_DTLS_ROLE_SERVER:
+            // Other peer must have chosen an even SID
+            if (info->rcv_sid % 2 != 0) {
+                DEBUG_WARNING("Other peer incorrectly chose an odd SID\n");
+                return;
+            }
+            break;
+        default:
+            return;
+    }
+
+    // Check if slot is occupied
+    if (get_channel(transport, info->rcv_sid)) {
+        DEBUG_WARNING("Other peer chose already occupied SID %"PRIu16"\n", info->rcv_sid);
+        return;
+    }
+
+    // Ensure there's a slot for the SID
+    error = reserve_channel(transport, info->rcv_sid);
+    if (error) {
+        DEBUG_WARNING("Unable to reserve slot for SID %"PRIu16", reason: %s\n",
+                      info->rcv_sid, rawrtc_code_to_str(error));
+        return;
+    }
+
+    // Get parameters from data channel open message
+    error = data_channel_open_message_parse(&parameters, &priority, info->rcv_sid, buffer_in);
+    if (error) {
+        DEBUG_WARNING("Unable to parse DCEP open message, reason: %s\n", rawrtc_code_to_str(error));
+        return;
+    }
+
+    // Get data transport
+    error = rawrtc_sctp_transport_get_data_transport(&data_transport, transport);
+    if (error) {
+        DEBUG_WARNING("Unable to get data transport, reason: %s\n", rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Create data channel
+    error = rawrtc_data_channel_create_internal(
+            &channel, data_transport, parameters, NULL,
+            NULL, NULL, NULL, NULL, NULL, NULL,
+            false);
+    if (error) {
+        DEBUG_WARNING("Unable to create data channel, reason: %s\n", rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Allocate context to be used as an argument for the data channel handlers
+    error = channel_context_create(&context, info->rcv_sid, true);
+    if (error) {
+        DEBUG_WARNING("Unable to create data channel context, reason: %s\n",
+                      rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Store priority (applied to the outgoing stream once registered)
+    // See: https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.4
+    parameters->priority = (uint16_t) priority;
+
+    // Ensure there's an outgoing stream for the SID (the ack will be queued until added)
+    error = want_outbound_stream(transport, context->sid);
+    if (error) {
+        DEBUG_WARNING("Unable to add outgoing stream, reason: %s\n", rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Create ack message
+    buffer_out = NULL;
+    error = data_channel_ack_message_create(&buffer_out);
+    if (error) {
+        DEBUG_WARNING("Unable to create data channel ack message, reason: %s\n",
+                      rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Send message
+    DEBUG_PRINTF("Sending data channel ack message for channel with SID %"PRIu16"\n", context->sid);
+    error = send_message(transport, NULL, context, buffer_out, RAWRTC_SCTP_TRANSPORT_PPID_DCEP);
+    if (error) {
+        DEBUG_WARNING("Unable to send data channel ack message, reason: %s\n",
+                      rawrtc_code_to_str(error));
+        goto out;
+    }
+
+    // Register data channel
+    channel_register(transport, channel, context, true);
+
+    // TODO: Reset stream with SID on error
+
+out:
+    rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer_out);
+    mem_deref(context);
+    mem_deref(channel);
+    mem_deref(data_transport);
+    mem_deref(parameters);
+}
+
+/*
+ * Buffer incoming messages
+ * Chunks are kept in a chain and merged with a single copy once the
+ * message is complete (if requested, otherwise they are left in the
+ * chain).
+ *
+ * Return `RAWRTC_CODE_SUCCESS` in case the message is complete and
+ * should be handled. Otherwise, return `RAWRTC_CODE_NO_VALUE`.
+ * Return `RAWRTC_CODE_MESSAGE_TOO_LONG` (and discard the buffered
+ * chunks) in case the message exceeds `max_size` (unless `0`).
+ */
+static enum rawrtc_code buffer_message_received_raise_complete(
+        struct mbuf** const buffer_inboundp, // de-referenced, not checked
+        struct rawrtc_sctp_chunk_chain* const chain_inbound, // not checked
+        struct sctp_rcvinfo* const info_inboundp, // de-referenced, not checked
+        struct mbuf* const message_buffer, // not checked
+        struct sctp_rcvinfo* const info, // not checked
+        int const flags,
+        bool const merge,
+        uint64_t const max_size
+) {
+    bool const complete =
+            (flags & MSG_EOR) &&
+            info->rcv_ppid != RAWRTC_SCTP_TRANSPORT_PPID_UTF16_PARTIAL &&
+            info->rcv_ppid != RAWRTC_SCTP_TRANSPORT_PPID_BINARY_PARTIAL;
+    enum rawrtc_code error;
+
+    // Check size
+    if (max_size > 0 && chain_inbound->size + mbuf_get_left(message_buffer) > max_size) {
+        DEBUG_NOTICE("Incoming message exceeds maximum size of %"PRIu64" bytes\n", max_size);
+        error = RAWRTC_CODE_MESSAGE_TOO_LONG;
+        goto out;
+    }
+
+    // First chunk?
+    if (chain_inbound->n_chunks == 0) {
+        // Copy receive info
+        memcpy(info_inboundp, info, sizeof(*info));
+
+        // Complete? Reference & set buffer.
+        if (complete) {
+            DEBUG_PRINTF("Incoming message of size %zu is already complete\n",
+                         mbuf_get_left(message_buffer));
+            *buffer_inboundp = mem_ref(message_buffer);
+            return RAWRTC_CODE_SUCCESS;
+        }
+    }
+
+    // Append chunk to chain
+    error = chunk_chain_append(chain_inbound, message_buffer);
+    if (error) {
+        goto out;
+    }
+    DEBUG_PRINTF("Buffered incoming message chunk of size %zu\n", mbuf_get_left(message_buffer));
+
+    // Stop (if not last message)
+    if (!complete) {
+        error = RAWRTC_CODE_NO_VALUE;
+        goto out;
+    }
+
+    // Merge chunks (unless the chain will be handed out) & done
+    if (merge) {
+        error = chunk_chain_merge(buffer_inboundp, chain_inbound);
+    }
+
+out:
+    if (error && error != RAWRTC_CODE_NO_VALUE) {
+        // Discard the message
+        chunk_chain_clear(chain_inbound);
+    }
+    return error;
+}
+
+/*
+ * Get the maximum size of an inbound message to be buffered on a data
+ * channel (`0` if unlimited).
+ */
+static uint64_t get_max_inbound_message_size(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel* const channel // not checked
+) {
+    if (channel->options->max_message_size > 0) {
+        return channel->options->max_message_size;
+    }
+    return transport->max_inbound_message_size;
+}
+
+/*
+ * Abort an inbound message that exceeds the maximum message size:
+ * Discard its remaining chunks, raise the channel's error handler and
+ * close the channel (which resets the stream).
+ */
+static void abort_inbound_message(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel* const channel, // not checked
+        struct rawrtc_sctp_data_channel_context* const context, // not checked
+        int const flags
+) {
+    enum rawrtc_code error;
+
+    DEBUG_WARNING("Aborting inbound message on channel with SID %"PRIu16", maximum message "
+                  "size exceeded\n", context->sid);
+    ++transport->n_inbound_messages_too_large;
+
+    // Discard remaining chunks of the message (if any)
+    if (!(flags & MSG_EOR)) {
+        context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_DISCARD_INBOUND;
+    }
+
+    // Raise error event
+    if (channel->error_handler) {
+        channel->error_handler(channel->arg);
+    }
+
+    // Close channel
+    error = rawrtc_data_channel_close(channel);
+    if (error) {
+        DEBUG_WARNING("Could not close data channel, reason: %s\n", rawrtc_code_to_str(error));
+    }
+}
+
+/*
+ * Handle incoming application data messages.
+ */
+static void handle_application_message(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct mbuf* const buffer, // not checked
+        struct sctp_rcvinfo* info, // not checked
+        int const flags
+) {
+    enum rawrtc_code error;
+    struct rawrtc_sctp_data_channel_context* context = NULL;
+    enum rawrtc_data_channel_message_flag message_flags = RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_NONE;
+
+    // Get channel and context
+    struct rawrtc_data_channel* const channel = get_channel(transport, info->rcv_sid);
+    if (!channel) {
+        DEBUG_WARNING("Received application message on an invalid channel with SID %"PRIu16"\n",
+                      info->rcv_sid);
+        error = RAWRTC_CODE_INVALID_MESSAGE;
+        goto out;
+    }
+    context = mem_ref(channel->transport_arg);
+
+    // Discard remaining chunks of an aborted message
+    if (context->flags & RAWRTC_SCTP_DATA_CHANNEL_FLAGS_DISCARD_INBOUND) {
+        if (flags & MSG_EOR) {
+            context->flags &= ~RAWRTC_SCTP_DATA_CHANNEL_FLAGS_DISCARD_INBOUND;
+        }
+        DEBUG_PRINTF("Discarded %zu bytes of an aborted message\n", mbuf_get_left(buffer));
+        error = RAWRTC_CODE_SUCCESS;
+        goto out;
+    }
+
+    // Messages may now be sent unordered
+    // TODO: Should we update this flag before or after the message has been received completely
+    //       (EOR)? Guessing: Once first chunk has been received.
+    context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED;
+
+    // Handle empty / Buffer if partial delivery is off / deliver directly
+    if (info->rcv_ppid == RAWRTC_SCTP_TRANSPORT_PPID_UTF16_EMPTY ||
+            info->rcv_ppid == RAWRTC_SCTP_TRANSPORT_PPID_BINARY_EMPTY) {
+        // Incomplete empty message?
+        if (flags & SCTP_EOR) {
+            DEBUG_WARNING("Empty but incomplete message, WTF are you doing?\n");
+            error = RAWRTC_CODE_INVALID_MESSAGE;
+            goto out;
+        }
+
+        // Reference (because we un-reference at the end and copy info)
+        context->buffer_inbound = mem_ref(buffer);
+
+        // Let the buffer appear to be empty
+        mbuf_skip_to_end(context->buffer_inbound);
+
+        // Empty message is complete
+        message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_COMPLETE;
+
+    } else if (!channel->options->deliver_partially) {
+        // Buffer message (if needed) and get complete message (if any)
+        error = buffer_message_received_raise_complete(
+                &context->buffer_inbound, &context->chain_inbound, &context->info_inbound,
+                buffer, info, flags, !channel->chained_message_handler,
+                get_max_inbound_message_size(transport, channel));
+        switch (error) {
+            case RAWRTC_CODE_SUCCESS:
+                break;
+            case RAWRTC_CODE_NO_VALUE:
+                // Message buffered, early return here
+                context = mem_deref(context);
+                return;
+            case RAWRTC_CODE_MESSAGE_TOO_LONG:
+                // Abort message & close channel
+                abort_inbound_message(transport, channel, context, flags);
+                error = RAWRTC_CODE_SUCCESS;
+                goto out;
+            default:
+                DEBUG_WARNING("Could not buffer/complete application message, reason: %s\n",
+                              rawrtc_code_to_str(error));
+                goto out;
+                break;
+        }
+
+        // Update info pointer
+        info = &context->info_inbound;
+
+        // Message is complete
+        message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_COMPLETE;
+    } else {
+        // Partial delivery on, pass buffer directly
+        context->buffer_inbound = mem_ref(buffer);
+
+        // Complete?
+        if (flags & MSG_EOR) {
+            message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_COMPLETE;
+        }
+    }
+
+    // Handle application message
+    switch (info->rcv_ppid) {
+        case RAWRTC_SCTP_TRANSPORT_PPID_UTF16:
+        case RAWRTC_SCTP_TRANSPORT_PPID_UTF16_EMPTY:
+        case RAWRTC_SCTP_TRANSPORT_PPID_UTF16_PARTIAL:
+            break;
+        case RAWRTC_SCTP_TRANSPORT_PPID_BINARY:
+        case RAWRTC_SCTP_TRANSPORT_PPID_BINARY_EMPTY:
+        case RAWRTC_SCTP_TRANSPORT_PPID_BINARY_PARTIAL:
+            message_flags |= RAWRTC_DATA_CHANNEL_MESSAGE_FLAG_IS_BINARY;
+            break;
+        default:
+            DEBUG_WARNING("Ignored incoming message with unknown PPID: %"PRIu32"\n",
+                          info->rcv_ppid);
+            error = RAWRTC_CODE_INVALID_MESSAGE;
+            goto out;
+            break;
+    }
+
+    // Pass message to handler
+    if (channel->chained_message_handler) {
+        struct rawrtc_data_channel_chained_message* message;
+
+        // Create chained message
+        error = chained_message_create(
+                &message, &context->chain_inbound, context->buffer_inbound);
+        if (error) {
+            goto out;
+        }
+
+        // Call handler
+        channel->chained_message_handler(message, message_flags, channel->arg);
+        mem_deref(message);
+    } else if (channel->message_handler) {
+        channel->message_handler(context->buffer_inbound, message_flags, channel->arg);
+    } else {
+        DEBUG_NOTICE("No message handler, message of %zu bytes has been discarded\n",
+                      mbuf_get_left(context->buffer_inbound));
+    }
+
+    // Done
+    error = RAWRTC_CODE_SUCCESS;
+
+out:
+    if (error) {
+        DEBUG_WARNING("Unable to handle application message, reason: %s\n",
+                      rawrtc_code_to_str(error));
+
+        // TODO: Reset stream with SID
+    }
+
+    // Un-reference
+    if (context) {
+        chunk_chain_clear(&context->chain_inbound);
+        context->buffer_inbound = mem_deref(context->buffer_inbound);
+        context = mem_deref(context);
+    }
+}
+
+/*
+ * Handle incoming DCEP control message.
+ */
+static void handle_dcep_message(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct mbuf* const buffer, // not checked
+        struct sctp_rcvinfo* info, // not checked
+        int const flags
+) {
+    enum rawrtc_code error;
+
+    // Discard remaining chunks of an aborted message
+    if (transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_DISCARD_DCEP_INBOUND) {
+        if (flags & MSG_EOR) {
+            transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_DISCARD_DCEP_INBOUND;
+        }
+        return;
+    }
+
+    // Buffer message (if needed) and get complete message (if any)
+    error = buffer_message_received_raise_complete(
+            &transport->buffer_dcep_inbound, &transport->chain_dcep_inbound,
+            &transport->info_dcep_inbound, buffer, info, flags, true,
+            RAWRTC_DCEP_MESSAGE_MAX_SIZE);
+    switch (error) {
+        case RAWRTC_CODE_SUCCESS:
+            break;
+        case RAWRTC_CODE_NO_VALUE:
+            // Message buffered, early return here
+            return;
+        case RAWRTC_CODE_MESSAGE_TOO_LONG:
+            // Discard remaining chunks of the message (if any)
+            ++transport->n_inbound_messages_too_large;
+            if (!(flags & MSG_EOR)) {
+                transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_DISCARD_DCEP_INBOUND;
+            }
+            goto out;
+        default:
+            DEBUG_WARNING("Could not buffer/complete DCEP message, reason: %s\n",
+                          rawrtc_code_to_str(error));
+            goto out;
+            break;
+    }
+
+    // Update info pointer
+    info = &transport->info_dcep_inbound;
+
+    // Handle by message type
+    // Note: There MUST be at least a byte present in the buffer as SCTP cannot handle empty
+    //       messages.
+    uint_fast16_t const message_type = mbuf_read_u8(transport->buffer_dcep_inbound);
+    switch (message_type) {
+        case RAWRTC_DCEP_MESSAGE_TYPE_ACK:
+            DEBUG_PRINTF("Received data channel ack message for channel with SID %"PRIu16"\n",
+                         info->rcv_sid);
+            handle_data_channel_ack_message(transport, info);
+            break;
+        case RAWRTC_DCEP_MESSAGE_TYPE_OPEN:
+            DEBUG_PRINTF("Received data channel open message for channel with SID %"PRIu16"\n",
+                         info->rcv_sid);
+            handle_data_channel_open_message(transport, transport->buffer_dcep_inbound, info);
+            break;
+        default:
+            DEBUG_WARNING("Ignored incoming DCEP control message with unknown type: %"PRIu16"\n",
+                          message_type);
+            break;
+    }
+
+    // Done
+    error = RAWRTC_CODE_SUCCESS;
+
+out:
+    if (error) {
+        DEBUG_WARNING("Unable to handle DCEP message, reason: %s\n", rawrtc_code_to_str(error));
+
+        // TODO: Close channel?
+    }
+
+    // Un-reference
+    transport->buffer_dcep_inbound = mem_deref(transport->buffer_dcep_inbound);
+}
+
+/*
+ * Handle incoming data message.
+ */
+static void data_receive_handler(
+        struct rawrtc_sctp_transport* const transport,
+        struct mbuf* const buffer,
+        struct sctp_rcvinfo* const info,
+        int const flags
+) {
+    // Convert PPID first
+    info->rcv_ppid = ntohl(info->rcv_ppid);
+    DEBUG_PRINTF("Received message with SID %"PRIu16", PPID: %"PRIu32"\n",
+                 info->rcv_sid, info->rcv_ppid);
+
+    // Handle by PPID
+    if (info->rcv_ppid == RAWRTC_SCTP_TRANSPORT_PPID_DCEP) {
+        handle_dcep_message(transport, buffer, info, flags);
+    } else {
+        handle_application_message(transport, buffer, info, flags);
+    }
+}
+
+/*
+ * Get the receive buffer of the transport.
+ * The previous buffer will be recycled in case nobody else holds a
+ * reference to it. Otherwise, a new buffer will be allocated.
+ */
+static struct mbuf* receive_buffer_get(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    struct mbuf* buffer = transport->buffer_receive;
+
+    // Recycle buffer (if unused)
+    if (buffer && mem_nrefs(buffer) == 1 && buffer->size >= rawrtc_global.usrsctp_chunk_size) {
+        mbuf_rewind(buffer);
+        return buffer;
+    }
+
+    // Get new buffer from pool
+    // Note: A handler still holds a reference to the previous buffer (if any) which will be
+    //       released once the handler is done with it.
+    rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
+    transport->buffer_receive = NULL;
+    rawrtc_buffer_pool_get(
+            &transport->buffer_receive, rawrtc_buffer_pool_global(),
+            rawrtc_global.usrsctp_chunk_size);
+    return transport->buffer_receive;
+}
+
+/*
+ * Handle usrsctp read event.
+ */
+static int read_event_handler(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    struct mbuf* buffer;
+    ssize_t length;
+    int ignore_events = RAWRTC_SCTP_EVENT_NONE;
+    struct sctp_rcvinfo info = {0};
+    socklen_t info_length = sizeof(info);
+    unsigned int info_type = 0;
+    int flags = 0;
+
+    // Closed?
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        DEBUG_NOTICE("Ignoring read event, transport is closed\n");
+        return RAWRTC_SCTP_EVENT_ALL;
+    }
+
+    // TODO: Get next message size
+    // TODO: Can we get the COMPLETE message size or just the current message size?
+
+    // Get receive buffer
+    buffer = receive_buffer_get(transport);
+    if (!buffer) {
+        DEBUG_WARNING("Cannot allocate buffer, no memory");
+        // TODO: This needs to be handled in a better way, otherwise it's probably going
+        // to cause another read call which calls this handler again resulting in an infinite
+        // loop.
+        return RAWRTC_SCTP_EVENT_NONE;
+    }
+
+    // Receive notification or data
+    length = usrsctp_recvv(
+            transport->socket, buffer->buf, buffer->size, NULL, NULL,
+            &info, &info_length, &info_type, &flags);
+    if (length < 0) {
+        // Meh...
+        if (errno == EAGAIN) {
+//            DEBUG_NOTICE("@ruengeler: usrsctp raised a read event but returned EAGAIN\n");
+            ignore_events = SCTP_EVENT_READ;
+            goto out;
+        }
+
+        // Handle error
+        DEBUG_WARNING("SCTP receive failed, reason: %m\n", errno);
+        // TODO: What now? Close?
+        goto out;
+    }
+
+    // Update buffer position and end
+    mbuf_set_end(buffer, (size_t) length);
+
+    // Handle notification
+    if (flags & MSG_NOTIFICATION) {
+        handle_notification(transport, buffer);
+        goto out;
+    }
+
+    // Check state
+    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
+        DEBUG_WARNING("Ignored incoming data before state 'connected'\n");
+        goto out;
+    }
+
+    // Have info?
+    if (info_type != SCTP_RECVV_RCVINFO) {
+        DEBUG_WARNING("Cannot handle incoming data without SCTP rcvfinfo\n");
+        goto out;
+    }
+
+    // Pass data to handler
+    data_receive_handler(transport, buffer, &info, flags);
+
+out:
+    // Note: The buffer is still referenced by the transport and will be recycled by the next
+    //       read unless a handler has kept a reference to it.
+
+    // Done
+    return ignore_events;
+}
+
+/*
+ * Handle usrsctp write event.
+ */
+static int write_event_handler(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    // Closed?
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        DEBUG_NOTICE("Ignoring write event, transport is closed\n");
+        return RAWRTC_SCTP_EVENT_ALL;
+    }
+
+    // Corked? Messages will be sent once uncorked.
+    if (!can_send_deferred(transport)) {
+        return SCTP_EVENT_WRITE;
+    }
+
+    // Send all deferred messages (if not already sending)
+    // TODO: Check if this flag is really necessary
+    if (!(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS)) {
+        enum rawrtc_code error;
+
+        // Send
+        transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
+        error = sctp_send_deferred_messages(transport);
+        transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
+
+        // Raise buffered amount low events (if any)
+        raise_buffered_amount_low_events(transport);
+        switch (error) {
+            case RAWRTC_CODE_SUCCESS:
+            case RAWRTC_CODE_STOP_ITERATION:
+                // We either sent all pending messages or could not send all messages, so there's
+                // no reason to react to further write events in this iteration
+                return SCTP_EVENT_WRITE;
+            default:
+                // TODO: What now? Close?
+                DEBUG_WARNING("Could not send deferred messages, reason: %s\n",
+                              rawrtc_code_to_str(error));
+                return SCTP_EVENT_WRITE;
+        }
+    } else {
+        DEBUG_WARNING("Sending still in progress!\n");
+        // TODO: Is this correct?
+        return SCTP_EVENT_WRITE;
+    }
+}
+
+/*
+ * Handle usrsctp error event.
+ */
+static bool error_event_handler(
+        struct rawrtc_sctp_transport* const transport // not checked
+) {
+    // Closed?
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        DEBUG_NOTICE("Ignoring error event, transport is closed\n");
+        return RAWRTC_SCTP_EVENT_ALL;
+    }
+
+    // TODO: What am I supposed to do with this information?
+    DEBUG_WARNING("TODO: Handle SCTP error event\n");
+
+    // Continue handling events
+    // TODO: Probably depends on the error, right?
+    return RAWRTC_SCTP_EVENT_NONE;
+}
+
+/*
+ * Handle pending usrsctp events of the transport's socket.
+ * At most `event_budget` rounds will be processed (unless the budget is
+ * 0). Remaining events will be handled in a deferred callback so other
+ * transports and file descriptors of the event loop will not starve.
+ */
+static void handle_events(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct socket* const socket // not checked
+) {
+    int events = usrsctp_get_events(socket);
+    int ignore_events = RAWRTC_SCTP_EVENT_NONE;
+    uint_fast32_t n_rounds = 0;
+
+    while (events) {
+        // Budget exhausted? Defer remaining events.
+        if (transport->event_budget > 0 && n_rounds == transport->event_budget) {
+            DEBUG_PRINTF("Event budget (%"PRIuFAST32" rounds) exhausted, deferring events\n",
+                         transport->event_budget);
+            ++transport->n_event_budget_exhausted;
+            tmr_start(&transport->event_timer, 0, event_timer_handler, transport);
+            break;
+        }
+        ++n_rounds;
+
+        // TODO: This should work but it doesn't because usrsctp keeps switching from read to write
+        //       events endlessly for some reason. So, we need to discard previous events.
+        //ignore_events = RAWRTC_SCTP_EVENT_NONE;
+
+        // Handle error event
+        if (events & SCTP_EVENT_ERROR) {
+            ignore_events |= error_event_handler(transport);
+        }
+
+        // Handle read event
+        if (events & SCTP_EVENT_READ) {
+            ignore_events |= read_event_handler(transport);
+        }
+
+        // Handle write event
+        if (events & SCTP_EVENT_WRITE) {
+            ignore_events |= write_event_handler(transport);
+        }
+
+        // Get upcoming events and remove events that should be ignored
+        events = usrsctp_get_events(socket) & ~ignore_events;
+    }
+}
+
+/*
+ * Handle deferred usrsctp events.
+ */
+static void event_timer_handler(
+        void* arg
+) {
+    struct rawrtc_sctp_transport* const transport = arg;
+
+    // Lock event loop mutex
+    rawrtc_thread_enter();
+
+    // Handle events (if socket still open)
+    if (transport->socket) {
+        handle_events(transport, transport->socket);
+    }
+
+    // Unlock event loop mutex
+    rawrtc_thread_leave();
+}
+
+/*
+ * usrsctp event handler helper.
+ */
+static void upcall_handler_helper(
+        struct socket* socket,
+        void* arg,
+        int flags
+) {
+    struct rawrtc_sctp_transport* const transport = arg;
+    (void) flags; // TODO: What does this indicate?
+
+    // Lock event loop mutex
+    rawrtc_thread_enter();
+
+    // Events are already being handled in a deferred callback?
+    // Note: This ensures that events of busy transports are handled in the order of the event
+    //       loop instead of in usrsctp's context.
+    if (!tmr_isrunning(&transport->event_timer)) {
+        handle_events(transport, socket);
+    }
+
+    // Unlock event loop mutex
+    rawrtc_thread_leave();
+}
+
+/*
+ * Handle path MTU changes of the DTLS transport.
+ */
+static void dtls_path_mtu_handler(
+        size_t const path_mtu,
+        void* const arg
+) {
+    struct rawrtc_sctp_transport* const transport = arg;
+    struct sctp_paddrparams peer_address_parameters = {0};
+
+    // Closed?
+    if (!transport->socket) {
+        return;
+    }
+
+    // Disable usrsctp's path MTU discovery and set path MTU
+    // Note: usrsctp does not account for the common header when using AF_CONN.
+    peer_address_parameters.spp_flags = SPP_PMTUD_DISABLE;
+    peer_address_parameters.spp_pathmtu = (uint32_t) (path_mtu - sizeof(struct sctp_common_header));
+    if (usrsctp_setsockopt(
+            transport->socket, IPPROTO_SCTP, SCTP_PEER_ADDR_PARAMS,
+            &peer_address_parameters, sizeof(peer_address_parameters))) {
+        DEBUG_WARNING("Could not set path MTU, reason: %m\n", errno);
+        return;
+    }
+    DEBUG_PRINTF("Set path MTU to %"PRIu32"\n", peer_address_parameters.spp_pathmtu);
+}
+
+/*
+ * Return whether any SCTP association has outgoing data that has not
+ * been acknowledged yet or is still waiting to be sent. usrsctp's
+ * retransmission timers need to be handled timely in that case.
+ */
+static bool timer_data_outstanding() {
+    struct le* le;
+
+    for (le = list_head(&rawrtc_global.usrsctp_transports); le != NULL; le = le->next) {
+        struct rawrtc_sctp_transport* const transport = le->data;
+        struct sctp_status status = {0};
+        socklen_t length = sizeof(status);
+
+        // Messages waiting to be handed out to usrsctp?
+        if (!rawrtc_message_buffer_is_empty(&transport->buffered_messages_outgoing)) {
+            return true;
+        }
+
+        // Unacknowledged or queued data chunks?
+        if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
+            continue;
+        }
+        if (usrsctp_getsockopt(
+                transport->socket, IPPROTO_SCTP, SCTP_STATUS, &status, &length)) {
+            // Play it safe
+            return true;
+        }
+        if (status.sstat_unackdata > 0) {
+            return true;
+        }
+    }
+
+    // Nothing outstanding
+    return false;
+}
+
+/*
+ * Handle SCTP timer tick.
+ * The timeout adapts to the traffic: While packets are flowing or data
+ * is outstanding, the timer ticks every
+ * RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE ms. Once no packets have
+ * been flowing for RAWRTC_SCTP_TRANSPORT_TIMER_IDLE_DELAY ms (which
+ * covers usrsctp's delayed SACK timer) and nothing is outstanding, the
+ * timeout doubles on each tick until it reaches
+ * RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_IDLE.
+ */
+static void timer_handler(
+        void* arg
+) {
+    uint64_t const now = tmr_jiffies();
+    uint64_t elapsed;
+    uint32_t timeout;
+    (void) arg;
+
+    // Calculate elapsed time since the last tick
+    elapsed = now - rawrtc_global.usrsctp_tick_time;
+    rawrtc_global.usrsctp_tick_time = now;
+
+    // Pass delta ms to usrsctp
+    // Note: Outgoing packets triggered by usrsctp's timers will be considered as activity.
+    usrsctp_handle_timers(elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t) elapsed);
+
+    // Calculate next timeout
+    timeout = rawrtc_global.usrsctp_tick_timeout;
+    if (now - rawrtc_global.usrsctp_tick_activity_time < RAWRTC_SCTP_TRANSPORT_TIMER_IDLE_DELAY
+            || timer_data_outstanding()) {
+        // Packets have been flowing recently or data is outstanding
+        timeout = RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE;
+    } else {
+        // Idle: back off
+        timeout *= 2;
+        if (timeout > RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_IDLE) {
+            timeout = RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_IDLE;
+        }
+    }
+    rawrtc_global.usrsctp_tick_timeout = timeout;
+
+    // Restart timer
+    tmr_start(&rawrtc_global.usrsctp_tick_timer, timeout, timer_handler, NULL);
+}
+
+/*
+ * Start the SCTP timer.
+ */
+static void timer_start() {
+    rawrtc_global.usrsctp_tick_time = tmr_jiffies();
+    rawrtc_global.usrsctp_tick_timeout = RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE;
+    rawrtc_global.usrsctp_tick_activity_time = rawrtc_global.usrsctp_tick_time;
+    tmr_start(&rawrtc_global.usrsctp_tick_timer, rawrtc_global.usrsctp_tick_timeout,
+              timer_handler, NULL);
+}
+
+/*
+ * Mark SCTP activity (a packet has been sent or received).
+ * Reschedules the SCTP timer in case it has backed off, so usrsctp's
+ * SACK and retransmission timers are being handled timely.
+ */
+static void timer_activity() {
+    // Set activity
+    rawrtc_global.usrsctp_tick_activity_time = tmr_jiffies();
+
+    // Reschedule timer (if backed off)
+    if (rawrtc_global.usrsctp_tick_timeout > RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE &&
+            tmr_get_expire(&rawrtc_global.usrsctp_tick_timer)
+            > RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE) {
+        rawrtc_global.usrsctp_tick_timeout = RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE;
+        tmr_start(&rawrtc_global.usrsctp_tick_timer, rawrtc_global.usrsctp_tick_timeout,
+                  timer_handler, NULL);
+    }
+}
+
+/*
+ * Handle incoming DTLS messages.
+ */
+static void dtls_receive_handler(
+        struct mbuf* const buffer,
+        void* const arg
+) {
+    struct rawrtc_sctp_transport* const transport = arg;
+    size_t const length = mbuf_get_left(buffer);
+
+    // Closed?
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        DEBUG_PRINTF("Ignoring incoming SCTP message, transport is closed\n");
+        return;
+    }
+
+    // Trace (if trace handle)
+    // Note: No need to check if NULL as the function does it for us
+    trace_packet(transport, mbuf_buf(buffer), length, SCTP_DUMP_INBOUND);
+
+    // Speed up timer (packets are flowing)
+    timer_activity();
+
+    // Feed into SCTP socket
+    // TODO: What about ECN bits?
+    DEBUG_PRINTF("Feeding SCTP packet of %zu bytes\n", length);
+    usrsctp_conninput(transport, mbuf_buf(buffer), length, 0);
+}
+
+/*
+ * Create or resize SCTP data channel array.
+ *
+ * Warning: Will not pre-fill stream IDs of the members! Members need to
+ *          be un-referenced by the caller before the array is freed.
+ */
+static enum rawrtc_code data_channels_alloc(
+        struct rawrtc_data_channel*** channelsp, // de-referenced
+        uint_fast16_t const n_channels,
+        uint_fast16_t const n_channels_previously
+) {
+    size_t i;
+    struct rawrtc_data_channel** channels;
+
+    // Check arguments
+    if (!channelsp) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Allocated before and #channels is decreasing?
+    if (n_channels_previously > 0 && n_channels < n_channels_previously) {
+        // Ensure we're not removing active data channels
+        for (i = 0; i < n_channels_previously; ++i) {
+            if ((*channelsp)[i]) {
+                return RAWRTC_CODE_STILL_IN_USE;
+            }
+        }
+    }
+
+    // Allocate
+    channels = mem_reallocarray(*channelsp, n_channels, sizeof(*channels), NULL);
+    if (!channels) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Initialise
+    // Note: We can safely multiply 'n_channels' with size of the struct as 'mem_reallocarray'
+    //       ensures that it does not overflow (returns NULL).
+    if (n_channels > n_channels_previously) {
+        struct rawrtc_data_channel** channels_offset = channels + n_channels_previously;
+        memset(channels_offset, 0, (n_channels - n_channels_previously) * sizeof(*channels));
+    }
+
+    // Set pointer & done
+    *channelsp = channels;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Destructor for an existing ICE transport.
+ */
+static void rawrtc_sctp_transport_destroy(
+        void* arg
+) {
+  
+    DEBUG_INFO("--->[sctp_transport.c]: rawrtc_sctp_transport_destroy\n");
+  
+    struct rawrtc_sctp_transport* const transport = arg;
+    uint_fast16_t i;
+
+    // Stop transport
+    // TODO: Check effects in case transport has been destroyed due to error in create
+    rawrtc_sctp_transport_stop(transport);
+
+    // Un-reference
+    for (i = 0; i < transport->n_channels; ++i) {
+        mem_deref(transport->channels[i]);
+    }
+    mem_deref(transport->channels);
+    rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), transport->buffer_receive);
+    mem_deref(transport->buffer_dcep_inbound);
+    chunk_chain_flush(&transport->chain_dcep_inbound);
+    rawrtc_message_buffer_flush(&transport->buffered_messages_outgoing);
+    rawrtc_message_buffer_flush(&transport->buffered_messages_pending_streams);
+    list_flush(&transport->buffered_amount_high_channels);
+    mem_deref(transport->dtls_transport);
+
+    // Decrease in-use counter
+    --rawrtc_global.usrsctp_initialized;
+
+    // Close usrsctp (if needed)
+    if (rawrtc_global.usrsctp_initialized == 0) {
+        // Cancel timer
+        tmr_cancel(&rawrtc_global.usrsctp_tick_timer);
+
+        // Close
+        usrsctp_finish();
+        DEBUG_PRINTF("Closed usrsctp\n");
+    }
+}
+
+/*
+ * Create an SCTP transport.
+ */
+enum rawrtc_code rawrtc_sctp_transport_create(
+        struct rawrtc_sctp_transport** const transportp, // de-referenced
+        struct rawrtc_dtls_transport* const dtls_transport, // referenced
+        uint16_t port, // zeroable
+        rawrtc_data_channel_handler* const data_channel_handler, // nullable
+        rawrtc_sctp_transport_state_change_handler* const state_change_handler, // nullable
+        void* const arg // nullable
+) {
+    enum rawrtc_code error;
+    bool have_data_transport;
+    struct rawrtc_sctp_transport* transport;
+    struct sctp_assoc_value av;
+    struct linger linger_option;
+    struct sctp_event sctp_event = {0};
+    size_t i;
+    int option_value;
+    struct sockaddr_conn peer = {0};
+
+    // Check arguments
+    if (!transportp || !dtls_transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Check DTLS transport state
+    if (dtls_transport->state == RAWRTC_DTLS_TRANSPORT_STATE_CLOSED
+            || dtls_transport->state == RAWRTC_DTLS_TRANSPORT_STATE_FAILED) {
+        return RAWRTC_CODE_INVALID_STATE;
+    }
+
+    // Set default port (if 0)
+    if (port == 0) {
+        port = RAWRTC_SCTP_TRANSPORT_DEFAULT_PORT;
+    }
+
+    // Check if a data transport is already registered
+    error = rawrtc_dtls_transport_have_data_transport(&have_data_transport, dtls_transport);
+    if (error) {
+        return error;
+    }
+    if (have_data_transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Initialise usrsctp (if needed)
+    if (rawrtc_global.usrsctp_initialized == 0) {
+        DEBUG_PRINTF("Initialising usrsctp\n");
+        usrsctp_init(0, sctp_packet_handler, dbg_info);
+
+        // TODO: Debugging depending on options
+#ifdef SCTP_DEBUG
+        usrsctp_sysctl_set_sctp_debug_on(SCTP_DEBUG_ALL);
+#endif
+
+        // Do not send ABORTs in response to INITs (1).
+        // Do not send ABORTs for received Out of the Blue packets (2).
+        usrsctp_sysctl_set_sctp_blackhole(2);
+
+        // Disable the Explicit Congestion Notification extension
+        usrsctp_sysctl_set_sctp_ecn_enable(0);
+
+        // Disable the Address Reconfiguration extension
+        usrsctp_sysctl_set_sctp_asconf_enable(0);
+
+        // Disable the Authentication extension
+        usrsctp_sysctl_set_sctp_auth_enable(0);
+
+        // Disable the NR-SACK extension (not standardised)
+        usrsctp_sysctl_set_sctp_nrsack_enable(0);
+
+        // Disable the Packet Drop Report extension (not standardised)
+        usrsctp_sysctl_set_sctp_pktdrop_enable(0);
+
+        // Enable the Partial Reliability extension
+        usrsctp_sysctl_set_sctp_pr_enable(1);
+
+        // Enable interleaving messages for different streams (incoming)
+        // See: https://tools.ietf.org/html/rfc6458#section-8.1.20
+        usrsctp_sysctl_set_sctp_default_frag_interleave(2);
+
+        // Start timers
+        list_init(&rawrtc_global.usrsctp_transports);
+        tmr_init(&rawrtc_global.usrsctp_tick_timer);
+        timer_start();
+    }
+
+    // Allocate
+    transport = mem_zalloc(sizeof(*transport), rawrtc_sctp_transport_destroy);
+    if (!transport) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Increase in-use counter
+    // Note: This needs to be below allocation to ensure the counter is decreased properly on error
+    ++rawrtc_global.usrsctp_initialized;
+
+    // Set fields/reference
+    transport->state = RAWRTC_SCTP_TRANSPORT_STATE_NEW; // TODO: Raise state (delayed)?
+    transport->port = port;
+    transport->dtls_transport = mem_ref(dtls_transport);
+    transport->data_channel_handler = data_channel_handler;
+    transport->state_change_handler = state_change_handler;
+    transport->arg = arg;
+    rawrtc_message_buffer_init(&transport->buffered_messages_outgoing);
+    rawrtc_message_buffer_init(&transport->buffered_messages_pending_streams);
+    list_init(&transport->buffered_amount_high_channels);
+    tmr_init(&transport->event_timer);
+    transport->event_budget = RAWRTC_SCTP_TRANSPORT_DEFAULT_EVENT_BUDGET;
+
+    transport->max_streams = RAWRTC_SCTP_TRANSPORT_DEFAULT_NUMBER_OF_STREAMS;
+    transport->max_inbound_message_size = RAWRTC_SCTP_CAPABILITIES_MAX_MESSAGE_SIZE;
+    transport->scheduler = RAWRTC_SCTP_TRANSPORT_SCHEDULER_PRIORITY;
+
+    // Note: The channel array will be allocated (and grown) on demand
+    transport->channels = NULL;
+    transport->n_channels = 0;
+    transport->current_channel_sid = 0;
+
+    // Create packet tracer
+    // TODO: Debug mode only, filename set by debug options
+    transport->trace_handle = NULL
+#ifdef SCTP_DEBUG
+    {
+        char trace_handle_id[8];
+        char* trace_handle_name;
+
+        // Create trace handle ID
+        rand_str(trace_handle_id, sizeof(trace_handle_id));
+        error = rawrtc_sdprintf(&trace_handle_name, "trace-sctp-%s.hex", trace_handle_id);
+        if (error) {
+            DEBUG_WARNING("Could create trace file name, reason: %s\n", rawrtc_code_to_str(error));
+        } else {
+            // Open trace file
+            transport->trace_handle = fopen(trace_handle_name, "w");
+            mem_deref(trace_handle_name);
+            if (!transport->trace_handle) {
+                DEBUG_WARNING("Could not open trace file, reason: %m\n", errno);
+            } else {
+                DEBUG_INFO("Using trace handle id: %s\n", trace_handle_id);
+            }
+        }
+    }
+#endif
+
+    // Create SCTP socket
+    DEBUG_PRINTF("Creating SCTP socket\n");
+    transport->socket = usrsctp_socket(
+            AF_CONN, SOCK_STREAM, IPPROTO_SCTP, NULL, NULL, 0, NULL);
+    if (!transport->socket) {
+        DEBUG_WARNING("Could not create socket, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
+
+    // Register instance
+    usrsctp_register_address(transport);
+    list_append(&rawrtc_global.usrsctp_transports, &transport->le, transport);
+
+    // Make socket non-blocking
+    if (usrsctp_set_non_blocking(transport->socket, 1)) {
+        DEBUG_WARNING("Could not set to non-blocking, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
+
+    // Set event callback
+    if (usrsctp_set_upcall(transport->socket, upcall_handler_helper, transport)) {
+        DEBUG_WARNING("Could not set event callback (upcall), reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
+
+    // Determine chunk size
+    if (rawrtc_global.usrsctp_initialized == 1) {
+        socklen_t option_size = sizeof(int); // PD point is int according to spec
+        if (usrsctp_getsockopt(
+                transport->socket, IPPROTO_SCTP, SCTP_PARTIAL_DELIVERY_POINT,
+                &option_value, &option_size)) {
+            DEBUG_WARNING("Could not retrieve partial delivery point, reason: %m\n", errno);
+            error = rawrtc_error_to_code(errno);
             goto out;
-            break;
+        }
+
+        // Check value
+        if (option_size != sizeof(int) || option_value < 1) {
+            DEBUG_WARNING("Invalid partial delivery point value: %d\n", option_value);
+            error = RAWRTC_CODE_INITIALISE_FAIL;
+            goto out;
+        }
+
+        // Store value
+        rawrtc_global.usrsctp_chunk_size = (size_t) option_value;
+        DEBUG_PRINTF("Chunk size: %zu\n", rawrtc_global.usrsctp_chunk_size);
     }
 
-    // Pass message to handler
-    if (channel->message_handler) {
-        channel->message_handler(context->buffer_inbound, message_flags, channel->arg);
-    } else {
-        DEBUG_NOTICE("No message handler, message of %zu bytes has been discarded\n",
-                      mbuf_get_left(context->buffer_inbound));
+    // Enable the Stream Reconfiguration extension
+    av.assoc_id = SCTP_ALL_ASSOC;
+    av.assoc_value = SCTP_ENABLE_RESET_STREAM_REQ | SCTP_ENABLE_CHANGE_ASSOC_REQ;
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_ENABLE_STREAM_RESET,
+                           &av, sizeof(struct sctp_assoc_value))) {
+        DEBUG_WARNING("Could not enable stream reconfiguration extension, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
     }
 
-    // Done
-    error = RAWRTC_CODE_SUCCESS;
+    // Set amount of streams
+    error = set_init_streams(transport);
+    if (error) {
+        goto out;
+    }
 
-out:
+    // Set stream scheduler
+    error = set_scheduler(transport);
     if (error) {
-        DEBUG_WARNING("Unable to handle application message, reason: %s\n",
-                      rawrtc_code_to_str(error));
+        goto out;
+    }
 
-        // TODO: Reset stream with SID
+    // TODO: Set MTU (1200|1280 (IPv4|IPv6) - UDP - DTLS (cipher suite dependent) - SCTP (12)
+    // https://github.com/ortclib/ortclib-cpp/blob/master/ortc/cpp/ortc_SCTPTransport.cpp#L2143
+
+    // We want info
+    option_value = 1;
+    if (usrsctp_setsockopt(
+            transport->socket, IPPROTO_SCTP, SCTP_RECVRCVINFO,
+            &option_value, sizeof(option_value))) {
+        DEBUG_WARNING("Could not set info option, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
     }
 
-    // Un-reference
-    if (context) {
-        context->buffer_inbound = mem_deref(context->buffer_inbound);
-        context = mem_deref(context);
+    // Enable interleaving messages for different streams (outgoing)
+    // See: https://tools.ietf.org/html/rfc8260
+    // Note: This is an optional extension, so we'll continue without it if unavailable.
+    enable_interleaving(transport);
+
+    // Discard pending packets when closing
+    // (so we don't get a callback when the transport is already free'd)
+    // TODO: Find a way to use graceful shutdown instead, otherwise the other peer would raise an
+    // error indication (https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.2)
+    linger_option.l_onoff = 1;
+    linger_option.l_linger = 0;
+    if (usrsctp_setsockopt(transport->socket, SOL_SOCKET, SO_LINGER,
+                           &linger_option, sizeof(linger_option))) {
+        DEBUG_WARNING("Could not set linger options, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
     }
-}
 
-/*
- * Handle incoming DCEP control message.
- */
-static void handle_dcep_message(
-        struct rawrtc_sctp_transport* const transport, // not checked
-        struct mbuf* const buffer, // not checked
-        struct sctp_rcvinfo* info, // not checked
-        int const flags
-) {
-    enum rawrtc_code error;
+    // Set no delay option (disable nagle)
+    option_value = 1;
+    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_NODELAY,
+                           &option_value, sizeof(option_value))) {
+        DEBUG_WARNING("Could not set no-delay, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
 
-    // Buffer message (if needed) and get complete message (if any)
-    error = buffer_message_received_raise_complete(
-            &transport->buffer_dcep_inbound, &transport->info_dcep_inbound,
-            buffer, info, flags);
-    switch (error) {
-        case RAWRTC_CODE_SUCCESS:
-            break;
-        case RAWRTC_CODE_NO_VALUE:
-            // Message buffered, early return here
-            return;
-        default:
-            DEBUG_WARNING("Could not buffer/complete DCEP message, reason: %s\n",
-                          rawrtc_code_to_str(error));
+    // Set explicit EOR
+    option_value = 1;
+    if (usrsctp_setsockopt(
+            transport->socket, IPPROTO_SCTP, SCTP_EXPLICIT_EOR,
+            &option_value, sizeof(option_value))) {
+        DEBUG_WARNING("Could not enable explicit EOR, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
+
+    // Subscribe to SCTP event notifications
+    sctp_event.se_assoc_id = SCTP_ALL_ASSOC;
+    sctp_event.se_on = 1;
+    for (i = 0; i < sctp_events_length; ++i) {
+        sctp_event.se_type = sctp_events[i];
+        if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_EVENT,
+                               &sctp_event, sizeof(sctp_event))) {
+            DEBUG_WARNING("Could not subscribe to event notification, reason: %m", errno);
+            error = rawrtc_error_to_code(errno);
             goto out;
-            break;
+        }
     }
 
-    // Update info pointer
-    info = &transport->info_dcep_inbound;
+    // Bind local address
+    peer.sconn_family = AF_CONN;
+    // TODO: Check for existance of sconn_len
+    //sconn.sconn_len = sizeof(peer);
+    peer.sconn_port = htons(transport->port);
+    peer.sconn_addr = transport;
+    if (usrsctp_bind(transport->socket, (struct sockaddr*) &peer, sizeof(peer))) {
+        DEBUG_WARNING("Could not bind local address, reason: %m\n", errno);
+        error = rawrtc_error_to_code(errno);
+        goto out;
+    }
 
-    // Handle by message type
-    // Note: There MUST be at least a byte present in the buffer as SCTP cannot handle empty
-    //       messages.
-    uint_fast16_t const message_type = mbuf_read_u8(transport->buffer_dcep_inbound);
-    switch (message_type) {
-        case RAWRTC_DCEP_MESSAGE_TYPE_ACK:
-            DEBUG_PRINTF("Received data channel ack message for channel with SID %"PRIu16"\n",
-                         info->rcv_sid);
-            handle_data_channel_ack_message(transport, info);
-            break;
-        case RAWRTC_DCEP_MESSAGE_TYPE_OPEN:
-            DEBUG_PRINTF("Received data channel open message for channel with SID %"PRIu16"\n",
-                         info->rcv_sid);
-            handle_data_channel_open_message(transport, transport->buffer_dcep_inbound, info);
-            break;
-        default:
-            DEBUG_WARNING("Ignored incoming DCEP control message with unknown type: %"PRIu16"\n",
-                          message_type);
-            break;
+    // Attach to ICE transport
+    DEBUG_PRINTF("Attaching as data transport\n");
+    error = rawrtc_dtls_transport_set_data_transport(
+            transport->dtls_transport, dtls_receive_handler, transport);
+    if (error) {
+        goto out;
     }
 
-    // Done
-    error = RAWRTC_CODE_SUCCESS;
+    // Apply path MTU of the DTLS transport (and follow changes)
+    error = rawrtc_dtls_transport_set_path_mtu_handler(
+            transport->dtls_transport, dtls_path_mtu_handler);
+    if (error) {
+        goto out;
+    }
 
 out:
     if (error) {
-        DEBUG_WARNING("Unable to handle DCEP message, reason: %s\n", rawrtc_code_to_str(error));
-
-        // TODO: Close channel?
+        mem_deref(transport);
+    } else {
+        // Set pointer
+        *transportp = transport;
     }
-
-    // Un-reference
-    transport->buffer_dcep_inbound = mem_deref(transport->buffer_dcep_inbound);
+    return error;
 }
 
 /*
- * Handle incoming data message.
+ * Destructor for an existing data channel context.
  */
-static void data_receive_handler(
-        struct rawrtc_sctp_transport* const transport,
-        struct mbuf* const buffer,
-        struct sctp_rcvinfo* const info,
-        int const flags
+static void channel_context_destroy(
+        void* arg
 ) {
-    // Convert PPID first
-    info->rcv_ppid = ntohl(info->rcv_ppid);
-    DEBUG_PRINTF("Received message with SID %"PRIu16", PPID: %"PRIu32"\n",
-                 info->rcv_sid, info->rcv_ppid);
+    struct rawrtc_sctp_data_channel_context* const context = arg;
 
-    // Handle by PPID
-    if (info->rcv_ppid == RAWRTC_SCTP_TRANSPORT_PPID_DCEP) {
-        handle_dcep_message(transport, buffer, info, flags);
-    } else {
-        handle_application_message(transport, buffer, info, flags);
-    }
+    // Un-reference
+    mem_deref(context->buffer_inbound);
+    chunk_chain_flush(&context->chain_inbound);
 }
 
 /*
- * Handle usrsctp read event.
+ * Allocate data channel context.
  */
-static int read_event_handler(
-        struct rawrtc_sctp_transport* const transport // not checked
+static enum rawrtc_code channel_context_create(
+        struct rawrtc_sctp_data_channel_context** const contextp, // de-referenced, not checked
+        uint16_t const sid,
+        bool const can_send_unordered
 ) {
-    struct mbuf* buffer;
-    ssize_t length;
-    int ignore_events = RAWRTC_SCTP_EVENT_NONE;
-    struct sctp_rcvinfo info = {0};
-    socklen_t info_length = sizeof(info);
-    unsigned int info_type = 0;
-    int flags = 0;
-
-    // Closed?
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        DEBUG_NOTICE("Ignoring read event, transport is closed\n");
-        return RAWRTC_SCTP_EVENT_ALL;
-    }
-
-    // TODO: Get next message size
-    // TODO: Can we get the COMPLETE message size or just the current message size?
-
-    // Create buffer
-    buffer = mbuf_alloc(rawrtc_global.usrsctp_chunk_size);
-    if (!buffer) {
-        DEBUG_WARNING("Cannot allocate buffer, no memory");
-        // TODO: This needs to be handled in a better way, otherwise it's probably going
-        // to cause another read call which calls this handler again resulting in an infinite
-        // loop.
-        return RAWRTC_SCTP_EVENT_NONE;
-    }
-
-    // Receive notification or data
-    length = usrsctp_recvv(
-            transport->socket, buffer->buf, buffer->size, NULL, NULL,
-            &info, &info_length, &info_type, &flags);
-    if (length < 0) {
-        // Meh...
-        if (errno == EAGAIN) {
-//            DEBUG_NOTICE("@ruengeler: usrsctp raised a read event but returned EAGAIN\n");
-            ignore_events = SCTP_EVENT_READ;
-            goto out;
-        }
-
-        // Handle error
-        DEBUG_WARNING("SCTP receive failed, reason: %m\n", errno);
-        // TODO: What now? Close?
-        goto out;
-    }
-
-    // Update buffer position and end
-    mbuf_set_end(buffer, (size_t) length);
-
-    // Handle notification
-    if (flags & MSG_NOTIFICATION) {
-        handle_notification(transport, buffer);
-        goto out;
-    }
-
-    // Check state
-    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
-        DEBUG_WARNING("Ignored incoming data before state 'connected'\n");
-        goto out;
+    // Allocate context
+    struct rawrtc_sctp_data_channel_context* const context =
+            mem_zalloc(sizeof(*context), channel_context_destroy);
+    if (!context) {
+        return RAWRTC_CODE_NO_MEMORY;
     }
 
-    // Have info?
-    if (info_type != SCTP_RECVV_RCVINFO) {
-        DEBUG_WARNING("Cannot handle incoming data without SCTP rcvfinfo\n");
-        goto out;
+    // Set fields
+    context->sid = sid;
+    if (can_send_unordered) {
+        context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED;
     }
 
-    // Pass data to handler
-    data_receive_handler(transport, buffer, &info, flags);
-
-out:
-    // Un-reference
-    mem_deref(buffer);
-
-    // Done
-    return ignore_events;
+    // Set pointer & done
+    *contextp = context;
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Handle usrsctp write event.
+ * Check if a data channel is registered on the transport.
  */
-static int write_event_handler(
-        struct rawrtc_sctp_transport* const transport // not checked
+static bool channel_registered(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel* const channel // not checked
 ) {
-    // Closed?
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        DEBUG_NOTICE("Ignoring write event, transport is closed\n");
-        return RAWRTC_SCTP_EVENT_ALL;
-    }
-
-    // Send all deferred messages (if not already sending)
-    // TODO: Check if this flag is really necessary
-    if (!(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS)) {
-        enum rawrtc_code error;
+    // Get context
+    struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
 
-        // Send
-        transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
-        error = sctp_send_deferred_messages(transport);
-        transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
-        switch (error) {
-            case RAWRTC_CODE_SUCCESS:
-            case RAWRTC_CODE_STOP_ITERATION:
-                // We either sent all pending messages or could not send all messages, so there's
-                // no reason to react to further write events in this iteration
-                return SCTP_EVENT_WRITE;
-            default:
-                // TODO: What now? Close?
-                DEBUG_WARNING("Could not send deferred messages, reason: %s\n",
-                              rawrtc_code_to_str(error));
-                return SCTP_EVENT_WRITE;
-        }
+    // Check status
+    if (transport->channels[context->sid] != channel) {
+        DEBUG_WARNING("Invalid channel instance in slot. Please report this.\n");
+        return false;
     } else {
-        DEBUG_WARNING("Sending still in progress!\n");
-        // TODO: Is this correct?
-        return SCTP_EVENT_WRITE;
+        return true;
     }
 }
 
 /*
- * Handle usrsctp error event.
+ * Register data channel on transport.
  */
-static bool error_event_handler(
-        struct rawrtc_sctp_transport* const transport // not checked
+static void channel_register(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel* const channel, // referenced, not checked
+        struct rawrtc_sctp_data_channel_context* const context, // referenced, not checked
+        bool const raise_event
 ) {
-    // Closed?
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        DEBUG_NOTICE("Ignoring error event, transport is closed\n");
-        return RAWRTC_SCTP_EVENT_ALL;
+    // Update channel with referenced context
+    channel->transport_arg = mem_ref(context);
+    transport->channels[context->sid] = mem_ref(channel);
+
+    // Apply priority (if the stream already exists)
+    // Note: Failing to apply a priority is not fatal
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED &&
+            context->sid < transport->n_outbound_streams) {
+        set_stream_priority(transport, channel, context);
     }
 
-    // TODO: What am I supposed to do with this information?
-    DEBUG_WARNING("TODO: Handle SCTP error event\n");
+    // Raise data channel event?
+    if (raise_event) {
+        // Call data channel handler (if any)
+        rawrtc_data_channel_call_channel_handler(
+                channel, transport->data_channel_handler, transport->arg);
+    }
 
-    // Continue handling events
-    // TODO: Probably depends on the error, right?
-    return RAWRTC_SCTP_EVENT_NONE;
+    // Update data channel state
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
+        rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_OPEN);
+    }
 }
 
 /*
- * usrsctp event handler helper.
+ * Create a negotiated SCTP data channel.
  */
-static void upcall_handler_helper(
-        struct socket* socket,
-        void* arg,
-        int flags
+static enum rawrtc_code channel_create_negotiated(
+        struct rawrtc_sctp_data_channel_context** const contextp, // de-referenced, not checked
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel_parameters const * const parameters // read-only
 ) {
-    int events = usrsctp_get_events(socket);
-    struct rawrtc_sctp_transport* const transport = arg;
-    int ignore_events = RAWRTC_SCTP_EVENT_NONE;
-    (void) flags; // TODO: What does this indicate?
-
-    // Lock event loop mutex
-    rawrtc_thread_enter();
-
-    // TODO: This loop may lead to long blocking and is unfair to normal fds.
-    //       It's a compromise because scheduling repetitive timers in re's event loop seems to
-    //       be slow.
-    while (events) {
-        // TODO: This should work but it doesn't because usrsctp keeps switching from read to write
-        //       events endlessly for some reason. So, we need to discard previous events.
-        //ignore_events = RAWRTC_SCTP_EVENT_NONE;
-
-        // Handle error event
-        if (events & SCTP_EVENT_ERROR) {
-            ignore_events |= error_event_handler(transport);
-        }
-
-        // Handle read event
-        if (events & SCTP_EVENT_READ) {
-            ignore_events |= read_event_handler(transport);
-        }
+    enum rawrtc_code error;
 
-        // Handle write event
-        if (events & SCTP_EVENT_WRITE) {
-            ignore_events |= write_event_handler(transport);
-        }
+    // Check SID (> max, >= max streams, or channel already occupied)
+    if (parameters->id > RAWRTC_SCTP_TRANSPORT_SID_MAX ||
+        parameters->id >= transport->max_streams ||
+        get_channel(transport, parameters->id)) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-        // Get upcoming events and remove events that should be ignored
-        events = usrsctp_get_events(socket) & ~ignore_events;
+    // Ensure there's a slot and an outgoing stream for the SID
+    error = reserve_channel(transport, parameters->id);
+    if (error) {
+        return error;
+    }
+    error = want_outbound_stream(transport, parameters->id);
+    if (error) {
+        return error;
     }
 
-    // Unlock event loop mutex
-    rawrtc_thread_leave();
+    // Allocate context to be used as an argument for the data channel handlers
+    // TODO: Is it okay to already allow sending unordered messages here? Assuming: Yes.
+    return channel_context_create(contextp, parameters->id, true);
 }
 
 /*
- * Handle SCTP timer tick.
+ * Create an SCTP data channel that needs negotiation.
  */
-static void timer_handler(
-        void* arg
+static enum rawrtc_code channel_create_inband(
+        struct rawrtc_sctp_data_channel_context** const contextp, // de-referenced, not checked
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_data_channel_parameters const * const parameters // read-only
 ) {
-    (void) arg;
+    enum rawrtc_code error;
+    uint_fast16_t i;
+    struct rawrtc_sctp_data_channel_context* context;
+    struct mbuf* buffer;
 
-    // Restart timer
-    tmr_start(&rawrtc_global.usrsctp_tick_timer, RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT,
-              timer_handler, NULL);
+    // Check DTLS state
+    // Note: We need to have an open DTLS connection to determine whether we use odd or even
+    // SIDs.
+    // TODO: Can we fix this somehow to make it possible to create data channels earlier?
+    if (transport->dtls_transport->state != RAWRTC_DTLS_TRANSPORT_STATE_CONNECTED) {
+        return RAWRTC_CODE_INVALID_STATE;
+    }
 
-    // Pass delta ms to usrsctp
-    usrsctp_handle_timers(RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT);
-}
+    // Use odd or even SIDs
+    switch (transport->dtls_transport->role) {
+        case RAWRTC_DTLS_ROLE_CLIENT:
+            i = 0;
+            break;
+        case RAWRTC_DTLS_ROLE_SERVER:
+            i = 1;
+            break;
+        default:
+            return RAWRTC_CODE_INVALID_STATE;
+    }
 
-/*
- * Handle incoming DTLS messages.
- */
-static void dtls_receive_handler(
-        struct mbuf* const buffer,
-        void* const arg
-) {
-    struct rawrtc_sctp_transport* const transport = arg;
-    size_t const length = mbuf_get_left(buffer);
+    // Find free SID
+    // Note: Prefers SIDs of existing outgoing streams and grows the channel array if needed.
+    context = NULL;
+    for (; i < transport->max_streams; i += 2) {
+        if (!get_channel(transport, i)) {
+            // Ensure there's a slot and an outgoing stream for the SID
+            error = reserve_channel(transport, i);
+            if (error) {
+                return error;
+            }
+            error = want_outbound_stream(transport, i);
+            if (error) {
+                return error;
+            }
 
-    // Closed?
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        DEBUG_PRINTF("Ignoring incoming SCTP message, transport is closed\n");
-        return;
+            // Allocate context to be used as an argument for the data channel handlers
+            error = channel_context_create(&context, (uint16_t) i, false);
+            if (error) {
+                return error;
+            }
+            break;
+        }
+    }
+    if (!context) {
+        return RAWRTC_CODE_INSUFFICIENT_SPACE;
     }
 
-    // Trace (if trace handle)
-    // Note: No need to check if NULL as the function does it for us
-    trace_packet(transport, mbuf_buf(buffer), length, SCTP_DUMP_INBOUND);
+    // Create open message
+    buffer = NULL;
+    error = data_channel_open_message_create(&buffer, parameters);
+    if (error) {
+        goto out;
+    }
 
-    // Feed into SCTP socket
-    // TODO: What about ECN bits?
-    DEBUG_PRINTF("Feeding SCTP packet of %zu bytes\n", length);
-    usrsctp_conninput(transport, mbuf_buf(buffer), length, 0);
-}
+    // Send message
+    DEBUG_PRINTF("Sending data channel open message for channel with SID %"PRIu16"\n",
+                 context->sid);
+    error = send_message(transport, NULL, context, buffer, RAWRTC_SCTP_TRANSPORT_PPID_DCEP);
+    if (error) {
+        goto out;
+    }
 
-/*
- * Destructor for an existing SCTP data channel array.
- */
-static void data_channels_destroy(
-        void* arg
-) {
-    struct rawrtc_sctp_transport* const transport = arg;
-    uint_fast16_t i;
+out:
+    // Un-reference
+    rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
 
-    // Un-reference all members
-    for (i = 0; i < transport->n_channels; ++i) {
-        mem_deref(transport->channels[i]);
+    if (error) {
+        mem_deref(context);
+    } else {
+        // Set pointer
+        *contextp = context;
     }
+    return error;
 }
 
 /*
- * Create SCTP data channel array.
- *
- * Warning: Will not pre-fill stream IDs of the members!
+ * Create the SCTP data channel.
  */
-enum rawrtc_code data_channels_alloc(
-        struct rawrtc_data_channel*** channelsp, // de-referenced
-        uint_fast16_t const n_channels,
-        uint_fast16_t const n_channels_previously
+static enum rawrtc_code channel_create_handler(
+        struct rawrtc_data_transport* const transport,
+        struct rawrtc_data_channel* const channel, // referenced
+        struct rawrtc_data_channel_parameters const * const parameters // read-only
 ) {
-    size_t i;
-    struct rawrtc_data_channel** channels;
+    struct rawrtc_sctp_transport* sctp_transport;
+    enum rawrtc_code error;
+    struct rawrtc_sctp_data_channel_context* context;
 
     // Check arguments
-    if (!channelsp) {
+    if (!transport || !channel || !parameters) {
         return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Allocated before and #channels is decreasing?
-    if (n_channels_previously > 0 && n_channels < n_channels_previously) {
-        // Ensure we're not removing active data channels
-        for (i = 0; i < n_channels_previously; ++i) {
-            if ((*channelsp)[i]) {
-                return RAWRTC_CODE_STILL_IN_USE;
-            }
-        }
-    }
+    // TODO: Check if closed?
 
-    // Allocate
-    channels = mem_reallocarray(*channelsp, n_channels, sizeof(*channels), data_channels_destroy);
-    if (!channels) {
-        return RAWRTC_CODE_NO_MEMORY;
-    }
+    // Get SCTP transport
+    sctp_transport = transport->transport;
 
-    // Initialise
-    // Note: We can safely multiply 'n_channels' with size of the struct as 'mem_reallocarray'
-    //       ensures that it does not overflow (returns NULL).
-    if (n_channels > n_channels_previously) {
-        struct rawrtc_data_channel** channels_offset = channels + n_channels_previously;
-        memset(channels_offset, 0, (n_channels - n_channels_previously) * sizeof(*channels));
+    // Create negotiated or in-band data channel
+    if (parameters->negotiated) {
+        error = channel_create_negotiated(&context, sctp_transport, parameters);
+    } else {
+        error = channel_create_inband(&context, sctp_transport, parameters);
+    }
+    if (error) {
+        return error;
     }
 
-    // Set pointer & done
-    *channelsp = channels;
+    // Register data channel
+    channel_register(sctp_transport, channel, context, false);
+
+    // Un-reference & done
+    mem_deref(context);
     return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Destructor for an existing ICE transport.
+ * Close the data channel (transport handler).
  */
-static void rawrtc_sctp_transport_destroy(
-        void* arg
+static enum rawrtc_code channel_close_handler(
+        struct rawrtc_data_channel* const channel
 ) {
-  
-    DEBUG_INFO("--->[sctp_transport.c]: rawrtc_sctp_transport_destroy\n");
-  
-    struct rawrtc_sctp_transport* const transport = arg;
+    struct rawrtc_sctp_transport* transport;
+    struct rawrtc_sctp_data_channel_context* context;
 
-    // Stop transport
-    // TODO: Check effects in case transport has been destroyed due to error in create
-    rawrtc_sctp_transport_stop(transport);
+    // Check arguments
+    if (!channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-    // Un-reference
-    mem_deref(transport->channels);
-    mem_deref(transport->buffer_dcep_inbound);
-    list_flush(&transport->buffered_messages_outgoing);
-    mem_deref(transport->dtls_transport);
+    // TODO: Check if closed?
 
-    // Decrease in-use counter
-    --rawrtc_global.usrsctp_initialized;
+    // Get SCTP transport & context
+    transport = channel->transport->transport;
+    context = channel->transport_arg;
 
-    // Close usrsctp (if needed)
-    if (rawrtc_global.usrsctp_initialized == 0) {
-        // Cancel timer
-        tmr_cancel(&rawrtc_global.usrsctp_tick_timer);
+    // Un-reference channel and clear pointer (if channel was registered before)
+    // Note: The context will be NULL if the channel was not registered before
+    if (context) {
+        DEBUG_PRINTF("Closing channel with SID %"PRIu16"\n", context->sid);
 
-        // Close
-        usrsctp_finish();
-        DEBUG_PRINTF("Closed usrsctp\n");
+        // Sanity check
+        if (!channel_registered(transport, channel)) {
+            return RAWRTC_CODE_SCTP_TRANSPORT_ERROR;
+        }
+
+        // Reset outgoing streams
+        // Important: This function will change the state of the channel to CLOSED
+        //            and remove the channel from the transport on error.
+        if (!reset_outgoing_stream(transport, channel)) {
+            rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSING);
+        }
     }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
- * Create an SCTP transport.
+ * Send data via the data channel (transport handler).
  */
-enum rawrtc_code rawrtc_sctp_transport_create(
-        struct rawrtc_sctp_transport** const transportp, // de-referenced
-        struct rawrtc_dtls_transport* const dtls_transport, // referenced
-        uint16_t port, // zeroable
-        rawrtc_data_channel_handler* const data_channel_handler, // nullable
-        rawrtc_sctp_transport_state_change_handler* const state_change_handler, // nullable
-        void* const arg // nullable
+static enum rawrtc_code channel_send_handler(
+        struct rawrtc_data_channel* const channel,
+        struct mbuf* buffer, // nullable (if size 0), referenced
+        bool const is_binary
 ) {
-    enum rawrtc_code error;
-    uint_fast16_t n_channels;
-    bool have_data_transport;
     struct rawrtc_sctp_transport* transport;
-    struct sctp_assoc_value av;
-    struct linger linger_option;
-    struct sctp_event sctp_event = {0};
-    size_t i;
-    int option_value;
-    struct sockaddr_conn peer = {0};
+    size_t length;
+    uint_fast32_t ppid;
+    struct mbuf* empty = NULL;
+    enum rawrtc_code error;
 
     // Check arguments
-    if (!transportp || !dtls_transport) {
+    if (!channel) {
         return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Check DTLS transport state
-    if (dtls_transport->state == RAWRTC_DTLS_TRANSPORT_STATE_CLOSED
-            || dtls_transport->state == RAWRTC_DTLS_TRANSPORT_STATE_FAILED) {
-        return RAWRTC_CODE_INVALID_STATE;
+    // TODO: Check if closed?
+
+    // Get SCTP transport
+    transport = channel->transport->transport;
+
+    // We accept both a NULL buffer and a buffer of length 0
+    if (!buffer) {
+        length = 0;
+    } else {
+        length = mbuf_get_left(buffer);
     }
 
-    // Set number of channels
-    // TODO: Get from config
-    n_channels = RAWRTC_SCTP_TRANSPORT_DEFAULT_NUMBER_OF_STREAMS;
+    // Empty message?
+    if (length == 0) {
+        // Set PPID
+        if (is_binary) {
+            ppid = RAWRTC_SCTP_TRANSPORT_PPID_BINARY_EMPTY;
+        } else {
+            ppid = RAWRTC_SCTP_TRANSPORT_PPID_UTF16_EMPTY;
+        }
 
-    // Set default port (if 0)
-    if (port == 0) {
-        port = RAWRTC_SCTP_TRANSPORT_DEFAULT_PORT;
+        // Create helper message as SCTP is unable to send messages of size 0
+        error = rawrtc_buffer_pool_get(
+                &empty, rawrtc_buffer_pool_global(), RAWRTC_SCTP_TRANSPORT_EMPTY_MESSAGE_SIZE);
+        if (error) {
+            return error;
+        }
+
+        // Note: The content is being ignored
+        error = rawrtc_error_to_code(mbuf_write_u8(empty, 0));
+        if (error) {
+            goto out;
+        }
+
+        // Set position & pointer
+        mbuf_set_pos(empty, 0);
+        buffer = empty;
+    } else {
+        // Check size
+        if (transport->remote_maximum_message_size != 0 &&
+            length > transport->remote_maximum_message_size) {
+            return RAWRTC_CODE_MESSAGE_TOO_LONG;
+        }
+
+        // Set PPID
+        // Note: We will not use the deprecated fragmentation & reassembly
+        if (is_binary) {
+            ppid = RAWRTC_SCTP_TRANSPORT_PPID_BINARY;
+        } else {
+            ppid = RAWRTC_SCTP_TRANSPORT_PPID_UTF16;
+        }
     }
 
-    // Check if a data transport is already registered
-    error = rawrtc_dtls_transport_have_data_transport(&have_data_transport, dtls_transport);
+    // Send
+    error = send_message(transport, channel, channel->transport_arg, buffer, ppid);
     if (error) {
-        return error;
-    }
-    if (have_data_transport) {
-        return RAWRTC_CODE_INVALID_ARGUMENT;
+        goto out;
     }
 
-    // Initialise usrsctp (if needed)
-    if (rawrtc_global.usrsctp_initialized == 0) {
-        DEBUG_PRINTF("Initialising usrsctp\n");
-        usrsctp_init(0, sctp_packet_handler, dbg_info);
+    // Wait for a buffered amount low event (if above threshold)
+    update_buffered_amount_high(transport, channel);
 
-        // TODO: Debugging depending on options
-#ifdef SCTP_DEBUG
-        usrsctp_sysctl_set_sctp_debug_on(SCTP_DEBUG_ALL);
-#endif
+out:
+    // Un-reference
+    rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), empty);
 
-        // Do not send ABORTs in response to INITs (1).
-        // Do not send ABORTs for received Out of the Blue packets (2).
-        usrsctp_sysctl_set_sctp_blackhole(2);
+    // Done
+    return error;
+}
 
-        // Disable the Explicit Congestion Notification extension
-        usrsctp_sysctl_set_sctp_ecn_enable(0);
+/*
+ * Copy segments into a single buffer, skipping the first `offset`
+ * bytes.
+ */
+static enum rawrtc_code segments_to_buffer(
+        struct mbuf** const bufferp, // de-referenced, not checked
+        struct iovec const * const segments, // not checked
+        size_t const n_segments,
+        size_t const length,
+        size_t offset
+) {
+    struct mbuf* buffer;
+    size_t i;
+    int err = 0;
+    enum rawrtc_code error;
 
-        // Disable the Address Reconfiguration extension
-        usrsctp_sysctl_set_sctp_asconf_enable(0);
+    // Get buffer
+    error = rawrtc_buffer_pool_get(&buffer, rawrtc_buffer_pool_global(), length - offset);
+    if (error) {
+        return error;
+    }
 
-        // Disable the Authentication extension
-        usrsctp_sysctl_set_sctp_auth_enable(0);
+    // Copy segments
+    for (i = 0; i < n_segments && !err; ++i) {
+        uint8_t* const base = segments[i].iov_base;
+        size_t const segment_length = segments[i].iov_len;
 
-        // Disable the NR-SACK extension (not standardised)
-        usrsctp_sysctl_set_sctp_nrsack_enable(0);
+        // Skip
+        if (offset >= segment_length) {
+            offset -= segment_length;
+            continue;
+        }
 
-        // Disable the Packet Drop Report extension (not standardised)
-        usrsctp_sysctl_set_sctp_pktdrop_enable(0);
+        // Copy
+        err = mbuf_write_mem(buffer, base + offset, segment_length - offset);
+        offset = 0;
+    }
+    if (err) {
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
+        return rawrtc_error_to_code(err);
+    }
 
-        // Enable the Partial Reliability extension
-        usrsctp_sysctl_set_sctp_pr_enable(1);
+    // Set position & pointer
+    mbuf_set_pos(buffer, 0);
+    *bufferp = buffer;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-        // Set amount of incoming streams
-        usrsctp_sysctl_set_sctp_nr_incoming_streams_default((uint32_t) n_channels);
+/*
+ * Send data consisting of multiple segments via the data channel
+ * (transport handler).
+ *
+ * The segments will be handed out to usrsctp without merging them. Only
+ * if the message needs to be buffered, the remaining data will be
+ * copied.
+ */
+static enum rawrtc_code channel_sendv_handler(
+        struct rawrtc_data_channel* const channel,
+        struct iovec const * const segments, // nullable (if size 0), copied
+        size_t const n_segments,
+        bool const is_binary
+) {
+    struct rawrtc_sctp_transport* transport;
+    struct rawrtc_sctp_data_channel_context* context;
+    struct sctp_sendv_spa spa = {0};
+    size_t length = 0;
+    size_t written = 0;
+    size_t i;
+    uint_fast32_t ppid;
+    struct mbuf* buffer = NULL;
+    enum rawrtc_code error;
 
-        // Set amount of outgoing streams
-        usrsctp_sysctl_set_sctp_nr_outgoing_streams_default((uint32_t) n_channels);
+    // Check arguments
+    if (!channel || (n_segments > 0 && !segments)) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-        // Enable interleaving messages for different streams (incoming)
-        // See: https://tools.ietf.org/html/rfc6458#section-8.1.20
-        usrsctp_sysctl_set_sctp_default_frag_interleave(2);
+    // Get SCTP transport & context
+    transport = channel->transport->transport;
+    context = channel->transport_arg;
 
-        // Start timers
-        tmr_init(&rawrtc_global.usrsctp_tick_timer);
-        tmr_start(&rawrtc_global.usrsctp_tick_timer, RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT,
-                  timer_handler, NULL);
+    // Sum up length
+    for (i = 0; i < n_segments; ++i) {
+        length += segments[i].iov_len;
     }
 
-    // Allocate
-    transport = mem_zalloc(sizeof(*transport), rawrtc_sctp_transport_destroy);
-    if (!transport) {
-        return RAWRTC_CODE_NO_MEMORY;
+    // Empty message?
+    if (length == 0) {
+        return channel_send_handler(channel, NULL, is_binary);
     }
 
-    // Increase in-use counter
-    // Note: This needs to be below allocation to ensure the counter is decreased properly on error
-    ++rawrtc_global.usrsctp_initialized;
+    // Check size
+    if (transport->remote_maximum_message_size != 0 &&
+        length > transport->remote_maximum_message_size) {
+        return RAWRTC_CODE_MESSAGE_TOO_LONG;
+    }
 
-    // Set fields/reference
-    transport->state = RAWRTC_SCTP_TRANSPORT_STATE_NEW; // TODO: Raise state (delayed)?
-    transport->port = port;
-    transport->dtls_transport = mem_ref(dtls_transport);
-    transport->data_channel_handler = data_channel_handler;
-    transport->state_change_handler = state_change_handler;
-    transport->arg = arg;
-    list_init(&transport->buffered_messages_outgoing);
+    // Set PPID
+    if (is_binary) {
+        ppid = RAWRTC_SCTP_TRANSPORT_PPID_BINARY;
+    } else {
+        ppid = RAWRTC_SCTP_TRANSPORT_PPID_UTF16;
+    }
 
-    // Allocate channel array
-    error = data_channels_alloc(&transport->channels, n_channels, 0);
+    // Set send info
+    error = set_send_info(&spa, channel, context, ppid);
     if (error) {
-        goto out;
+        return error;
     }
-    transport->n_channels = n_channels;
-    transport->current_channel_sid = 0;
 
-    // Create packet tracer
-    // TODO: Debug mode only, filename set by debug options
-    transport->trace_handle = NULL
-#ifdef SCTP_DEBUG
-    {
-        char trace_handle_id[8];
-        char* trace_handle_name;
+    // Clear buffered amount low flag
+    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW;
 
-        // Create trace handle ID
-        rand_str(trace_handle_id, sizeof(trace_handle_id));
-        error = rawrtc_sdprintf(&trace_handle_name, "trace-sctp-%s.hex", trace_handle_id);
-        if (error) {
-            DEBUG_WARNING("Could create trace file name, reason: %s\n", rawrtc_code_to_str(error));
-        } else {
-            // Open trace file
-            transport->trace_handle = fopen(trace_handle_name, "w");
-            mem_deref(trace_handle_name);
-            if (!transport->trace_handle) {
-                DEBUG_WARNING("Could not open trace file, reason: %m\n", errno);
-            } else {
-                DEBUG_INFO("Using trace handle id: %s\n", trace_handle_id);
-            }
+    // Send directly (if connected, not corked, no outstanding messages and the stream exists)
+    if (can_send_directly(transport) && have_outbound_stream(transport, context)) {
+        DEBUG_PRINTF("Message queue is empty, sending %zu segments directly\n", n_segments);
+        error = sctp_transport_sendv(
+                transport, segments, n_segments, &spa, sizeof(spa), SCTP_SENDV_SPA, 0, &written);
+        update_outbound_state(context, error, written);
+        context->usrsctp_buffered_amount += written;
+        switch (error) {
+            case RAWRTC_CODE_SUCCESS:
+                goto out;
+            case RAWRTC_CODE_TRY_AGAIN_LATER:
+                DEBUG_PRINTF("Need to buffer message and wait for a write request\n");
+                break;
+            default:
+                goto out;
         }
     }
-#endif
 
-    // Create SCTP socket
-    DEBUG_PRINTF("Creating SCTP socket\n");
-    transport->socket = usrsctp_socket(
-            AF_CONN, SOCK_STREAM, IPPROTO_SCTP, NULL, NULL, 0, NULL);
-    if (!transport->socket) {
-        DEBUG_WARNING("Could not create socket, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
+    // Copy remaining data
+    // Note: In case parts of the message have been written, the remaining part will continue
+    //       the message as the EOR flag has not been set, yet.
+    error = segments_to_buffer(&buffer, segments, n_segments, length, written);
+    if (error) {
         goto out;
     }
 
-    // Register instance
-    usrsctp_register_address(transport);
-
-    // Make socket non-blocking
-    if (usrsctp_set_non_blocking(transport->socket, 1)) {
-        DEBUG_WARNING("Could not set to non-blocking, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
+    // Buffer message
+    error = transport_buffer(transport, context, buffer, &spa, SCTP_SENDV_SPA, 0, written > 0);
+    if (error) {
         goto out;
     }
 
-    // Set event callback
-    if (usrsctp_set_upcall(transport->socket, upcall_handler_helper, transport)) {
-        DEBUG_WARNING("Could not set event callback (upcall), reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
+out:
+    // Un-reference
+    rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), buffer);
+
+    if (error) {
+        DEBUG_WARNING("Unable to send message, reason: %s\n", rawrtc_code_to_str(error));
+    } else {
+        // Wait for a buffered amount low event (if above threshold)
+        update_buffered_amount_high(transport, channel);
     }
+    return error;
+}
 
-    // Determine chunk size
-    if (rawrtc_global.usrsctp_initialized == 1) {
-        socklen_t option_size = sizeof(int); // PD point is int according to spec
-        if (usrsctp_getsockopt(
-                transport->socket, IPPROTO_SCTP, SCTP_PARTIAL_DELIVERY_POINT,
-                &option_value, &option_size)) {
-            DEBUG_WARNING("Could not retrieve partial delivery point, reason: %m\n", errno);
-            error = rawrtc_error_to_code(errno);
-            goto out;
-        }
+/*
+ * Get the amount of buffered outgoing bytes of the data channel
+ * (transport handler).
+ */
+static enum rawrtc_code channel_get_buffered_amount_handler(
+        uint64_t* const amountp, // de-referenced
+        struct rawrtc_data_channel* const channel
+) {
+    struct rawrtc_sctp_data_channel_context* context;
 
-        // Check value
-        if (option_size != sizeof(int) || option_value < 1) {
-            DEBUG_WARNING("Invalid partial delivery point value: %d\n", option_value);
-            error = RAWRTC_CODE_INITIALISE_FAIL;
-            goto out;
-        }
+    // Check arguments
+    if (!amountp || !channel) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-        // Store value
-        rawrtc_global.usrsctp_chunk_size = (size_t) option_value;
-        DEBUG_PRINTF("Chunk size: %zu\n", rawrtc_global.usrsctp_chunk_size);
+    // Get context
+    context = channel->transport_arg;
+    if (!context) {
+        return RAWRTC_CODE_INVALID_STATE;
     }
 
-    // Enable the Stream Reconfiguration extension
-    av.assoc_id = SCTP_ALL_ASSOC;
-    av.assoc_value = SCTP_ENABLE_RESET_STREAM_REQ | SCTP_ENABLE_CHANGE_ASSOC_REQ;
-    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_ENABLE_STREAM_RESET,
-                           &av, sizeof(struct sctp_assoc_value))) {
-        DEBUG_WARNING("Could not enable stream reconfiguration extension, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
+    // Set amount & done
+    *amountp = get_channel_buffered_amount(
+            context, get_send_buffer_usage(channel->transport->transport));
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the SCTP data transport instance.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_data_transport(
+        struct rawrtc_data_transport** const transportp, // de-referenced
+        struct rawrtc_sctp_transport* const sctp_transport // referenced
+) {
+    enum rawrtc_code error;
+    struct rawrtc_data_transport* transport;
+
+    // Check arguments
+    if (!sctp_transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // TODO: Set MTU (1200|1280 (IPv4|IPv6) - UDP - DTLS (cipher suite dependent) - SCTP (12)
-    // https://github.com/ortclib/ortclib-cpp/blob/master/ortc/cpp/ortc_SCTPTransport.cpp#L2143
+    // Check SCTP transport state
+    if (sctp_transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        return RAWRTC_CODE_INVALID_STATE;
+    }
 
-    // We want info
-    option_value = 1;
-    if (usrsctp_setsockopt(
-            transport->socket, IPPROTO_SCTP, SCTP_RECVRCVINFO,
-            &option_value, sizeof(option_value))) {
-        DEBUG_WARNING("Could not set info option, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
+    // Create data transport
+    error = rawrtc_data_transport_create(
+            &transport, RAWRTC_DATA_TRANSPORT_TYPE_SCTP, sctp_transport,
+            channel_create_handler, channel_close_handler, channel_send_handler,
+            channel_sendv_handler, channel_get_buffered_amount_handler);
+    if (error) {
+        return error;
     }
 
-    // TODO: Enable interleaving messages for different streams (outgoing)
-    // https://tools.ietf.org/html/draft-ietf-tsvwg-sctp-ndata-08#section-4.3.1
+    // Set pointer & done
+    *transportp = transport;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-    // Discard pending packets when closing
-    // (so we don't get a callback when the transport is already free'd)
-    // TODO: Find a way to use graceful shutdown instead, otherwise the other peer would raise an
-    // error indication (https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.2)
-    linger_option.l_onoff = 1;
-    linger_option.l_linger = 0;
-    if (usrsctp_setsockopt(transport->socket, SOL_SOCKET, SO_LINGER,
-                           &linger_option, sizeof(linger_option))) {
-        DEBUG_WARNING("Could not set linger options, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
+/*
+ * Start the SCTP transport.
+ */
+enum rawrtc_code rawrtc_sctp_transport_start(
+        struct rawrtc_sctp_transport* const transport,
+        struct rawrtc_sctp_capabilities const * const remote_capabilities, // copied
+        uint16_t remote_port // zeroable
+) {
+    struct sockaddr_conn peer = {0};
+    enum rawrtc_code error = RAWRTC_CODE_SUCCESS;
+
+    // Check arguments
+    if (!transport || !remote_capabilities) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Set no delay option (disable nagle)
-    option_value = 1;
-    if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_NODELAY,
-                           &option_value, sizeof(option_value))) {
-        DEBUG_WARNING("Could not set no-delay, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
+    // Check state
+    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_NEW) {
+        return RAWRTC_CODE_INVALID_STATE;
     }
 
-    // Set explicit EOR
-    option_value = 1;
-    if (usrsctp_setsockopt(
-            transport->socket, IPPROTO_SCTP, SCTP_EXPLICIT_EOR,
-            &option_value, sizeof(option_value))) {
-        DEBUG_WARNING("Could not enable explicit EOR, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
+    // Set default port (if 0)
+    if (remote_port == 0) {
+        remote_port = transport->port;
     }
 
-    // Subscribe to SCTP event notifications
-    sctp_event.se_assoc_id = SCTP_ALL_ASSOC;
-    sctp_event.se_on = 1;
-    for (i = 0; i < sctp_events_length; ++i) {
-        sctp_event.se_type = sctp_events[i];
-        if (usrsctp_setsockopt(transport->socket, IPPROTO_SCTP, SCTP_EVENT,
-                               &sctp_event, sizeof(sctp_event))) {
-            DEBUG_WARNING("Could not subscribe to event notification, reason: %m", errno);
-            error = rawrtc_error_to_code(errno);
-            goto out;
-        }
+    // Store maximum message size
+    transport->remote_maximum_message_size = remote_capabilities->max_message_size;
+
+    // Update amount of streams (data channels may have been created in the meantime)
+    error = set_init_streams(transport);
+    if (error) {
+        goto out;
     }
 
-    // Bind local address
+    // Set remote address
     peer.sconn_family = AF_CONN;
     // TODO: Check for existance of sconn_len
     //sconn.sconn_len = sizeof(peer);
-    peer.sconn_port = htons(transport->port);
+    peer.sconn_port = htons(remote_port);
     peer.sconn_addr = transport;
-    if (usrsctp_bind(transport->socket, (struct sockaddr*) &peer, sizeof(peer))) {
-        DEBUG_WARNING("Could not bind local address, reason: %m\n", errno);
+
+    // Connect
+    DEBUG_PRINTF("Connecting to peer\n");
+    if (usrsctp_connect(transport->socket, (struct sockaddr*) &peer, sizeof(peer)) &&
+            errno != EINPROGRESS) {
+        DEBUG_WARNING("Could not connect, reason: %m\n", errno);
         error = rawrtc_error_to_code(errno);
         goto out;
     }
 
-    // Attach to ICE transport
-    DEBUG_PRINTF("Attaching as data transport\n");
-    error = rawrtc_dtls_transport_set_data_transport(
-            transport->dtls_transport, dtls_receive_handler, transport);
-    if (error) {
-        goto out;
-    }
+    // Note: Path MTU discovery is done by the DTLS transport which updates the path MTU of the
+    //       association via `dtls_path_mtu_handler`.
+    // see https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-5
+
+    // Transition to connecting state
+    set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CONNECTING);
 
 out:
     if (error) {
-        mem_deref(transport);
-    } else {
-        // Set pointer
-        *transportp = transport;
+        set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CLOSED);
     }
     return error;
 }
 
-/*
- * Destructor for an existing data channel context.
- */
-static void channel_context_destroy(
-        void* arg
-) {
-    struct rawrtc_sctp_data_channel_context* const context = arg;
-
-    // Un-reference
-    mem_deref(context->buffer_inbound);
-}
 
 /*
- * Allocate data channel context.
+ * Stop and close the SCTP transport.
  */
-static enum rawrtc_code channel_context_create(
-        struct rawrtc_sctp_data_channel_context** const contextp, // de-referenced, not checked
-        uint16_t const sid,
-        bool const can_send_unordered
+enum rawrtc_code rawrtc_sctp_transport_stop(
+        struct rawrtc_sctp_transport* const transport
 ) {
-    // Allocate context
-    struct rawrtc_sctp_data_channel_context* const context =
-            mem_zalloc(sizeof(*context), channel_context_destroy);
-    if (!context) {
-        return RAWRTC_CODE_NO_MEMORY;
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Set fields
-    context->sid = sid;
-    if (can_send_unordered) {
-        context->flags |= RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED;
+    // Check state
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        return RAWRTC_CODE_SUCCESS;
     }
 
-    // Set pointer & done
-    *contextp = context;
+    // Update state
+    set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CLOSED);
     return RAWRTC_CODE_SUCCESS;
+
+    // TODO: Anything missing?
 }
 
 /*
- * Check if a data channel is registered on the transport.
+ * Destructor for an existing outgoing message context.
  */
-static bool channel_registered(
-        struct rawrtc_sctp_transport* const transport, // not checked
-        struct rawrtc_data_channel* const channel // not checked
+static void message_send_context_destroy(
+        void* arg
 ) {
-    // Get context
-    struct rawrtc_sctp_data_channel_context* const context = channel->transport_arg;
+    struct send_context* const context = arg;
 
-    // Check status
-    if (transport->channels[context->sid] != channel) {
-        DEBUG_WARNING("Invalid channel instance in slot. Please report this.\n");
-        return false;
-    } else {
-        return true;
+    // Update buffered amount of the channel (if any)
+    if (context->channel_context) {
+        context->channel_context->buffered_amount -= context->size;
     }
+
+    // Un-reference
+    mem_deref(context->channel_context);
 }
 
 /*
- * Register data channel on transport.
+ * Create outgoing message context for buffering SCTP messages.
+ * The size will be added to the channel's buffered amount until the
+ * context is being destroyed.
  */
-static void channel_register(
-        struct rawrtc_sctp_transport* const transport, // not checked
-        struct rawrtc_data_channel* const channel, // referenced, not checked
-        struct rawrtc_sctp_data_channel_context* const context, // referenced, not checked
-        bool const raise_event
+enum rawrtc_code message_send_context_create(
+        struct send_context** const contextp, // de-referenced, not checked
+        struct rawrtc_sctp_data_channel_context* const channel_context, // nullable, referenced
+        size_t const size,
+        void* const info, // not checked
+        unsigned int const info_type,
+        int const flags
 ) {
-    // Update channel with referenced context
-    channel->transport_arg = mem_ref(context);
-    transport->channels[context->sid] = mem_ref(channel);
+    enum rawrtc_code error;
+    struct send_context* context;
 
-    // Raise data channel event?
-    if (raise_event) {
-        // Call data channel handler (if any)
-        rawrtc_data_channel_call_channel_handler(
-                channel, transport->data_channel_handler, transport->arg);
+    // Allocate context
+    context = mem_zalloc(sizeof(*context), message_send_context_destroy);
+    if (!context) {
+        return RAWRTC_CODE_NO_MEMORY;
     }
 
-    // Update data channel state
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
-        rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_OPEN);
+    // Set context fields
+    context->info_type = info_type;
+    context->flags = flags;
+
+    // Update buffered amount of the channel (if any)
+    if (channel_context) {
+        context->channel_context = mem_ref(channel_context);
+        context->size = size;
+        channel_context->buffered_amount += size;
     }
-}
 
-/*
- * Create a negotiated SCTP data channel.
- */
-static enum rawrtc_code channel_create_negotiated(
-        struct rawrtc_sctp_data_channel_context** const contextp, // de-referenced, not checked
-        struct rawrtc_sctp_transport* const transport, // not checked
-        struct rawrtc_data_channel_parameters const * const parameters // read-only
-) {
-    // Check SID (> max, >= n_channels, or channel already occupied)
-    if (parameters->id > RAWRTC_SCTP_TRANSPORT_SID_MAX ||
-        parameters->id >= transport->n_channels ||
-        transport->channels[parameters->id]) {
-        return RAWRTC_CODE_INVALID_ARGUMENT;
+    // Copy info data (if any)
+    if (info_type != SCTP_SENDV_NOINFO && info) {
+        // Copy info data according to type
+        // Note: info_size will be ignored for buffered messages
+        switch (info_type) {
+            case SCTP_SENDV_SNDINFO:
+                memcpy(&context->info.sndinfo, info, sizeof(context->info.sndinfo));
+                break;
+            case SCTP_SENDV_SPA:
+                memcpy(&context->info.spa, info, sizeof(context->info.spa));
+                break;
+            default:
+                error = RAWRTC_CODE_INVALID_STATE;
+                goto out;
+        }
     }
 
-    // Allocate context to be used as an argument for the data channel handlers
-    // TODO: Is it okay to already allow sending unordered messages here? Assuming: Yes.
-    return channel_context_create(contextp, parameters->id, true);
+    // Done
+    error = RAWRTC_CODE_SUCCESS;
+
+out:
+    if (error) {
+        mem_deref(context);
+    } else {
+        // Set pointer
+        *contextp = context;
+    }
+
+    return error;
 }
 
 /*
- * Create an SCTP data channel that needs negotiation.
+ * Send data (non-deferred) via the SCTP transport.
+ * `*writtenp` will be set to the amount of bytes that have been handed
+ * out to usrsctp, even in case an error is being returned.
+ * The EOR flag will only be set on the last chunk in case `eor` is
+ * `true` and the EOR flag has been set in the send info.
  */
-static enum rawrtc_code channel_create_inband(
-        struct rawrtc_sctp_data_channel_context** const contextp, // de-referenced, not checked
+static enum rawrtc_code sctp_transport_send_data(
         struct rawrtc_sctp_transport* const transport, // not checked
-        struct rawrtc_data_channel_parameters const * const parameters // read-only
+        uint8_t* const data, // not checked
+        size_t const size,
+        void* const info, // not checked
+        socklen_t const info_size,
+        unsigned int const info_type,
+        int const flags,
+        bool const eor,
+        size_t* const writtenp // de-referenced, not checked
 ) {
+    struct sctp_sndinfo* send_info;
+    bool eor_original;
+    bool eor_set;
+    size_t offset = 0;
+    size_t length;
+    ssize_t written;
     enum rawrtc_code error;
-    uint_fast16_t i;
-    struct rawrtc_sctp_data_channel_context* context;
-    struct mbuf* buffer;
 
-    // Check DTLS state
-    // Note: We need to have an open DTLS connection to determine whether we use odd or even
-    // SIDs.
-    // TODO: Can we fix this somehow to make it possible to create data channels earlier?
-    if (transport->dtls_transport->state != RAWRTC_DTLS_TRANSPORT_STATE_CONNECTED) {
+    // Check state
+    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
         return RAWRTC_CODE_INVALID_STATE;
     }
 
-    // Use odd or even SIDs
-    switch (transport->dtls_transport->role) {
-        case RAWRTC_DTLS_ROLE_CLIENT:
-            i = 0;
+    // Get reference to send flags
+    switch (info_type) {
+        case SCTP_SENDV_SNDINFO:
+            send_info = (struct sctp_sndinfo* const) info;
             break;
-        case RAWRTC_DTLS_ROLE_SERVER:
-            i = 1;
+        case SCTP_SENDV_SPA:
+            send_info = &((struct sctp_sendv_spa* const) info)->sendv_sndinfo;
             break;
         default:
             return RAWRTC_CODE_INVALID_STATE;
     }
 
-    // Find free SID
-    context = NULL;
-    for (; i < transport->n_channels; i += 2) {
-        if (!transport->channels[i]) {
-            // Allocate context to be used as an argument for the data channel handlers
-            error = channel_context_create(&context, (uint16_t) i, false);
-            if (error) {
-                return error;
-            }
-            break;
-        }
-    }
-    if (!context) {
-        return RAWRTC_CODE_INSUFFICIENT_SPACE;
-    }
+    // EOR set?
+    eor_original = send_info->snd_flags & SCTP_EOR ? true : false;
+    eor_set = eor && eor_original;
 
-    // Create open message
-    buffer = NULL;
-    error = data_channel_open_message_create(&buffer, parameters);
-    if (error) {
-        goto out;
-    }
+    // Send until all data has been sent
+    do {
+        size_t const left = size - offset;
 
-    // Send message
-    DEBUG_PRINTF("Sending data channel open message for channel with SID %"PRIu16"\n",
-                 context->sid);
-    error = send_message(transport, NULL, context, buffer, RAWRTC_SCTP_TRANSPORT_PPID_DCEP);
-    if (error) {
-        goto out;
-    }
+        // Carefully chunk the buffer
+        if (left > rawrtc_global.usrsctp_chunk_size) {
+            length = rawrtc_global.usrsctp_chunk_size;
 
-out:
-    // Un-reference
-    mem_deref(buffer);
+            // Unset EOR flag
+            send_info->snd_flags &= ~SCTP_EOR;
+        } else {
+            length = left;
 
-    if (error) {
-        mem_deref(context);
-    } else {
-        // Set pointer
-        *contextp = context;
-    }
-    return error;
-}
+            // Set or unset EOR flag
+            if (eor_set) {
+                send_info->snd_flags |= SCTP_EOR;
+            } else {
+                send_info->snd_flags &= ~SCTP_EOR;
+            }
+        }
 
-/*
- * Create the SCTP data channel.
- */
-static enum rawrtc_code channel_create_handler(
-        struct rawrtc_data_transport* const transport,
-        struct rawrtc_data_channel* const channel, // referenced
-        struct rawrtc_data_channel_parameters const * const parameters // read-only
-) {
-    struct rawrtc_sctp_transport* sctp_transport;
-    enum rawrtc_code error;
-    struct rawrtc_sctp_data_channel_context* context;
+        // Send
+        DEBUG_PRINTF("Try sending %zu/%zu bytes\n", length, left);
+        written = usrsctp_sendv(
+                transport->socket, data + offset, length, NULL, 0,
+                info, info_size, info_type, flags);
+#ifdef SCTP_DEBUG
+        DEBUG_PRINTF("usrsctp_sendv(socket=%p, buffer=%p, length=%zu/%zu, info={sid: %"PRIu16", "
+                     "ppid: %"PRIu32", eor: %s (was %s}) -> %zd (errno: %m)\n",
+                     transport->socket, data + offset, length, left, send_info->snd_sid,
+                     ntohl(send_info->snd_ppid),
+                     send_info->snd_flags & SCTP_EOR ? "true" : "false",
+                     eor_set ? "true" : "false",
+                     written, errno);
+#endif
+        if (written < 0) {
+            error = rawrtc_error_to_code(errno);
+            goto out;
+        }
 
-    // Check arguments
-    if (!transport || !channel || !parameters) {
-        return RAWRTC_CODE_INVALID_ARGUMENT;
-    }
+        // Update offset
+        offset += (size_t) written;
 
-    // TODO: Check if closed?
+        // If not all bytes have been written, this obviously means that usrsctp's buffer is full
+        // and we need to try again later.
+        // Note: usrsctp has not seen the EOR flag in this case, so the remaining bytes will
+        //       continue the message once resumed from the offset.
+        if ((size_t) written < length) {
+            error = RAWRTC_CODE_TRY_AGAIN_LATER;
+            goto out;
+        }
+    } while (offset < size);
 
-    // Get SCTP transport
-    sctp_transport = transport->transport;
+    // Done
+    error = RAWRTC_CODE_SUCCESS;
 
-    // Create negotiated or in-band data channel
-    if (parameters->negotiated) {
-        error = channel_create_negotiated(&context, sctp_transport, parameters);
+out:
+    // Restore EOR flag
+    if (eor_original) {
+        send_info->snd_flags |= SCTP_EOR;
     } else {
-        error = channel_create_inband(&context, sctp_transport, parameters);
+        send_info->snd_flags &= ~SCTP_EOR;
     }
-    if (error) {
-        return error;
-    }
-
-    // Register data channel
-    channel_register(sctp_transport, channel, context, false);
 
-    // Un-reference & done
-    mem_deref(context);
-    return RAWRTC_CODE_SUCCESS;
+    // Set written bytes
+    *writtenp = offset;
+    return error;
 }
 
 /*
- * Close the data channel (transport handler).
+ * Send a message (non-deferred) via the SCTP transport.
  */
-static enum rawrtc_code channel_close_handler(
-        struct rawrtc_data_channel* const channel
+enum rawrtc_code sctp_transport_send(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct mbuf* const buffer, // not checked
+        void* const info, // not checked
+        socklen_t const info_size,
+        unsigned int const info_type,
+        int const flags
 ) {
-    struct rawrtc_sctp_transport* transport;
-    struct rawrtc_sctp_data_channel_context* context;
+    size_t written;
+    enum rawrtc_code error;
 
-    // Check arguments
-    if (!channel) {
-        return RAWRTC_CODE_INVALID_ARGUMENT;
-    }
+    // Send
+    error = sctp_transport_send_data(
+            transport, mbuf_buf(buffer), mbuf_get_left(buffer), info, info_size, info_type, flags,
+            true, &written);
 
-    // TODO: Check if closed?
+    // Update buffer position
+    mbuf_advance(buffer, written);
+    return error;
+}
 
-    // Get SCTP transport & context
-    transport = channel->transport->transport;
-    context = channel->transport_arg;
+/*
+ * Send a message consisting of multiple segments (non-deferred) via
+ * the SCTP transport. The segments will be passed to usrsctp one by one
+ * without merging them.
+ * `*writtenp` will be set to the amount of bytes that have been handed
+ * out to usrsctp, even in case an error is being returned.
+ */
+static enum rawrtc_code sctp_transport_sendv(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct iovec const * const segments, // not checked
+        size_t const n_segments,
+        void* const info, // not checked
+        socklen_t const info_size,
+        unsigned int const info_type,
+        int const flags,
+        size_t* const writtenp // de-referenced, not checked
+) {
+    size_t last = 0;
+    size_t i;
+    size_t written;
+    enum rawrtc_code error = RAWRTC_CODE_SUCCESS;
 
-    // Un-reference channel and clear pointer (if channel was registered before)
-    // Note: The context will be NULL if the channel was not registered before
-    if (context) {
-        DEBUG_PRINTF("Closing channel with SID %"PRIu16"\n", context->sid);
+    // Find last non-empty segment (EOR will be set on it)
+    for (i = 0; i < n_segments; ++i) {
+        if (segments[i].iov_len > 0) {
+            last = i;
+        }
+    }
 
-        // Sanity check
-        if (!channel_registered(transport, channel)) {
-            return RAWRTC_CODE_SCTP_TRANSPORT_ERROR;
+    // Send each non-empty segment
+    *writtenp = 0;
+    for (i = 0; i <= last && i < n_segments; ++i) {
+        if (segments[i].iov_len == 0) {
+            continue;
         }
 
-        // Reset outgoing streams
-        // Important: This function will change the state of the channel to CLOSED
-        //            and remove the channel from the transport on error.
-        if (!reset_outgoing_stream(transport, channel)) {
-            rawrtc_data_channel_set_state(channel, RAWRTC_DATA_CHANNEL_STATE_CLOSING);
+        // Send segment
+        error = sctp_transport_send_data(
+                transport, segments[i].iov_base, segments[i].iov_len, info, info_size, info_type,
+                flags, i == last, &written);
+        *writtenp += written;
+        if (error) {
+            break;
         }
     }
 
     // Done
-    return RAWRTC_CODE_SUCCESS;
+    return error;
 }
 
 /*
- * Send data via the data channel (transport handler).
+ * Send a message via the SCTP transport or buffer it.
+ * Buffered messages of a channel will be accounted for in its buffered
+ * amount.
  */
-static enum rawrtc_code channel_send_handler(
-        struct rawrtc_data_channel* const channel,
-        struct mbuf* buffer, // nullable (if size 0), referenced
-        bool const is_binary
+static enum rawrtc_code transport_send(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_sctp_data_channel_context* const channel_context, // nullable
+        struct mbuf* const buffer, // not checked
+        void* const info,
+        socklen_t const info_size,
+        unsigned int const info_type,
+        int const flags
 ) {
-    struct rawrtc_sctp_transport* transport;
-    size_t length;
-    uint_fast32_t ppid;
-    struct mbuf* empty = NULL;
     enum rawrtc_code error;
+    bool in_flight = false;
 
-    // Check arguments
-    if (!channel) {
-        return RAWRTC_CODE_INVALID_ARGUMENT;
-    }
-
-    // TODO: Check if closed?
-
-    // Get SCTP transport
-    transport = channel->transport->transport;
-
-    // We accept both a NULL buffer and a buffer of length 0
-    if (!buffer) {
-        length = 0;
-    } else {
-        length = mbuf_get_left(buffer);
-    }
-
-    // Empty message?
-    if (length == 0) {
-        // Set PPID
-        if (is_binary) {
-            ppid = RAWRTC_SCTP_TRANSPORT_PPID_BINARY_EMPTY;
-        } else {
-            ppid = RAWRTC_SCTP_TRANSPORT_PPID_UTF16_EMPTY;
-        }
+    // Clear buffered amount low flag
+    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW;
 
-        // Create helper message as SCTP is unable to send messages of size 0
-        empty = mbuf_alloc(RAWRTC_SCTP_TRANSPORT_EMPTY_MESSAGE_SIZE);
-        if (!empty) {
-            return RAWRTC_CODE_NO_MEMORY;
-        }
+    // Send directly (if connected, not corked, no outstanding messages and the stream exists)
+    if (can_send_directly(transport) && have_outbound_stream(transport, channel_context)) {
+        size_t const left = mbuf_get_left(buffer);
 
-        // Note: The content is being ignored
-        error = rawrtc_error_to_code(mbuf_write_u8(empty, 0));
-        if (error) {
-            goto out;
-        }
+        // Try sending
+        DEBUG_PRINTF("Message queue is empty, sending directly\n");
+        error = sctp_transport_send(
+                transport, buffer, info, info_size, info_type, flags);
 
-        // Set position & pointer
-        mbuf_set_pos(empty, 0);
-        buffer = empty;
-    } else {
-        // Check size
-        if (transport->remote_maximum_message_size != 0 &&
-            length > transport->remote_maximum_message_size) {
-            return RAWRTC_CODE_MESSAGE_TOO_LONG;
+        // Update resumable send state & amount of bytes handed out to usrsctp (if channel)
+        update_outbound_state(channel_context, error, left - mbuf_get_left(buffer));
+        if (channel_context) {
+            channel_context->usrsctp_buffered_amount += left - mbuf_get_left(buffer);
         }
+        in_flight = left > mbuf_get_left(buffer);
 
-        // Set PPID
-        // Note: We will not use the deprecated fragmentation & reassembly
-        if (is_binary) {
-            ppid = RAWRTC_SCTP_TRANSPORT_PPID_BINARY;
-        } else {
-            ppid = RAWRTC_SCTP_TRANSPORT_PPID_UTF16;
+        switch (error) {
+            case RAWRTC_CODE_SUCCESS:
+                // Done
+                return RAWRTC_CODE_SUCCESS;
+            case RAWRTC_CODE_TRY_AGAIN_LATER:
+                DEBUG_PRINTF("Need to buffer message and wait for a write request\n");
+                break;
+            case RAWRTC_CODE_MESSAGE_TOO_LONG:
+                DEBUG_WARNING("Incorrect message size guess, report this!\n");
+                return error;
+            default:
+                return error;
         }
     }
 
-    // Send
-    error = send_message(transport, channel, channel->transport_arg, buffer, ppid);
-    if (error) {
-        goto out;
-    }
-
-out:
-    // Un-reference
-    mem_deref(empty);
-
-    // Done
-    return error;
+    // Buffer message
+    return transport_buffer(transport, channel_context, buffer, info, info_type, flags, in_flight);
 }
 
 /*
- * Get the SCTP data transport instance.
+ * Buffer a message to be sent once the SCTP transport is writable.
+ * Buffered messages of a channel will be accounted for in its buffered
+ * amount.
+ *
+ * The remainder of a message that has already been partially handed
+ * to usrsctp (`in_flight`) is always accepted regardless of the buffer
+ * limits as dropping it would leave a truncated message on the wire.
  */
-enum rawrtc_code rawrtc_sctp_transport_get_data_transport(
-        struct rawrtc_data_transport** const transportp, // de-referenced
-        struct rawrtc_sctp_transport* const sctp_transport // referenced
+static enum rawrtc_code transport_buffer(
+        struct rawrtc_sctp_transport* const transport, // not checked
+        struct rawrtc_sctp_data_channel_context* const channel_context, // nullable
+        struct mbuf* const buffer, // not checked
+        void* const info,
+        unsigned int const info_type,
+        int const flags,
+        bool const in_flight
 ) {
+    struct send_context* context = NULL;
     enum rawrtc_code error;
-    struct rawrtc_data_transport* transport;
 
-    // Check arguments
-    if (!sctp_transport) {
-        return RAWRTC_CODE_INVALID_ARGUMENT;
+    // Create message context (for buffering)
+    error = message_send_context_create(
+            &context, channel_context, mbuf_get_left(buffer), info, info_type, flags);
+    if (error) {
+        goto out;
     }
 
-    // Check SCTP transport state
-    if (sctp_transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        return RAWRTC_CODE_INVALID_STATE;
+    // Buffer message (or hold it back until its outgoing stream has been added)
+    if (in_flight) {
+        error = rawrtc_message_buffer_append_unlimited(
+                &transport->buffered_messages_outgoing, buffer, context);
+    } else if (!have_outbound_stream(transport, channel_context)) {
+        error = rawrtc_message_buffer_append(
+                &transport->buffered_messages_pending_streams, buffer, context);
+    } else {
+        error = rawrtc_message_buffer_append(
+                &transport->buffered_messages_outgoing, buffer, context);
     }
-
-    // Create data transport
-    error = rawrtc_data_transport_create(
-            &transport, RAWRTC_DATA_TRANSPORT_TYPE_SCTP, sctp_transport,
-            channel_create_handler, channel_close_handler, channel_send_handler);
     if (error) {
-        return error;
+        goto out;
     }
+    DEBUG_PRINTF("Buffered outgoing message of size %zu\n", mbuf_get_left(buffer));
 
-    // Set pointer & done
-    *transportp = transport;
-    return RAWRTC_CODE_SUCCESS;
+out:
+    // Un-reference
+    mem_deref(context);
+
+    return error;
 }
 
 /*
- * Start the SCTP transport.
+ * Send a message via the SCTP transport.
  */
-enum rawrtc_code rawrtc_sctp_transport_start(
+enum rawrtc_code rawrtc_sctp_transport_send(
         struct rawrtc_sctp_transport* const transport,
-        struct rawrtc_sctp_capabilities const * const remote_capabilities, // copied
-        uint16_t remote_port // zeroable
+        struct mbuf* const buffer,
+        void* const info,
+        socklen_t const info_size,
+        unsigned int const info_type,
+        int const flags
 ) {
-    struct sockaddr_conn peer = {0};
-    enum rawrtc_code error = RAWRTC_CODE_SUCCESS;
-
     // Check arguments
-    if (!transport || !remote_capabilities) {
+    if (!transport || !buffer) {
         return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Check state
-    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_NEW) {
-        return RAWRTC_CODE_INVALID_STATE;
-    }
-
-    // Set default port (if 0)
-    if (remote_port == 0) {
-        remote_port = transport->port;
-    }
-
-    // Store maximum message size
-    transport->remote_maximum_message_size = remote_capabilities->max_message_size;
-
-    // Set remote address
-    peer.sconn_family = AF_CONN;
-    // TODO: Check for existance of sconn_len
-    //sconn.sconn_len = sizeof(peer);
-    peer.sconn_port = htons(remote_port);
-    peer.sconn_addr = transport;
-
-    // Connect
-    DEBUG_PRINTF("Connecting to peer\n");
-    if (usrsctp_connect(transport->socket, (struct sockaddr*) &peer, sizeof(peer)) &&
-            errno != EINPROGRESS) {
-        DEBUG_WARNING("Could not connect, reason: %m\n", errno);
-        error = rawrtc_error_to_code(errno);
-        goto out;
-    }
-
-    // TODO: Initiate Path MTU discovery (https://tools.ietf.org/html/rfc4821)
-    // by using probing messages (https://tools.ietf.org/html/rfc4820)
-    // see https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-5
-
-    // Transition to connecting state
-    set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CONNECTING);
-
-out:
-    if (error) {
-        set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CLOSED);
-    }
-    return error;
+    // Send or buffer
+    return transport_send(transport, NULL, buffer, info, info_size, info_type, flags);
 }
 
-
 /*
- * Stop and close the SCTP transport.
+ * Cork the SCTP transport.
  */
-enum rawrtc_code rawrtc_sctp_transport_stop(
+enum rawrtc_code rawrtc_sctp_transport_cork(
         struct rawrtc_sctp_transport* const transport
 ) {
     // Check arguments
@@ -2699,237 +4747,280 @@ enum rawrtc_code rawrtc_sctp_transport_stop(
 
     // Check state
     if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
-        return RAWRTC_CODE_SUCCESS;
+        return RAWRTC_CODE_INVALID_STATE;
     }
 
-    // Update state
-    set_state(transport, RAWRTC_SCTP_TRANSPORT_STATE_CLOSED);
+    // Set flag & done
+    transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_CORKED;
     return RAWRTC_CODE_SUCCESS;
-
-    // TODO: Anything missing?
 }
 
 /*
- * Create outgoing message context for buffering SCTP messages.
+ * Uncork the SCTP transport and send all queued messages.
  */
-enum rawrtc_code message_send_context_create(
-        struct send_context** const contextp, // de-referenced, not checked
-        void* const info, // not checked
-        unsigned int const info_type,
-        int const flags
+enum rawrtc_code rawrtc_sctp_transport_uncork(
+        struct rawrtc_sctp_transport* const transport
 ) {
     enum rawrtc_code error;
-    struct send_context* context;
 
-    // Allocate context
-    context = mem_zalloc(sizeof(*context), NULL);
-    if (!context) {
-        return RAWRTC_CODE_NO_MEMORY;
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Set context fields
-    context->info_type = info_type;
-    context->flags = flags;
-
-    // Copy info data (if any)
-    if (info_type != SCTP_SENDV_NOINFO && info) {
-        // Copy info data according to type
-        // Note: info_size will be ignored for buffered messages
-        switch (info_type) {
-            case SCTP_SENDV_SNDINFO:
-                memcpy(&context->info.sndinfo, info, sizeof(context->info.sndinfo));
-                break;
-            case SCTP_SENDV_SPA:
-                memcpy(&context->info.spa, info, sizeof(context->info.spa));
-                break;
-            default:
-                error = RAWRTC_CODE_INVALID_STATE;
-                goto out;
-        }
+    // Not corked?
+    if (!(transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_CORKED)) {
+        return RAWRTC_CODE_SUCCESS;
     }
 
-    // Done
-    error = RAWRTC_CODE_SUCCESS;
+    // Clear flag
+    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_CORKED;
 
-out:
-    if (error) {
-        mem_deref(context);
-    } else {
-        // Set pointer
-        *contextp = context;
+    // Not connected? Messages will be sent once connected.
+    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED ||
+            !can_send_deferred(transport)) {
+        return RAWRTC_CODE_SUCCESS;
+    }
+
+    // Send all queued messages (if not already sending)
+    if (transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS) {
+        return RAWRTC_CODE_SUCCESS;
     }
+    transport->flags |= RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
+    error = sctp_send_deferred_messages(transport);
+    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS;
+
+    // Raise buffered amount low events (if any)
+    raise_buffered_amount_low_events(transport);
 
+    // Remaining messages will be sent on the next write event
+    if (error == RAWRTC_CODE_STOP_ITERATION) {
+        error = RAWRTC_CODE_SUCCESS;
+    }
     return error;
 }
 
 /*
- * Send a message (non-deferred) via the SCTP transport.
+ * Set the event budget of the SCTP transport.
  */
-enum rawrtc_code sctp_transport_send(
-        struct rawrtc_sctp_transport* const transport, // not checked
-        struct mbuf* const buffer, // not checked
-        void* const info, // not checked
-        socklen_t const info_size,
-        unsigned int const info_type,
-        int const flags
+enum rawrtc_code rawrtc_sctp_transport_set_event_budget(
+        struct rawrtc_sctp_transport* const transport,
+        uint32_t const budget
 ) {
-    struct sctp_sndinfo* send_info;
-    bool eor_set;
-    size_t length;
-    ssize_t written;
-    enum rawrtc_code error;
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-    // Check state
-    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED) {
-        return RAWRTC_CODE_INVALID_STATE;
+    // Set budget & done
+    transport->event_budget = budget;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the amount of times the event budget of the SCTP transport has
+ * been exhausted.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_event_budget_exhausted(
+        uint64_t* const countp, // de-referenced
+        struct rawrtc_sctp_transport* const transport
+) {
+    // Check arguments
+    if (!countp || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Get reference to send flags
-    switch (info_type) {
-        case SCTP_SENDV_SNDINFO:
-            send_info = (struct sctp_sndinfo* const) info;
-            break;
-        case SCTP_SENDV_SPA:
-            send_info = &((struct sctp_sendv_spa* const) info)->sendv_sndinfo;
-            break;
-        default:
-            return RAWRTC_CODE_INVALID_STATE;
+    // Set count & done
+    *countp = transport->n_event_budget_exhausted;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Set the limits of the SCTP transport's outgoing message buffer.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_buffer_limits(
+        struct rawrtc_sctp_transport* const transport,
+        struct rawrtc_message_buffer_limits const* const limits // copied
+) {
+    // Check arguments
+    if (!transport || !limits) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // EOR set?
-    eor_set = send_info->snd_flags & SCTP_EOR ? true : false;
+    // Buffered messages may not be dropped or expired
+    // Note: The oldest message may have been sent partially and messages of reliable channels
+    //       must not be lost silently.
+    if (limits->policy != RAWRTC_MESSAGE_BUFFER_POLICY_DROP_NEWEST || limits->max_age != 0) {
+        return RAWRTC_CODE_NOT_IMPLEMENTED;
+    }
 
-    // Send until buffer is empty
-    do {
-        size_t const left = mbuf_get_left(buffer);
+    // Set limits & done
+    rawrtc_message_buffer_set_limits(&transport->buffered_messages_outgoing, limits);
+    rawrtc_message_buffer_set_limits(&transport->buffered_messages_pending_streams, limits);
+    return RAWRTC_CODE_SUCCESS;
+}
 
-        // Carefully chunk the buffer
-        if (left > rawrtc_global.usrsctp_chunk_size) {
-            length = rawrtc_global.usrsctp_chunk_size;
+/*
+ * Get the statistics of the SCTP transport's outgoing message buffer.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_buffer_stats(
+        struct rawrtc_message_buffer_stats* const statsp, // de-referenced
+        struct rawrtc_sctp_transport* const transport
+) {
+    struct rawrtc_message_buffer_stats pending;
 
-            // Unset EOR flag
-            send_info->snd_flags &= ~SCTP_EOR;
-        } else {
-            length = left;
+    // Check arguments
+    if (!statsp || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-            // Reset EOR flag
-            if (eor_set) {
-                send_info->snd_flags |= SCTP_EOR;
-            }
-        }
+    // Set statistics (including messages waiting for their outgoing stream) & done
+    rawrtc_message_buffer_get_stats(statsp, &transport->buffered_messages_outgoing);
+    rawrtc_message_buffer_get_stats(&pending, &transport->buffered_messages_pending_streams);
+    statsp->size += pending.size;
+    statsp->n_messages += pending.n_messages;
+    statsp->n_dropped += pending.n_dropped;
+    statsp->n_expired += pending.n_expired;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-        // Send
-        DEBUG_PRINTF("Try sending %zu/%zu bytes\n", length, left);
-        written = usrsctp_sendv(
-                transport->socket, mbuf_buf(buffer), length, NULL, 0,
-                info, info_size, info_type, flags);
-#ifdef SCTP_DEBUG
-        DEBUG_PRINTF("usrsctp_sendv(socket=%p, buffer=%p, length=%zu/%zu, info={sid: %"PRIu16", "
-                     "ppid: %"PRIu32", eor: %s (was %s}) -> %zd (errno: %m)\n",
-                     transport->socket, mbuf_buf(buffer), length, left, send_info->snd_sid,
-                     ntohl(send_info->snd_ppid),
-                     send_info->snd_flags & SCTP_EOR ? "true" : "false",
-                     eor_set ? "true" : "false",
-                     written, errno);
-#endif
-        if (written < 0) {
-            error = rawrtc_error_to_code(errno);
-            goto out;
-        }
+/*
+ * Set the maximum size of an inbound message the SCTP transport will
+ * buffer until it is complete.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_max_inbound_message_size(
+        struct rawrtc_sctp_transport* const transport,
+        uint64_t const max_message_size
+) {
+    // Check arguments
+    if (!transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-        // TODO: Remove
-        if (written == 0) {
-            DEBUG_NOTICE("@tuexen: usrsctp_sendv returned 0\n");
-            error = RAWRTC_CODE_TRY_AGAIN_LATER;
-            goto out;
-        }
+    // Set maximum message size & done
+    transport->max_inbound_message_size = max_message_size;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-        // If not all bytes have been written, this obviously means that usrsctp's buffer is full
-        // and we need to try again later.
-        if (written < length) {
-            // TODO: Comment in and remove section above
-//            error = RAWRTC_CODE_TRY_AGAIN_LATER;
-//            goto out;
-        }
+/*
+ * Get the amount of inbound messages that have been aborted by the
+ * SCTP transport for exceeding the maximum inbound message size.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_inbound_messages_too_large(
+        uint64_t* const countp, // de-referenced
+        struct rawrtc_sctp_transport* const transport
+) {
+    // Check arguments
+    if (!countp || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
 
-        // Update buffer position
-        mbuf_advance(buffer, written);
-    } while (mbuf_get_left(buffer) > 0);
+    // Set count & done
+    *countp = transport->n_inbound_messages_too_large;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-    // Done
-    error = RAWRTC_CODE_SUCCESS;
+/*
+ * Set the maximum amount of streams (and therefore data channels) of
+ * the SCTP transport.
+ */
+enum rawrtc_code rawrtc_sctp_transport_set_max_streams(
+        struct rawrtc_sctp_transport* const transport,
+        uint16_t const max_streams
+) {
+    uint_fast16_t i;
 
-out:
-    // Reset EOR flag
-    if (eor_set) {
-        send_info->snd_flags |= SCTP_EOR;
+    // Check arguments
+    if (!transport || max_streams == 0) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    return error;
+    // Check state
+    if (transport->state != RAWRTC_SCTP_TRANSPORT_STATE_NEW) {
+        return RAWRTC_CODE_INVALID_STATE;
+    }
+
+    // Ensure we're not excluding existing data channels
+    for (i = max_streams; i < transport->n_channels; ++i) {
+        if (transport->channels[i]) {
+            return RAWRTC_CODE_STILL_IN_USE;
+        }
+    }
+
+    // Set maximum & update amount of streams to be requested
+    transport->max_streams = max_streams;
+    return set_init_streams(transport);
 }
 
 /*
- * Send a message via the SCTP transport.
+ * Set the stream scheduler of the SCTP transport.
  */
-enum rawrtc_code rawrtc_sctp_transport_send(
+enum rawrtc_code rawrtc_sctp_transport_set_scheduler(
         struct rawrtc_sctp_transport* const transport,
-        struct mbuf* const buffer,
-        void* const info,
-        socklen_t const info_size,
-        unsigned int const info_type,
-        int const flags
+        enum rawrtc_sctp_transport_scheduler const scheduler
 ) {
-    struct send_context* context;
+    enum rawrtc_sctp_transport_scheduler previous_scheduler;
     enum rawrtc_code error;
 
     // Check arguments
-    if (!transport || !buffer) {
+    if (!transport) {
         return RAWRTC_CODE_INVALID_ARGUMENT;
     }
 
-    // Clear buffered amount low flag
-    transport->flags &= ~RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW;
-
-    // Send directly (if connected and no outstanding messages)
-    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CONNECTED &&
-            list_isempty(&transport->buffered_messages_outgoing)) {
-        // Try sending
-        DEBUG_PRINTF("Message queue is empty, sending directly\n");
-        error = sctp_transport_send(
-                transport, buffer, info, info_size, info_type, flags);
-        switch (error) {
-            case RAWRTC_CODE_SUCCESS:
-                // Done
-                return RAWRTC_CODE_SUCCESS;
-            case RAWRTC_CODE_TRY_AGAIN_LATER:
-                DEBUG_PRINTF("Need to buffer message and wait for a write request\n");
-                break;
-            case RAWRTC_CODE_MESSAGE_TOO_LONG:
-                DEBUG_WARNING("Incorrect message size guess, report this!\n");
-                return error;
-            default:
-                return error;
-        }
+    // Check state
+    if (transport->state == RAWRTC_SCTP_TRANSPORT_STATE_CLOSED) {
+        return RAWRTC_CODE_INVALID_STATE;
     }
 
-    // Create message context (for buffering)
-    error = message_send_context_create(&context, info, info_type, flags);
+    // Set & apply scheduler
+    previous_scheduler = transport->scheduler;
+    transport->scheduler = scheduler;
+    error = set_scheduler(transport);
     if (error) {
-        goto out;
+        transport->scheduler = previous_scheduler;
+        return error;
     }
 
-    // Buffer message
-    error = rawrtc_message_buffer_append(&transport->buffered_messages_outgoing, buffer, context);
-    if (error) {
-        goto out;
+    // Re-apply priorities (stream values are reset when switching schedulers)
+    apply_stream_priorities(transport);
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Get the currently negotiated amount of incoming and outgoing streams
+ * of the SCTP transport.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_streams(
+        uint16_t* const n_inboundp, // de-referenced
+        uint16_t* const n_outboundp, // de-referenced
+        struct rawrtc_sctp_transport* const transport
+) {
+    // Check arguments
+    if (!n_inboundp || !n_outboundp || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
     }
-    DEBUG_PRINTF("Buffered outgoing message of size %zu\n", mbuf_get_left(buffer));
 
-out:
-    // Un-reference
-    mem_deref(context);
+    // Set amounts & done
+    *n_inboundp = transport->n_inbound_streams;
+    *n_outboundp = transport->n_outbound_streams;
+    return RAWRTC_CODE_SUCCESS;
+}
 
-    return error;
+/*
+ * Get whether message interleaving (I-DATA) has been negotiated.
+ */
+enum rawrtc_code rawrtc_sctp_transport_get_interleaving(
+        bool* const activep, // de-referenced
+        struct rawrtc_sctp_transport* const transport
+) {
+    // Check arguments
+    if (!activep || !transport) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Set value & done
+    *activep = (transport->flags & RAWRTC_SCTP_TRANSPORT_FLAGS_INTERLEAVING) != 0;
+    return RAWRTC_CODE_SUCCESS;
 }
 
 /*
@@ -7,11 +7,15 @@
 #define RAWRTC_SCTP_EVENT_ALL (SCTP_EVENT_READ | SCTP_EVENT_WRITE | SCTP_EVENT_ERROR)
 
 enum {
-    RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT = 10,
+    RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_ACTIVE = 10,
+    RAWRTC_SCTP_TRANSPORT_TIMER_TIMEOUT_IDLE = 250,
+    RAWRTC_SCTP_TRANSPORT_TIMER_IDLE_DELAY = 500,
     RAWRTC_SCTP_TRANSPORT_DEFAULT_PORT = 5000,
     RAWRTC_SCTP_TRANSPORT_DEFAULT_NUMBER_OF_STREAMS = 65535,
+    RAWRTC_SCTP_TRANSPORT_INITIAL_NUMBER_OF_CHANNELS = 16,
     RAWRTC_SCTP_TRANSPORT_SID_MAX = 65534,
-    RAWRTC_SCTP_TRANSPORT_EMPTY_MESSAGE_SIZE = 1
+    RAWRTC_SCTP_TRANSPORT_EMPTY_MESSAGE_SIZE = 1,
+    RAWRTC_SCTP_TRANSPORT_DEFAULT_EVENT_BUDGET = 64
 };
 
 /*
@@ -19,7 +23,12 @@ enum {
  */
 enum {
     RAWRTC_SCTP_TRANSPORT_FLAGS_SENDING_IN_PROGRESS = 1 << 0,
-    RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW = 1 << 1
+    RAWRTC_SCTP_TRANSPORT_FLAGS_BUFFERED_AMOUNT_LOW = 1 << 1,
+    RAWRTC_SCTP_TRANSPORT_FLAGS_CORKED = 1 << 2,
+    RAWRTC_SCTP_TRANSPORT_FLAGS_BUNDLING = 1 << 3,
+    RAWRTC_SCTP_TRANSPORT_FLAGS_ADDING_STREAMS = 1 << 4,
+    RAWRTC_SCTP_TRANSPORT_FLAGS_DISCARD_DCEP_INBOUND = 1 << 5,
+    RAWRTC_SCTP_TRANSPORT_FLAGS_INTERLEAVING = 1 << 6,
 };
 
 /*
@@ -29,7 +38,9 @@ enum {
     RAWRTC_SCTP_DATA_CHANNEL_FLAGS_CAN_SEND_UNORDERED = 1 << 0,
     RAWRTC_SCTP_DATA_CHANNEL_FLAGS_PENDING_STREAM_RESET = 1 << 1,
     RAWRTC_SCTP_DATA_CHANNEL_FLAGS_INCOMING_STREAM_RESET = 1 << 2,
-    RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTGOING_STREAM_RESET = 1 << 3
+    RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTGOING_STREAM_RESET = 1 << 3,
+    RAWRTC_SCTP_DATA_CHANNEL_FLAGS_OUTBOUND_INCOMPLETE = 1 << 4,
+    RAWRTC_SCTP_DATA_CHANNEL_FLAGS_DISCARD_INBOUND = 1 << 5
 };
 
 /*
@@ -46,17 +57,15 @@ enum {
 enum {
     RAWRTC_DCEP_MESSAGE_ACK_BASE_SIZE = 1,
     RAWRTC_DCEP_MESSAGE_OPEN_BASE_SIZE = 12,
+    RAWRTC_DCEP_MESSAGE_MAX_SIZE = RAWRTC_DCEP_MESSAGE_OPEN_BASE_SIZE + 2 * UINT16_MAX,
 };
 
 /*
- * DCEP message priorities.
+ * usrsctp misspells the fair bandwidth stream scheduler.
  */
-enum {
-    RAWRTC_DCEP_CHANNEL_PRIORITY_LOW = 128,
-    RAWRTC_DCEP_CHANNEL_PRIORITY_NORMAL = 256,
-    RAWRTC_DCEP_CHANNEL_PRIORITY_HIGH = 512,
-    RAWRTC_DCEP_CHANNEL_PRIORITY_EXTRA_HIGH = 1024
-};
+#ifndef SCTP_SS_FAIR_BANDWIDTH
+#define SCTP_SS_FAIR_BANDWIDTH SCTP_SS_FAIR_BANDWITH
+#endif
 
 /*
  * DCEP payload protocol identifiers.
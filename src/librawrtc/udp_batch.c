@@ -0,0 +1,464 @@
+#define _GNU_SOURCE // recvmmsg, sendmmsg
+#include <errno.h> // errno
+#include <unistd.h> // dup, close
+#include <sys/socket.h> // recvmmsg, sendmmsg, mmsghdr
+#include <rawrtc.h>
+#include "udp_batch.h"
+#include "buffer_pool.h"
+
+#define DEBUG_MODULE "udp-batch"
+//#define RAWRTC_DEBUG_MODULE_LEVEL 7 // Note: Uncomment this to debug this module only
+#include "debug.h"
+
+/*
+ * Stop waiting for the socket to become writable (if waiting).
+ */
+static void batch_stop_waiting(
+        struct rawrtc_udp_batch* const batch // not checked
+) {
+    if (batch->write_fd != -1) {
+        fd_close(batch->write_fd);
+        (void) close(batch->write_fd);
+        batch->write_fd = -1;
+    }
+}
+
+/*
+ * Un-reference the first `n` queued datagrams of a batch and move the
+ * remaining datagrams to the front.
+ */
+static void batch_release(
+        struct rawrtc_udp_batch* const batch, // not checked
+        size_t const n
+) {
+    size_t i;
+
+    // Un-reference
+    for (i = 0; i < n; ++i) {
+        mem_deref(batch->buffers[i]);
+    }
+
+    // Move remaining datagrams
+    for (i = n; i < batch->n_buffers; ++i) {
+        batch->buffers[i - n] = batch->buffers[i];
+    }
+    for (i = batch->n_buffers - n; i < batch->n_buffers; ++i) {
+        batch->buffers[i] = NULL;
+    }
+    batch->n_buffers -= n;
+
+    // Un-reference socket (if empty)
+    if (batch->n_buffers == 0) {
+        batch->socket = mem_deref(batch->socket);
+    }
+}
+
+/*
+ * Discard all queued datagrams of a batch.
+ */
+static void batch_discard(
+        struct rawrtc_udp_batch* const batch // not checked
+) {
+    tmr_cancel(&batch->timer);
+    batch_stop_waiting(batch);
+    batch_release(batch, batch->n_buffers);
+}
+
+/*
+ * Flush the batch once the socket is writable again.
+ */
+static void batch_write_handler(
+        int flags,
+        void* arg
+) {
+    struct rawrtc_udp_batch* const batch = arg;
+    (void) flags;
+
+    // Stop waiting & flush
+    batch_stop_waiting(batch);
+    rawrtc_udp_batch_flush(batch);
+}
+
+/*
+ * Wait for the socket to become writable.
+ * Note: libre only allows a single handler per file descriptor (which
+ *       is used by the UDP socket), so a duplicate is being watched.
+ */
+static enum rawrtc_code batch_wait_writable(
+        struct rawrtc_udp_batch* const batch, // not checked
+        int const fd
+) {
+    int err;
+
+    // Duplicate file descriptor
+    batch->write_fd = dup(fd);
+    if (batch->write_fd == -1) {
+        return rawrtc_error_to_code(errno);
+    }
+
+    // Listen for write readiness
+    err = fd_listen(batch->write_fd, FD_WRITE, batch_write_handler, batch);
+    if (err) {
+        (void) close(batch->write_fd);
+        batch->write_fd = -1;
+        return rawrtc_error_to_code(err);
+    }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Send all queued datagrams of a batch with a single system call (if
+ * possible). In case the socket's send buffer is full, the remaining
+ * datagrams will be sent once the socket is writable again.
+ */
+void rawrtc_udp_batch_flush(
+        struct rawrtc_udp_batch* const batch
+) {
+    struct mmsghdr messages[RAWRTC_UDP_BATCH_SIZE] = {{{0}}};
+    struct iovec vectors[RAWRTC_UDP_BATCH_SIZE];
+    size_t i;
+    size_t n_sent = 0;
+    int fd;
+    enum rawrtc_code error;
+
+    // Check arguments
+    if (!batch) {
+        return;
+    }
+
+    // Nothing to send or waiting until writable?
+    if (batch->n_buffers == 0 || batch->write_fd != -1) {
+        return;
+    }
+
+    // Cancel timer
+    tmr_cancel(&batch->timer);
+
+    // Get file descriptor
+    fd = udp_sock_fd(batch->socket, sa_af(&batch->destination));
+    if (fd == -1) {
+        DEBUG_WARNING("Unable to send batch, no socket\n");
+        batch_release(batch, batch->n_buffers);
+        return;
+    }
+
+    // Prepare messages
+    for (i = 0; i < batch->n_buffers; ++i) {
+        vectors[i].iov_base = mbuf_buf(batch->buffers[i]);
+        vectors[i].iov_len = mbuf_get_left(batch->buffers[i]);
+        messages[i].msg_hdr.msg_name = &batch->destination.u.sa;
+        messages[i].msg_hdr.msg_namelen = batch->destination.len;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Send
+    while (n_sent < batch->n_buffers) {
+        int const n = sendmmsg(
+                fd, &messages[n_sent], (unsigned int) (batch->n_buffers - n_sent), MSG_DONTWAIT);
+        if (n >= 0) {
+            n_sent += (size_t) n;
+            continue;
+        }
+
+        switch (errno) {
+            case EINTR:
+                continue;
+            case EAGAIN:
+#if (EAGAIN != EWOULDBLOCK)
+            case EWOULDBLOCK:
+#endif
+            case ENOBUFS:
+                // Send buffer is full: Keep remaining datagrams until writable
+                DEBUG_PRINTF("Socket not writable, keeping %zu datagrams\n",
+                             batch->n_buffers - n_sent);
+                error = batch_wait_writable(batch, fd);
+                if (error) {
+                    DEBUG_WARNING("Cannot wait until writable, dropping %zu datagrams, "
+                                  "reason: %s\n", batch->n_buffers - n_sent,
+                                  rawrtc_code_to_str(error));
+                    n_sent = batch->n_buffers;
+                }
+                goto out;
+            default:
+                // Drop the datagram that could not be sent and continue
+                DEBUG_WARNING("Could not send datagram, reason: %m\n", errno);
+                ++n_sent;
+                break;
+        }
+    }
+    DEBUG_PRINTF("Sent %zu datagrams in one batch\n", n_sent);
+
+out:
+    // Un-reference sent datagrams
+    batch_release(batch, n_sent);
+}
+
+/*
+ * Flush the batch at the end of the current event loop iteration.
+ */
+static void batch_timer_handler(
+        void* arg
+) {
+    rawrtc_udp_batch_flush(arg);
+}
+
+/*
+ * Destructor for an existing batch.
+ */
+static void rawrtc_udp_batch_destroy(
+        void* arg
+) {
+    struct rawrtc_udp_batch* const batch = arg;
+
+    // Flush pending datagrams (if writable) & discard the remaining datagrams
+    rawrtc_udp_batch_flush(batch);
+    batch_discard(batch);
+}
+
+/*
+ * Create an outgoing datagram batch.
+ */
+enum rawrtc_code rawrtc_udp_batch_create(
+        struct rawrtc_udp_batch** const batchp // de-referenced
+) {
+    struct rawrtc_udp_batch* batch;
+
+    // Check arguments
+    if (!batchp) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Allocate
+    batch = mem_zalloc(sizeof(*batch), rawrtc_udp_batch_destroy);
+    if (!batch) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Set fields
+    tmr_init(&batch->timer);
+    batch->write_fd = -1;
+
+    // Set pointer & done
+    *batchp = batch;
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Queue a datagram for sending. Queued datagrams will be sent once the
+ * batch is full, the socket or destination changes or at the end of
+ * the current event loop iteration.
+ *
+ * The datagram is referenced and MUST NOT be modified afterwards.
+ *
+ * Return `RAWRTC_CODE_TRY_AGAIN_LATER` in case the datagram has been
+ * dropped because the batch is full and the socket is not writable.
+ */
+enum rawrtc_code rawrtc_udp_batch_send(
+        struct rawrtc_udp_batch* const batch,
+        struct udp_sock* const socket, // referenced
+        struct sa const* const destination, // copied
+        struct mbuf* const buffer // referenced
+) {
+    // Check arguments
+    if (!batch || !socket || !destination || !buffer) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Flush (if socket or destination differs)
+    // Note: Datagrams still waiting for the previous socket to become writable are stale.
+    if (batch->n_buffers > 0 &&
+            (batch->socket != socket || !sa_cmp(&batch->destination, destination, SA_ALL))) {
+        if (batch->write_fd != -1) {
+            batch_discard(batch);
+        } else {
+            rawrtc_udp_batch_flush(batch);
+        }
+    }
+
+    // Drop (if full and waiting until writable)
+    if (batch->n_buffers == RAWRTC_UDP_BATCH_SIZE) {
+        DEBUG_NOTICE("Socket not writable and batch full, dropping datagram\n");
+        return RAWRTC_CODE_TRY_AGAIN_LATER;
+    }
+
+    // Queue datagram
+    if (batch->n_buffers == 0) {
+        batch->socket = mem_ref(socket);
+        sa_cpy(&batch->destination, destination);
+    }
+    batch->buffers[batch->n_buffers++] = mem_ref(buffer);
+
+    // Flush (if full) or at the end of the current event loop iteration
+    if (batch->n_buffers == RAWRTC_UDP_BATCH_SIZE) {
+        rawrtc_udp_batch_flush(batch);
+    } else if (batch->write_fd == -1 && !tmr_isrunning(&batch->timer)) {
+        tmr_start(&batch->timer, 0, batch_timer_handler, batch);
+    }
+
+    // Done
+    return RAWRTC_CODE_SUCCESS;
+}
+
+/*
+ * Handle a received datagram and drain further pending datagrams of
+ * the socket with a single system call. Datagrams will be injected
+ * into the socket's helper chain following this helper.
+ * Note: This helper needs to be the first one of the socket.
+ */
+static bool receive_handler(
+        struct sa* source,
+        struct mbuf* buffer,
+        void* arg
+) {
+    struct rawrtc_udp_batch_receiver* const receiver = arg;
+    struct mmsghdr messages[RAWRTC_UDP_BATCH_SIZE] = {{{0}}};
+    struct iovec vectors[RAWRTC_UDP_BATCH_SIZE];
+    struct sockaddr_storage addresses[RAWRTC_UDP_BATCH_SIZE];
+    struct sa address;
+    int fd;
+    int n;
+    int i;
+    enum rawrtc_code error;
+
+    // Already draining? Pass on.
+    if (receiver->draining) {
+        return false;
+    }
+    receiver->draining = true;
+
+    // Keep receiver and socket alive (handlers may close the socket)
+    mem_ref(receiver);
+    mem_ref(receiver->socket);
+
+    // Handle current datagram
+    udp_recv_helper(receiver->socket, source, buffer, receiver->udp_helper);
+
+    // Get file descriptor
+    fd = udp_sock_fd(receiver->socket, sa_af(source));
+    if (fd == -1) {
+        goto out;
+    }
+
+    // Prepare messages (taking buffers from the pool, if needed)
+    for (i = 0; i < RAWRTC_UDP_BATCH_SIZE; ++i) {
+        if (!receiver->buffers[i]) {
+            error = rawrtc_buffer_pool_get(
+                    &receiver->buffers[i], rawrtc_buffer_pool_global(),
+                    RAWRTC_UDP_BATCH_RECEIVE_SIZE);
+            if (error) {
+                goto out;
+            }
+        }
+        vectors[i].iov_base = receiver->buffers[i]->buf;
+        vectors[i].iov_len = receiver->buffers[i]->size;
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Drain pending datagrams
+    n = recvmmsg(fd, messages, RAWRTC_UDP_BATCH_SIZE, MSG_DONTWAIT, NULL);
+    if (n <= 0) {
+        goto out;
+    }
+    DEBUG_PRINTF("Drained %d datagrams in one batch\n", n);
+
+    // Handle datagrams
+    for (i = 0; i < n; ++i) {
+        struct mbuf* const received = receiver->buffers[i];
+
+        // Discard truncated datagrams
+        if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            DEBUG_NOTICE("Discarding truncated datagram\n");
+            continue;
+        }
+
+        // Set source & length
+        if (sa_set_sa(&address, (struct sockaddr*) &addresses[i])) {
+            continue;
+        }
+        received->pos = 0;
+        received->end = messages[i].msg_len;
+
+        // Inject
+        udp_recv_helper(receiver->socket, &address, received, receiver->udp_helper);
+
+        // Replace buffer (if a handler kept a reference to it)
+        if (mem_nrefs(received) > 1) {
+            receiver->buffers[i] = mem_deref(received);
+        }
+    }
+
+out:
+    // Un-reference
+    mem_deref(receiver->socket);
+    receiver->draining = false;
+    mem_deref(receiver);
+    return true;
+}
+
+/*
+ * Destructor for an existing batched receiver.
+ */
+static void rawrtc_udp_batch_receiver_destroy(
+        void* arg
+) {
+    struct rawrtc_udp_batch_receiver* const receiver = arg;
+    size_t i;
+
+    // Return buffers to the pool
+    for (i = 0; i < RAWRTC_UDP_BATCH_SIZE; ++i) {
+        rawrtc_buffer_pool_put(rawrtc_buffer_pool_global(), receiver->buffers[i]);
+    }
+
+    // Un-reference
+    mem_deref(receiver->udp_helper);
+    mem_deref(receiver->socket);
+}
+
+/*
+ * Create a batched receiver for a UDP socket.
+ */
+enum rawrtc_code rawrtc_udp_batch_receiver_create(
+        struct rawrtc_udp_batch_receiver** const receiverp, // de-referenced
+        struct udp_sock* const socket // referenced
+) {
+    struct rawrtc_udp_batch_receiver* receiver;
+    enum rawrtc_code error;
+
+    // Check arguments
+    if (!receiverp || !socket) {
+        return RAWRTC_CODE_INVALID_ARGUMENT;
+    }
+
+    // Allocate
+    receiver = mem_zalloc(sizeof(*receiver), rawrtc_udp_batch_receiver_destroy);
+    if (!receiver) {
+        return RAWRTC_CODE_NO_MEMORY;
+    }
+
+    // Set fields/reference
+    receiver->socket = mem_ref(socket);
+    receiver->draining = false;
+
+    // Register UDP helper (in front of all other helpers)
+    error = rawrtc_error_to_code(udp_register_helper(
+            &receiver->udp_helper, socket, RAWRTC_LAYER_BATCHED_IO, NULL, receive_handler,
+            receiver));
+    if (error) {
+        goto out;
+    }
+
+out:
+    if (error) {
+        mem_deref(receiver);
+    } else {
+        // Set pointer
+        *receiverp = receiver;
+    }
+    return error;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <rawrtc.h>
+
+enum {
+    RAWRTC_UDP_BATCH_SIZE = 16,
+    RAWRTC_UDP_BATCH_RECEIVE_SIZE = 8192,
+};
+
+/*
+ * Outgoing datagram batch.
+ */
+struct rawrtc_udp_batch {
+    struct tmr timer;
+    struct udp_sock* socket; // referenced, nullable
+    struct sa destination;
+    struct mbuf* buffers[RAWRTC_UDP_BATCH_SIZE]; // referenced
+    size_t n_buffers;
+    int write_fd; // duplicate of the socket's descriptor, -1 if not waiting until writable
+};
+
+/*
+ * Batched receiver of a UDP socket.
+ */
+struct rawrtc_udp_batch_receiver {
+    struct udp_sock* socket; // referenced
+    struct udp_helper* udp_helper; // referenced
+    struct mbuf* buffers[RAWRTC_UDP_BATCH_SIZE]; // nullable, taken from the pool on demand
+    bool draining;
+};
+
+enum rawrtc_code rawrtc_udp_batch_create(
+    struct rawrtc_udp_batch** const batchp // de-referenced
+);
+
+enum rawrtc_code rawrtc_udp_batch_send(
+    struct rawrtc_udp_batch* const batch,
+    struct udp_sock* const socket, // referenced
+    struct sa const* const destination, // copied
+    struct mbuf* const buffer // referenced
+);
+
+void rawrtc_udp_batch_flush(
+    struct rawrtc_udp_batch* const batch
+);
+
+enum rawrtc_code rawrtc_udp_batch_receiver_create(
+    struct rawrtc_udp_batch_receiver** const receiverp, // de-referenced
+    struct udp_sock* const socket // referenced
+);
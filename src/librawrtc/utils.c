@@ -50,7 +50,8 @@ struct rawrtc_certificate_options rawrtc_default_certificate_options = {
  * Default data channel options.
  */
 struct rawrtc_data_channel_options rawrtc_default_data_channel_options = {
-    .deliver_partially = false
+    .deliver_partially = false,
+    .max_message_size = 0
 };
 
 /*
@@ -0,0 +1,122 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // malloc, free, rand, EXIT_*
+#include <time.h> // clock_gettime
+#include "crc32c.h"
+
+/*
+ * Benchmark parameters.
+ */
+enum {
+    BENCHMARK_SIZE_MIN = 64,
+    BENCHMARK_SIZE_MAX = 65536,
+    BENCHMARK_BYTES_PER_SIZE = 64 * 1024 * 1024,
+};
+
+/*
+ * Benchmarked CRC-32C implementation variant.
+ */
+struct variant {
+    enum crc32c_variant variant;
+    char const* name;
+};
+
+static struct variant const variants[] = {
+    {CRC32C_VARIANT_SOFTWARE, "software"},
+    {CRC32C_VARIANT_SSE42, "sse4.2"},
+    {CRC32C_VARIANT_PCLMUL, "pclmul"},
+    {CRC32C_VARIANT_ARMV8, "armv8"},
+};
+
+/*
+ * Prevents the benchmark loops from being optimised away.
+ */
+static volatile uint32_t sink;
+
+/*
+ * Get the current monotonic time in nanoseconds.
+ */
+static uint64_t get_time(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+}
+
+/*
+ * Compare all supported CRC-32C implementation variants across buffer
+ * sizes from 64 bytes to 64 KiB and print the throughput in MiB/s.
+ * Results are verified against the software implementation.
+ */
+int main(void) {
+    crc32c_function* const reference = crc32c_get_variant(CRC32C_VARIANT_SOFTWARE);
+    unsigned char* buffer;
+    size_t size;
+    size_t i;
+    int result = EXIT_SUCCESS;
+
+    // Allocate & fill buffer (with an offset to test unaligned access)
+    buffer = malloc(BENCHMARK_SIZE_MAX + 1);
+    if (!buffer) {
+        fprintf(stderr, "Could not allocate buffer\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < BENCHMARK_SIZE_MAX + 1; ++i) {
+        buffer[i] = (unsigned char) rand();
+    }
+
+    // Print header
+    printf("%8s", "size");
+    for (i = 0; i < sizeof(variants) / sizeof(variants[0]); ++i) {
+        if (crc32c_get_variant(variants[i].variant)) {
+            printf(" %10s", variants[i].name);
+        }
+    }
+    printf(" %10s\n", "selected");
+
+    // Benchmark each size
+    for (size = BENCHMARK_SIZE_MIN; size <= BENCHMARK_SIZE_MAX; size *= 2) {
+        uint32_t const expected = reference(0, buffer + 1, size);
+        size_t const runs = BENCHMARK_BYTES_PER_SIZE / size;
+
+        printf("%8zu", size);
+        for (i = 0; i <= sizeof(variants) / sizeof(variants[0]); ++i) {
+            crc32c_function* function;
+            uint32_t crc = 0;
+            uint64_t start;
+            uint64_t elapsed;
+            size_t run;
+
+            // Get variant (or the runtime selected implementation)
+            if (i < sizeof(variants) / sizeof(variants[0])) {
+                function = crc32c_get_variant(variants[i].variant);
+                if (!function) {
+                    continue;
+                }
+            } else {
+                function = crc32c;
+            }
+
+            // Verify
+            if (function(0, buffer + 1, size) != expected) {
+                printf(" %10s", "MISMATCH");
+                result = EXIT_FAILURE;
+                continue;
+            }
+
+            // Measure
+            start = get_time();
+            for (run = 0; run < runs; ++run) {
+                crc = function(crc, buffer + 1, size);
+            }
+            elapsed = get_time() - start;
+            sink = crc;
+
+            // Print throughput
+            printf(" %10.1f", (double) (runs * size) / (1024 * 1024) / ((double) elapsed / 1e9));
+        }
+        printf("\n");
+    }
+
+    // Done
+    free(buffer);
+    return result;
+}